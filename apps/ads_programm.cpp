@@ -26,11 +26,9 @@ int main(int argc, char* argv[]) {
   const auto [raw_bitvector, queries] = read_input(input_file);
   const std::size_t length = raw_bitvector.size();
 
-  std::size_t num_ones = 0;
   TwoLayerRankCombinedBitVector bitvector(length);
   for (std::size_t pos = 0; pos < length; ++pos) {
     const bool is_set = raw_bitvector[pos] == '1';
-    num_ones += is_set ? 1 : 0;
     bitvector.set(pos, is_set);
   }
 
@@ -40,11 +38,12 @@ int main(int argc, char* argv[]) {
   std::size_t memory_space = bitvector.memory_space();
   const std::size_t milliseconds = time_function([&] {
     // Initialize the rank data structure, which is integrated into the bit
-    // vector.
+    // vector. This also counts the number of ones in the bit vector.
     bitvector.update();
 
-    // Initialize the select data structure.
-    TwoLayerSelect select(bitvector, num_ones);
+    // Initialize the select data structure, which only requires the rank
+    // information of the bit vector and not another pass over the bits.
+    TwoLayerSelect select(bitvector);
     memory_space += select.memory_space();
 
     // Answer the queries using the initialized data structures.
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <bitsy/k2_tree.hpp>
+#include <bitsy/util/parallel.hpp>
+
+#include "apps/util/timer.hpp"
+
+namespace {
+
+using Edge = bitsy::K2Tree<>::Edge;
+
+/**
+ * Parses the edges of a graph from a text file, in which each line consists of
+ * the source and target of an edge. Lines that start with '#' or '%' are
+ * treated as comments.
+ *
+ * @param filename The name of the file to be parsed.
+ * @return The edges of the graph.
+ */
+std::vector<Edge> read_edges(const std::string& filename) {
+  std::ifstream in(filename);
+  if (!in) {
+    throw std::runtime_error("Cannot open file " + filename + ".");
+  }
+
+  std::vector<Edge> edges;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#' || line[0] == '%') {
+      continue;
+    }
+
+    std::istringstream line_stream(line);
+    Edge edge;
+    if (line_stream >> edge.first >> edge.second) {
+      edges.push_back(edge);
+    }
+  }
+
+  return edges;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  using namespace bitsy;
+
+  if (argc < 2 || argc > 4) {
+    std::cout << "Usage: " << argv[0]
+              << " <graph_file> [num_threads] [num_queries]" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  const std::string graph_file = argv[1];
+  const std::size_t num_threads = (argc > 2) ? std::stoull(argv[2])
+                                             : parallel::default_num_threads();
+  const std::size_t num_queries = (argc > 3) ? std::stoull(argv[3]) : 100000;
+
+  const std::vector<Edge> edges = read_edges(graph_file);
+  std::uint64_t num_nodes = 0;
+  for (const auto& [source, target] : edges) {
+    num_nodes = std::max(num_nodes, std::max(source, target) + 1);
+  }
+
+  using namespace std::chrono;
+  const auto construction_start = system_clock::now();
+  const K2Tree<> tree(num_nodes, std::span<const Edge>(edges), num_threads);
+  const std::size_t construction_time =
+      duration_cast<milliseconds>(system_clock::now() - construction_start)
+          .count();
+
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<std::uint64_t> dist(
+      0, num_nodes > 0 ? num_nodes - 1 : 0);
+  std::vector<std::uint64_t> queries(num_nodes > 0 ? num_queries : 0);
+  for (std::uint64_t& query : queries) {
+    query = dist(gen);
+  }
+
+  std::size_t num_neighbors = 0;
+  const std::size_t neighbors_time = time_function([&] {
+    for (const std::uint64_t query : queries) {
+      num_neighbors += tree.neighbors(query).size();
+    }
+  });
+
+  std::size_t num_reverse_neighbors = 0;
+  const std::size_t reverse_neighbors_time = time_function([&] {
+    for (const std::uint64_t query : queries) {
+      num_reverse_neighbors += tree.reverse_neighbors(query).size();
+    }
+  });
+
+  std::cout << "RESULT nodes=" << num_nodes << " edges=" << tree.num_edges()
+            << " space=" << tree.memory_space()
+            << " construction_time=" << construction_time
+            << " neighbors_time=" << neighbors_time
+            << " neighbors=" << num_neighbors
+            << " reverse_neighbors_time=" << reverse_neighbors_time
+            << " reverse_neighbors=" << num_reverse_neighbors << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <bitsy/quotient_filter.hpp>
+
+#include "apps/util/timer.hpp"
+
+namespace {
+
+/**
+ * A blocked Bloom filter, which sets the bits of a key within a single block of
+ * 512 bits, such that an operation touches a single cache line.
+ *
+ * The block is selected by one hash of the key and the bits within the block by
+ * a second, independently mixed hash, whereby each bit is determined by nine
+ * bits of the second hash. Thus, seven bits are set per key, which consume 63
+ * of its 64 bits.
+ */
+class BlockedBloomFilter {
+  using Word = std::uint64_t;
+
+  static constexpr std::size_t kNumWordsPerBlock = 8;
+  static constexpr std::size_t kNumHashes = 7;
+
+ public:
+  explicit BlockedBloomFilter(const std::size_t num_bits)
+      : _num_blocks(std::max<std::size_t>(1, num_bits / 512)),
+        _data(_num_blocks * kNumWordsPerBlock, 0) {}
+
+  void insert(const std::uint64_t key) {
+    const std::uint64_t block_hash = hash(key);
+    Word* block = _data.data() + block_hash % _num_blocks * kNumWordsPerBlock;
+
+    std::uint64_t bit_hash = hash(block_hash);
+    for (std::size_t i = 0; i < kNumHashes; ++i) {
+      const std::size_t bit = bit_hash & 511;
+      block[bit / 64] |= static_cast<Word>(1) << (bit % 64);
+      bit_hash >>= 9;
+    }
+  }
+
+  [[nodiscard]] bool contains(const std::uint64_t key) const {
+    const std::uint64_t block_hash = hash(key);
+    const Word* block =
+        _data.data() + block_hash % _num_blocks * kNumWordsPerBlock;
+
+    std::uint64_t bit_hash = hash(block_hash);
+    for (std::size_t i = 0; i < kNumHashes; ++i) {
+      const std::size_t bit = bit_hash & 511;
+      if (((block[bit / 64] >> (bit % 64)) & 1) == 0) {
+        return false;
+      }
+      bit_hash >>= 9;
+    }
+
+    return true;
+  }
+
+  [[nodiscard]] std::size_t memory_space() const {
+    return _data.size() * 64;
+  }
+
+ private:
+  [[nodiscard]] static std::uint64_t hash(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCD;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53;
+    x ^= x >> 33;
+    return x;
+  }
+
+  std::size_t _num_blocks;
+  std::vector<Word> _data;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  using namespace bitsy;
+
+  if (argc != 2 && argc != 3) {
+    std::cout << "Usage: " << argv[0] << " <num_keys> [num_queries]"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  const std::size_t num_keys = std::stoull(argv[1]);
+  const std::size_t num_queries = (argc > 2) ? std::stoull(argv[2]) : num_keys;
+
+  std::mt19937_64 gen(1);
+  std::vector<std::uint64_t> keys(num_keys);
+  for (std::uint64_t& key : keys) {
+    key = gen();
+  }
+
+  std::vector<std::uint64_t> queries(num_queries);
+  for (std::uint64_t& query : queries) {
+    query = gen();
+  }
+
+  // Choose the number of slots such that the filter is not resized.
+  const std::size_t min_num_slots =
+      static_cast<std::size_t>(num_keys / QuotientFilter<>::kMaxLoadFactor);
+  const std::size_t quotient_width =
+      std::max<std::size_t>(6, std::bit_width(min_num_slots));
+
+  QuotientFilter<> filter(quotient_width);
+  const std::size_t filter_insert_time = time_function(
+      [&] { filter.insert(std::span<const std::uint64_t>(keys)); });
+
+  const auto contained = std::make_unique<bool[]>(num_queries);
+  const std::size_t filter_query_time = time_function([&] {
+    filter.contains(std::span<const std::uint64_t>(queries), contained.get());
+  });
+
+  std::size_t filter_false_positives = 0;
+  for (std::size_t i = 0; i < num_queries; ++i) {
+    filter_false_positives += contained[i] ? 1 : 0;
+  }
+
+  // The Bloom filter uses the same space as the quotient filter.
+  BlockedBloomFilter bloom_filter(filter.memory_space());
+  const std::size_t bloom_insert_time = time_function([&] {
+    for (const std::uint64_t key : keys) {
+      bloom_filter.insert(key);
+    }
+  });
+
+  std::size_t bloom_false_positives = 0;
+  const std::size_t bloom_query_time = time_function([&] {
+    for (const std::uint64_t query : queries) {
+      bloom_false_positives += bloom_filter.contains(query) ? 1 : 0;
+    }
+  });
+
+  std::cout << "RESULT filter=quotient keys=" << num_keys
+            << " space=" << filter.memory_space()
+            << " insert_time=" << filter_insert_time
+            << " query_time=" << filter_query_time
+            << " false_positives=" << filter_false_positives << std::endl;
+  std::cout << "RESULT filter=blocked_bloom keys=" << num_keys
+            << " space=" << bloom_filter.memory_space()
+            << " insert_time=" << bloom_insert_time
+            << " query_time=" << bloom_query_time
+            << " false_positives=" << bloom_false_positives << std::endl;
+
+  return EXIT_SUCCESS;
+}
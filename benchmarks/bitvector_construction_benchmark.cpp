@@ -0,0 +1,91 @@
+#include <nanobench.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+
+#include <bitsy/rank/two_layer_rank_combined_bitvector.hpp>
+#include <bitsy/select/two_layer_select.hpp>
+
+namespace {
+
+template <typename BitVector>
+BitVector create_random_bitvector(const std::size_t length,
+                                  const std::size_t seed = 1) {
+  BitVector bitvector(length);
+
+  std::mt19937 rng(seed);
+  std::bernoulli_distribution dist(0.5);
+  for (std::size_t pos = 0; pos < length; ++pos) {
+    bitvector.set(pos, dist(rng));
+  }
+
+  return bitvector;
+}
+
+void bench_bitsy_two_layer(ankerl::nanobench::Bench& bench,
+                           const std::size_t length,
+                           const std::size_t num_threads) {
+  using BitVector = bitsy::TwoLayerRankCombinedBitVector<>;
+
+  auto bitvector = create_random_bitvector<BitVector>(length);
+  bitvector.update();
+  bitsy::TwoLayerSelect select(bitvector);
+
+  const std::string name =
+      "bitsy-two-layer (" + std::to_string(num_threads) + " threads)";
+  bench.run(name, [&] {
+    bitvector.update(num_threads);
+    select.update(num_threads);
+  });
+}
+
+void bench_bitsy_two_layer_first_touch(ankerl::nanobench::Bench& bench,
+                                       const std::size_t length,
+                                       const std::size_t num_threads) {
+  using BitVector = bitsy::TwoLayerRankCombinedBitVector<>;
+
+  // Measure the allocation and the first pass over the bits, which has to wait
+  // for the page faults unless the memory has been pre-faulted beforehand.
+  const std::string name =
+      num_threads == 0
+          ? "bitsy-two-layer (no prefault)"
+          : "bitsy-two-layer (prefault, " + std::to_string(num_threads) +
+                " threads)";
+  bench.run(name, [&] {
+    BitVector bitvector(length);
+
+    if (num_threads > 0) {
+      bitvector.prefault(num_threads);
+    }
+
+    bitvector.update(std::max<std::size_t>(1, num_threads));
+    ankerl::nanobench::doNotOptimizeAway(bitvector.num_ones());
+  });
+}
+
+}  // namespace
+
+int main() {
+  ankerl::nanobench::Bench b;
+  b.title("Bitvector Construction")
+      .unit("build")
+      .relative(true)
+      .minEpochIterations(10);
+
+  constexpr std::size_t length = 1LL << 32;
+  for (const std::size_t num_threads : {1, 2, 4, 8, 16}) {
+    bench_bitsy_two_layer(b, length, num_threads);
+  }
+
+  ankerl::nanobench::Bench first_touch;
+  first_touch.title("Bitvector Allocation and First Pass")
+      .unit("build")
+      .relative(true)
+      .minEpochIterations(5);
+
+  for (const std::size_t num_threads : {0, 1, 2, 4, 8, 16}) {
+    bench_bitsy_two_layer_first_touch(first_touch, length, num_threads);
+  }
+}
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include <bitsy/bitvector.hpp>
+#include <bitsy/rank/mutable_two_layer_rank_combined_bitvector.hpp>
 #include <bitsy/rank/naive_rank.hpp>
 #include <bitsy/rank/two_layer_rank_combined_bitvector.hpp>
 
@@ -95,6 +96,35 @@ void bench_bitsy_two_layer_combined2048(
   });
 }
 
+void bench_bitsy_mutable_two_layer_combined(
+    ankerl::nanobench::Bench& bench,
+    const std::size_t length,
+    const std::vector<std::size_t>& queries) {
+  const bitsy::MutableTwoLayerRankCombinedBitVector bitvector(length, true);
+
+  bench.run("bitsy-mutable-two-layer-rank-combined-512", [&] {
+    for (const std::size_t query : queries) {
+      ankerl::nanobench::doNotOptimizeAway(bitvector.rank1(query));
+    }
+  });
+}
+
+void bench_bitsy_mutable_two_layer_combined_update(
+    ankerl::nanobench::Bench& bench,
+    const std::size_t length,
+    const std::vector<std::size_t>& queries) {
+  bitsy::MutableTwoLayerRankCombinedBitVector bitvector(length, true);
+
+  bool value = false;
+  bench.run("bitsy-mutable-two-layer-rank-combined-512 (point update)", [&] {
+    for (const std::size_t query : queries) {
+      bitvector.set(query, value);
+    }
+
+    value = !value;
+  });
+}
+
 }  // namespace
 
 int main() {
@@ -122,4 +152,10 @@ int main() {
 
   fetch_queries(queries);
   bench_bitsy_two_layer_combined2048(b, length, queries);
+
+  fetch_queries(queries);
+  bench_bitsy_mutable_two_layer_combined(b, length, queries);
+
+  fetch_queries(queries);
+  bench_bitsy_mutable_two_layer_combined_update(b, length, queries);
 }
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include <bitsy/bitvector.hpp>
+#include <bitsy/rank/mutable_two_layer_rank_combined_bitvector.hpp>
 #include <bitsy/rank/two_layer_rank_combined_bitvector.hpp>
 #include <bitsy/select/naive_select.hpp>
 #include <bitsy/select/two_layer_select.hpp>
@@ -139,6 +140,18 @@ void bench_bitsy_two_layer_binary_search_131072(
   });
 }
 
+void bench_bitsy_mutable_two_layer(ankerl::nanobench::Bench& bench,
+                                   const std::size_t length,
+                                   const std::vector<std::size_t>& queries) {
+  const bitsy::MutableTwoLayerRankCombinedBitVector bitvector(length, true);
+
+  bench.run("bitsy-mutable-two-layer", [&] {
+    for (const std::size_t query : queries) {
+      ankerl::nanobench::doNotOptimizeAway(bitvector.select1(query));
+    }
+  });
+}
+
 }  // namespace
 
 int main() {
@@ -172,4 +185,7 @@ int main() {
 
   fetch_queries(queries);
   bench_bitsy_two_layer_binary_search_131072(b, length, queries);
+
+  fetch_queries(queries);
+  bench_bitsy_mutable_two_layer(b, length, queries);
 }
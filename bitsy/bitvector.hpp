@@ -4,8 +4,10 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <utility>
 
 #include "bitsy/util/math.hpp"
 #include "bitsy/util/static_vector.hpp"
@@ -51,6 +53,19 @@ class BitVector {
     std::fill_n(_data.data(), _num_words, default_word);
   }
 
+  /**
+   * Constructs a bit vector from its bits, which have been computed beforehand,
+   * e.g., when exporting the bits of another bit vector.
+   *
+   * @param length The number of bits that this bit vector contains.
+   * @param data The words at which the bits are stored.
+   */
+  explicit BitVector(const std::size_t length, StaticVector<Word>&& data)
+      : _length(length),
+        _num_words(math::div_ceil(length, kWordWidth)),
+        _data(std::move(data)) {
+  }
+
   // Create the default destructor.
   ~BitVector() = default;
 
@@ -96,6 +111,61 @@ class BitVector {
     _data[num_word] = (_data[num_word] & ~mask) | (-value & mask);
   }
 
+  /**
+   * Atomically sets a bit within this bit vector to zero, such that it can be
+   * called concurrently with other atomic writes to this bit vector.
+   *
+   * @param pos The position of the bit that is to be set to zero.
+   */
+  inline void atomic_unset(const std::size_t pos) {
+    const Word mask = static_cast<Word>(1) << (pos % kWordWidth);
+    std::atomic_ref<Word>(_data[pos / kWordWidth])
+        .fetch_and(~mask, std::memory_order_relaxed);
+  }
+
+  /**
+   * Atomically sets a bit within this bit vector to one, such that it can be
+   * called concurrently with other atomic writes to this bit vector.
+   *
+   * @param pos The position of the bit that is to be set to one.
+   */
+  inline void atomic_set(const std::size_t pos) {
+    const Word mask = static_cast<Word>(1) << (pos % kWordWidth);
+    std::atomic_ref<Word>(_data[pos / kWordWidth])
+        .fetch_or(mask, std::memory_order_relaxed);
+  }
+
+  /**
+   * Atomically sets a bit within this bit vector to one and returns whether it
+   * has been set before, such that it can be called concurrently with other
+   * atomic writes to this bit vector.
+   *
+   * @param pos The position of the bit that is to be set to one.
+   * @return Whether the bit has been set before.
+   */
+  inline bool atomic_test_and_set(const std::size_t pos) {
+    const Word mask = static_cast<Word>(1) << (pos % kWordWidth);
+    const Word word = std::atomic_ref<Word>(_data[pos / kWordWidth])
+                          .fetch_or(mask, std::memory_order_relaxed);
+    return (word & mask) != 0;
+  }
+
+  /**
+   * Atomically sets a bit within this bit vector depending on a boolean value,
+   * such that it can be called concurrently with other atomic writes to this
+   * bit vector.
+   *
+   * @param pos The position of the bit that is to be set to one.
+   * @param value Whether to set the bit.
+   */
+  inline void atomic_set(const std::size_t pos, const bool value) {
+    if (value) {
+      atomic_set(pos);
+    } else {
+      atomic_unset(pos);
+    }
+  }
+
   /**
    * Returns whether a bit within this bit vector is set.
    *
@@ -107,6 +177,16 @@ class BitVector {
     return ((word >> (pos % kWordWidth)) & static_cast<Word>(1)) == 1;
   }
 
+  /**
+   * Pre-faults the memory of this bit vector in parallel, such that the first
+   * pass over the bits does not have to wait for page faults.
+   *
+   * @param num_threads The number of threads to use.
+   */
+  void prefault(const std::size_t num_threads = 1) {
+    _data.prefault(num_threads);
+  }
+
   /**
    * Returns the number of bits that this bit vector contains.
    *
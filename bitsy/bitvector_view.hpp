@@ -0,0 +1,94 @@
+/// A read-only view of bits that are stored in memory owned by the caller.
+/// @file bitvector_view.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bitsy/bitvector.hpp"
+
+namespace bitsy {
+
+/**
+ * A read-only bit vector that does not own the words at which its bits are
+ * stored, such that bits that are already in memory (e.g., produced by another
+ * component) can be queried without copying them.
+ *
+ * The bits are laid out in the same way as for the bit vector, i.e., the first
+ * logical bit within a word is stored at the least significant position. The
+ * bits of the last word past the length are ignored and thus may be arbitrary.
+ * The caller has to keep the words alive for the lifetime of the view.
+ */
+class BitVectorView {
+ public:
+  //! The type of integer that is used to store the bits.
+  using Word = std::uint64_t;
+
+  //! The number of bits in a word.
+  static constexpr std::size_t kWordWidth = sizeof(Word) * 8;
+
+  /**
+   * Constructs a view of bits that are stored in memory owned by the caller.
+   *
+   * @param data A pointer to the words at which the bits are stored.
+   * @param length The number of bits.
+   */
+  explicit BitVectorView(const Word* const data, const std::size_t length)
+      : _length(length), _data(data) {
+  }
+
+  /**
+   * Constructs a view of the bits of a bit vector.
+   *
+   * @param bitvector The bit vector to view.
+   */
+  explicit BitVectorView(const BitVector& bitvector)
+      : BitVectorView(bitvector.data(), bitvector.length()) {
+  }
+
+  /**
+   * Returns whether a bit is set.
+   *
+   * @param pos The position of the bit that is to be queried.
+   * @param value Whether the bit is set.
+   */
+  [[nodiscard]] inline bool is_set(const std::size_t pos) const {
+    const Word word = _data[pos / kWordWidth];
+    return ((word >> (pos % kWordWidth)) & static_cast<Word>(1)) == 1;
+  }
+
+  /**
+   * Returns the number of bits that this view contains.
+   *
+   * @return The number of bits that this view contains.
+   */
+  [[nodiscard]] inline std::size_t length() const {
+    return _length;
+  }
+
+  /**
+   * Returns a pointer to the memory at which the bits are stored.
+   *
+   * @return A pointer to the memory at which the bits are stored.
+   */
+  [[nodiscard]] inline const Word* data() const {
+    return _data;
+  }
+
+  /**
+   * Returns the used memory space of this view in bits, which is zero as the
+   * memory at which the bits are stored is owned by the caller.
+   *
+   * @return The used memory space of this view in bits.
+   */
+  [[nodiscard]] inline std::size_t memory_space() const {
+    return 0;
+  }
+
+ private:
+  std::size_t _length;
+  const Word* _data;
+};
+
+};  // namespace bitsy
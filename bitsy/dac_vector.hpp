@@ -0,0 +1,243 @@
+/// A vector of variable-length integers that are stored as directly addressable
+/// codes.
+/// @file dac_vector.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "bitsy/int_vector.hpp"
+#include "bitsy/rank/two_layer_rank_combined_bitvector.hpp"
+#include "bitsy/util/math.hpp"
+
+namespace bitsy {
+
+/**
+ * A vector of variable-length integers that are stored as directly addressable
+ * codes (DACs), see Brisaboa et al. "DACs: Bringing direct access to
+ * variable-length codes".
+ *
+ * Each integer is split into chunks of \a ChunkWidth bits, whereby the lowest
+ * chunk of every integer is stored on the first level, the second lowest chunk
+ * of every integer that has more than one chunk on the second level, and so on.
+ * For each level, a bit vector with rank support stores whether the integers
+ * continue on the next level. Thus, the position of an integer on the next
+ * level is the rank of its position on the current level, such that random
+ * access takes one rank query per additional chunk. For skewed integers, most
+ * of them fit into the first levels, which saves most of the space of 64-bit
+ * integers.
+ *
+ * @tparam ChunkWidth The width in bits of each chunk.
+ */
+template <std::size_t ChunkWidth = 8>
+class DacVector {
+  static_assert(ChunkWidth > 0 && ChunkWidth < 64,
+                "Chunk width has to be between one and 63 bits.");
+
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordWidth = sizeof(Word) * 8;
+
+  using BitVector = TwoLayerRankCombinedBitVector<>;
+
+ public:
+  //! The type of integer that is stored.
+  using Int = std::uint64_t;
+
+  //! The width in bits of each chunk.
+  static constexpr std::size_t kChunkWidth = ChunkWidth;
+  //! The maximum number of levels.
+  static constexpr std::size_t kMaxNumLevels =
+      math::div_ceil(kWordWidth, kChunkWidth);
+
+  /**
+   * Constructs a vector that stores integers as directly addressable codes.
+   *
+   * @param values The integers to store.
+   */
+  explicit DacVector(const std::span<const Int> values)
+      : _length(values.size()) {
+    Int max_value = 0;
+    for (const Int value : values) {
+      max_value |= value;
+    }
+
+    const std::size_t num_levels = std::max<std::size_t>(
+        1, math::div_ceil(std::bit_width(max_value), kChunkWidth));
+    _levels.reserve(num_levels);
+
+    // Each level stores the chunks of the integers that have more chunks than
+    // the previous levels, in the order of the integers.
+    std::size_t level_length = values.size();
+    for (std::size_t num_level = 0; num_level < num_levels; ++num_level) {
+      const std::size_t shift = num_level * kChunkWidth;
+      const bool is_last_level = num_level + 1 == num_levels;
+
+      IntVector<kChunkWidth> chunks(level_length);
+      BitVector continues(is_last_level ? 0 : level_length);
+
+      std::size_t pos = 0;
+      std::size_t next_level_length = 0;
+      for (const Int value : values) {
+        if (num_level > 0 && (value >> shift) == 0) {
+          continue;
+        }
+
+        chunks.set(pos, value >> shift);
+        if (!is_last_level) {
+          const bool continues_next = (value >> shift >> kChunkWidth) != 0;
+          continues.set(pos, continues_next);
+          next_level_length += continues_next ? 1 : 0;
+        }
+
+        pos += 1;
+      }
+      continues.update();
+
+      _levels.push_back({std::move(chunks), std::move(continues)});
+      level_length = next_level_length;
+    }
+  }
+
+  // Create the default destructor.
+  ~DacVector() = default;
+
+  // Create the default move constructor/move assignment operator.
+  DacVector(DacVector&&) noexcept = default;
+  DacVector& operator=(DacVector&&) noexcept = default;
+
+  // Delete the copy constructor/copy assignment operator as we do not intend
+  // to copy the vector.
+  DacVector(DacVector const&) = delete;
+  DacVector& operator=(DacVector const&) = delete;
+
+  /**
+   * Returns an integer within this vector.
+   *
+   * @param pos The position of the integer that is to be returned.
+   * @return The integer.
+   */
+  [[nodiscard]] inline Int access(std::size_t pos) const {
+    Int value = _levels[0].chunks.get(pos);
+
+    for (std::size_t num_level = 1; num_level < _levels.size(); ++num_level) {
+      const BitVector& continues = _levels[num_level - 1].continues;
+      if (!continues.is_set(pos)) {
+        break;
+      }
+
+      pos = continues.rank1(pos);
+      value |= _levels[num_level].chunks.get(pos)
+               << (num_level * kChunkWidth);
+    }
+
+    return value;
+  }
+
+  /**
+   * Decodes consecutive integers into an array.
+   *
+   * Instead of a rank query per chunk, the positions on all levels are computed
+   * once for the first integer and then advanced while scanning the integers.
+   *
+   * @param first The position of the first integer to decode.
+   * @param count The number of integers to decode.
+   * @param out A pointer to the array, which has to hold at least count
+   * integers.
+   */
+  void decode(const std::size_t first,
+              const std::size_t count,
+              Int* const out) const {
+    if (count == 0) {
+      return;
+    }
+
+    // Compute the position of the first integer on each level that belongs
+    // to an integer at or after the first position. If a level is exhausted,
+    // no integer of the range reaches the following levels.
+    std::array<std::size_t, kMaxNumLevels> positions{};
+    positions[0] = first;
+    for (std::size_t num_level = 1; num_level < _levels.size(); ++num_level) {
+      const Level& prev_level = _levels[num_level - 1];
+      if (positions[num_level - 1] >= prev_level.chunks.length()) {
+        break;
+      }
+
+      positions[num_level] =
+          prev_level.continues.rank1(positions[num_level - 1]);
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+      const std::size_t pos = positions[0]++;
+      Int value = _levels[0].chunks.get(pos);
+
+      bool continues = _levels.size() > 1 && _levels[0].continues.is_set(pos);
+      for (std::size_t num_level = 1; continues; ++num_level) {
+        const std::size_t level_pos = positions[num_level]++;
+        value |= _levels[num_level].chunks.get(level_pos)
+                 << (num_level * kChunkWidth);
+
+        continues = num_level + 1 < _levels.size() &&
+                    _levels[num_level].continues.is_set(level_pos);
+      }
+
+      out[i] = value;
+    }
+  }
+
+  /**
+   * Returns the number of integers that this vector contains.
+   *
+   * @return The number of integers that this vector contains.
+   */
+  [[nodiscard]] inline std::size_t length() const {
+    return _length;
+  }
+
+  /**
+   * Returns the number of levels.
+   *
+   * @return The number of levels.
+   */
+  [[nodiscard]] inline std::size_t num_levels() const {
+    return _levels.size();
+  }
+
+  /**
+   * Returns the used memory space of this data structure in bits.
+   *
+   * Note that it only accounts for the memory that is stored on the heap, i.e.,
+   * the memory that depends on the number of integers.
+   *
+   * @return The used memory space of this data structure in bits.
+   */
+  [[nodiscard]] inline std::size_t memory_space() const {
+    std::size_t memory_space = 0;
+    for (const Level& level : _levels) {
+      memory_space += level.chunks.memory_space();
+      memory_space += level.continues.memory_space();
+    }
+
+    return memory_space;
+  }
+
+ private:
+  struct Level {
+    //! The chunks of the integers that reach this level.
+    IntVector<kChunkWidth> chunks;
+    //! Whether the integers continue on the next level, which is empty for the
+    //! last level.
+    BitVector continues;
+  };
+
+  std::size_t _length;
+  std::vector<Level> _levels;
+};
+
+}  // namespace bitsy
@@ -0,0 +1,478 @@
+/// An append-only bit vector with rank and select support that grows without
+/// copying its bits.
+/// @file growable_bitvector.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "bitsy/select/word_select.hpp"
+#include "bitsy/util/math.hpp"
+#include "bitsy/util/static_vector.hpp"
+
+namespace bitsy {
+
+/**
+ * An append-only bit vector with rank and select support that grows without
+ * copying its bits.
+ *
+ * The bits and block headers use the same interleaved layout as the two-layer
+ * rank-combined bit vector. However, instead of a single allocation, the blocks
+ * are stored in segments of fixed size, which are allocated (with huge pages if
+ * enabled) as the bit vector grows. Thus, appending never has to reallocate and
+ * copy the bits. By default, a segment consists of 1024 superblocks, which is
+ * exactly one huge page of 2 MiB for a block width of 512.
+ *
+ * The rank information is maintained while appending: the header of a block is
+ * written as soon as the first bit is appended to it, the rank of a superblock
+ * is stored as soon as its first block is started, and every \a Stride-th one
+ * and zero is sampled for select queries like the two-layer select data
+ * structure does. As the block that contains the next bit is always started,
+ * rank, select and access queries can be answered at any time for the bits
+ * appended so far, and all of this information is maintained in amortized
+ * constant time per appended bit.
+ *
+ * @tparam BlockWidth The size of each block in bits.
+ * @tparam BlockHeaderWidth The size of the block header in bits.
+ * @tparam Stride The stride with which ones and zeros are sampled.
+ * @tparam NumSuperblocksPerSegment The number of superblocks per segment.
+ */
+template <std::size_t BlockWidth = 512,
+          std::size_t BlockHeaderWidth = 14,
+          std::size_t Stride = 32768,
+          std::size_t NumSuperblocksPerSegment = 1024>
+class GrowableBitVector {
+  static_assert(BlockWidth % 2 == 0, "Block width has to be a power of two.");
+  static_assert(BlockWidth > 64, "Block width has to greater than 64 bits.");
+  static_assert(BlockHeaderWidth <= 64,
+                "Block header has to be a at most 64 bits wide.");
+  static_assert(math::pow2(BlockHeaderWidth) > BlockWidth,
+                "Superblock width has to be greater than the block width.");
+  static_assert(Stride > 64, "Stride has to be greater than 64.");
+
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordWidth = sizeof(Word) * 8;
+
+ public:
+  //! The width in bits of a block.
+  static constexpr std::size_t kBlockWidth = BlockWidth;
+  //! The width in bits of the header that is stored in the first word of a
+  //! block.
+  static constexpr std::size_t kBlockHeaderWidth = BlockHeaderWidth;
+  //! The width in bits of the data that is stored in a block.
+  static constexpr std::size_t kBlockDataWidth =
+      kBlockWidth - kBlockHeaderWidth;
+  //! The number of words per block.
+  static constexpr std::size_t kNumWordsPerBlock = kBlockWidth / kWordWidth;
+
+  //! The width in bits of a superblock.
+  static constexpr std::size_t kSuperblockWidth = math::pow2(BlockHeaderWidth);
+  //! The number of blocks per superblock.
+  static constexpr std::size_t kNumBlocksPerSuperblock =
+      kSuperblockWidth / kBlockWidth;
+  //! The width in bits of the data that is stored in a superblock.
+  static constexpr std::size_t kSuperblockDataWidth =
+      kSuperblockWidth - kNumBlocksPerSuperblock * kBlockHeaderWidth;
+
+  //! The number of blocks per segment.
+  static constexpr std::size_t kNumBlocksPerSegment =
+      NumSuperblocksPerSegment * kNumBlocksPerSuperblock;
+  //! The number of words per segment.
+  static constexpr std::size_t kNumWordsPerSegment =
+      kNumBlocksPerSegment * kNumWordsPerBlock;
+
+  //! The stride with which ones and zeros are sampled.
+  static constexpr std::size_t kStride = Stride;
+
+  /**
+   * Constructs an empty bit vector.
+   */
+  GrowableBitVector()
+      : _length(0),
+        _num_ones(0),
+        _num_blocks(0),
+        _cur_superblock_ones(0),
+        // The first occurence is always located in the first superblock.
+        _zero_samples{0},
+        _one_samples{0} {
+    start_block();
+  }
+
+  // Create the default destructor.
+  ~GrowableBitVector() = default;
+
+  // Create the default move constructor/move assignment operator.
+  GrowableBitVector(GrowableBitVector&&) noexcept = default;
+  GrowableBitVector& operator=(GrowableBitVector&&) noexcept = default;
+
+  // Delete the copy constructor/copy assignment operator as we do not intend
+  // to copy the bit vector.
+  GrowableBitVector(GrowableBitVector const&) = delete;
+  GrowableBitVector& operator=(GrowableBitVector const&) = delete;
+
+  /**
+   * Appends a bit to the end of this bit vector.
+   *
+   * @param value Whether the bit is set.
+   */
+  inline void push_back(const bool value) {
+    append_word(static_cast<Word>(value), 1);
+  }
+
+  /**
+   * Appends the least significant bits of a word to the end of this bit vector,
+   * whereby the least significant bit is appended first.
+   *
+   * @param word The word whose bits are to be appended.
+   * @param num_bits The number of bits to append, which has to be at most 64.
+   */
+  void append_word(Word word, std::size_t num_bits) {
+    if (num_bits < kWordWidth) {
+      word &= math::setbits<Word>(num_bits);
+    }
+
+    while (num_bits > 0) {
+      // Append as many bits as fit into the current block, which are spread
+      // over at most two words.
+      const std::size_t block_pos = _length % kBlockDataWidth;
+      const std::size_t num_appended =
+          std::min(num_bits, kBlockDataWidth - block_pos);
+      const Word bits = (num_appended < kWordWidth)
+                            ? (word & math::setbits<Word>(num_appended))
+                            : word;
+
+      Word* const data = block_data(_num_blocks - 1);
+      const std::size_t data_pos = block_pos + kBlockHeaderWidth;
+      const std::size_t num_word = data_pos / kWordWidth;
+      const std::size_t word_pos = data_pos % kWordWidth;
+
+      data[num_word] |= bits << word_pos;
+      if (word_pos + num_appended > kWordWidth) {
+        data[num_word + 1] |= bits >> (kWordWidth - word_pos);
+      }
+
+      const std::size_t num_ones = std::popcount(bits);
+      sample(_one_samples, _num_ones, num_ones);
+      sample(_zero_samples, _length - _num_ones, num_appended - num_ones);
+
+      _length += num_appended;
+      _num_ones += num_ones;
+      _cur_superblock_ones += num_ones;
+
+      // Start the next block as soon as the current one is full, so that the
+      // block containing the next bit always has a valid header.
+      if (_length % kBlockDataWidth == 0) {
+        start_block();
+      }
+
+      word = (num_appended < kWordWidth) ? (word >> num_appended) : 0;
+      num_bits -= num_appended;
+    }
+  }
+
+  /**
+   * Returns whether a bit within this bit vector is set.
+   *
+   * @param pos The position of the bit that is to be queried.
+   * @param value Whether the bit is set.
+   */
+  [[nodiscard]] inline bool is_set(const std::size_t pos) const {
+    const std::size_t block_pos = pos % kBlockDataWidth + kBlockHeaderWidth;
+    const Word word =
+        block_data(pos / kBlockDataWidth)[block_pos / kWordWidth];
+    return ((word >> (block_pos % kWordWidth)) & static_cast<Word>(1)) == 1;
+  }
+
+  /**
+   * Returns the number of bits equal to zero up to a position.
+   *
+   * @param pos The position up to which bits are to be taken into account,
+   * which has to be at most the length.
+   * @return The number of bits equal to zero up to the position.
+   */
+  [[nodiscard]] inline Word rank0(const std::size_t pos) const {
+    return static_cast<Word>(pos) - rank1(pos);
+  }
+
+  /**
+   * Returns the number of bits equal to one up to a position.
+   *
+   * @param pos The position up to which bits are to be taken into account,
+   * which has to be at most the length.
+   * @return The number of bits equal to zero up to the position.
+   */
+  [[nodiscard]] inline Word rank1(const std::size_t pos) const {
+    const std::size_t block_pos = pos % kBlockDataWidth + kBlockHeaderWidth;
+    const std::size_t num_word = block_pos / kWordWidth;
+    const std::size_t word_pos = block_pos % kWordWidth;
+
+    // Fetch the rank of the superblock and the rank of the block within the
+    // superblock, which is stored in the header of the block.
+    Word rank = _superblock_ranks[pos / kSuperblockDataWidth];
+
+    const Word* const data = block_data(pos / kBlockDataWidth);
+    const Word first_word = *data;
+    rank += first_word & math::setbits<Word>(kBlockHeaderWidth);
+
+    // Count the number of ones within the block up to the bit like the
+    // two-layer rank-combined bit vector does.
+    if (num_word == 0) [[unlikely]] {
+      const std::size_t shift = (kWordWidth + kBlockHeaderWidth) - word_pos;
+      rank += std::popcount((first_word >> kBlockHeaderWidth) << shift) *
+              (word_pos != kBlockHeaderWidth);
+    } else {
+      rank += std::popcount(first_word >> kBlockHeaderWidth);
+
+      std::size_t i = 1;
+      while (i < num_word) {
+        rank += std::popcount(data[i++]);
+      }
+
+      const std::size_t shift = kWordWidth - word_pos;
+      rank += std::popcount(data[i] << shift) * (word_pos != 0);
+    }
+
+    return rank;
+  }
+
+  /**
+   * Returns the position of the rank-th occurence of zero.
+   *
+   * @param rank The rank of the first zero whose position is to be returned.
+   * @return The position of the first zero with given rank.
+   */
+  [[nodiscard]] inline Word select0(std::size_t rank) const {
+    const auto superblock_rank = [&](const std::size_t num_superblock) {
+      return num_superblock * kSuperblockDataWidth -
+             _superblock_ranks[num_superblock];
+    };
+    const auto block_rank = [](const std::size_t num_block,
+                               const Word* const data) {
+      return (num_block % kNumBlocksPerSuperblock) * kBlockDataWidth -
+             (*data & math::setbits<Word>(kBlockHeaderWidth));
+    };
+
+    const auto [num_block, data] =
+        find_block(_zero_samples, rank, superblock_rank, block_rank);
+
+    // Find the word within the block using a linear search.
+    Word num_word = 0;
+    Word word = *data | math::setbits<Word>(kBlockHeaderWidth);
+    Word word_rank;
+    while ((word_rank = std::popcount(~word)) < rank) {
+      num_word += 1;
+      word = data[num_word];
+      rank -= word_rank;
+    }
+
+    return num_block * kBlockDataWidth + num_word * kWordWidth +
+           word_select1(~word, rank) - kBlockHeaderWidth;
+  }
+
+  /**
+   * Returns the position of the rank-th occurence of one.
+   *
+   * @param rank The rank of the first one whose position is to be returned.
+   * @return The position of the first one with given rank.
+   */
+  [[nodiscard]] inline Word select1(std::size_t rank) const {
+    const auto superblock_rank = [&](const std::size_t num_superblock) {
+      return _superblock_ranks[num_superblock];
+    };
+    const auto block_rank = [](std::size_t, const Word* const data) {
+      return *data & math::setbits<Word>(kBlockHeaderWidth);
+    };
+
+    const auto [num_block, data] =
+        find_block(_one_samples, rank, superblock_rank, block_rank);
+
+    // Find the word within the block using a linear search.
+    Word num_word = 0;
+    Word word = *data & ~math::setbits<Word>(kBlockHeaderWidth);
+    Word word_rank;
+    while ((word_rank = std::popcount(word)) < rank) {
+      num_word += 1;
+      word = data[num_word];
+      rank -= word_rank;
+    }
+
+    return num_block * kBlockDataWidth + num_word * kWordWidth +
+           word_select1(word, rank) - kBlockHeaderWidth;
+  }
+
+  /**
+   * Returns the number of bits that have been appended.
+   *
+   * @return The number of bits that this bit vector contains.
+   */
+  [[nodiscard]] inline std::size_t length() const {
+    return _length;
+  }
+
+  /**
+   * Returns the number of bits set to one.
+   *
+   * @return The number of bits set to one.
+   */
+  [[nodiscard]] inline std::size_t num_ones() const {
+    return _num_ones;
+  }
+
+  /**
+   * Returns the number of segments that have been allocated.
+   *
+   * @return The number of segments.
+   */
+  [[nodiscard]] inline std::size_t num_segments() const {
+    return _segments.size();
+  }
+
+  /**
+   * Returns the used memory space of this data structure in bits.
+   *
+   * Note that it only accounts for the memory that is stored on the heap,
+   * i.e., the memory that depends on the length of the bit vector.
+   *
+   * @return The used memory space of this data structure in bits.
+   */
+  [[nodiscard]] inline std::size_t memory_space() const {
+    return _segments.size() * kNumWordsPerSegment * kWordWidth +
+           _superblock_ranks.size() * kWordWidth +
+           _zero_samples.size() * kWordWidth + _one_samples.size() * kWordWidth;
+  }
+
+ private:
+  [[nodiscard]] inline Word* block_data(const std::size_t num_block) {
+    return _segments[num_block / kNumBlocksPerSegment].data() +
+           (num_block % kNumBlocksPerSegment) * kNumWordsPerBlock;
+  }
+
+  [[nodiscard]] inline const Word* block_data(
+      const std::size_t num_block) const {
+    return _segments[num_block / kNumBlocksPerSegment].data() +
+           (num_block % kNumBlocksPerSegment) * kNumWordsPerBlock;
+  }
+
+  /**
+   * Starts the next block by writing its header and, if it is the first block
+   * of a superblock or segment, storing the superblock rank or allocating the
+   * segment.
+   */
+  void start_block() {
+    const std::size_t num_block = _num_blocks++;
+
+    if (num_block % kNumBlocksPerSegment == 0) {
+      // The bits are appended by or-ing them into the words, thus they have to
+      // be zero initially.
+      StaticVector<Word>& segment = _segments.emplace_back(kNumWordsPerSegment);
+      std::fill_n(segment.data(), segment.size(), 0);
+    }
+
+    if (num_block % kNumBlocksPerSuperblock == 0) {
+      _superblock_ranks.push_back(_num_ones);
+      _cur_superblock_ones = 0;
+    }
+
+    *block_data(num_block) = _cur_superblock_ones;
+  }
+
+  /**
+   * Samples the superblock of the current block for every occurence of a bit
+   * among the appended bits whose rank is a multiple of the stride.
+   *
+   * @param samples The samples for the kind of bit.
+   * @param rank The number of occurences of the bit before appending.
+   * @param num_appended The number of appended occurences of the bit.
+   */
+  void sample(std::vector<Word>& samples,
+              const std::size_t rank,
+              const std::size_t num_appended) {
+    const std::size_t cur_superblock = _superblock_ranks.size() - 1;
+
+    while (samples.size() * kStride <= rank + num_appended) {
+      samples.push_back(cur_superblock);
+    }
+  }
+
+  /**
+   * Finds the block that contains the occurence of a bit with a given rank
+   * using the samples, superblock ranks and block headers.
+   *
+   * @param samples The samples for the kind of bit.
+   * @param rank The rank of the occurence, which is reduced to the rank within
+   * the block.
+   * @param superblock_rank A function that returns the number of occurences up
+   * to the start of a superblock.
+   * @param block_rank A function that returns the number of occurences up to
+   * the start of a block within its superblock.
+   * @return The number of the block and a pointer to its data.
+   */
+  template <typename SuperblockRank, typename BlockRank>
+  [[nodiscard]] inline std::pair<std::size_t, const Word*> find_block(
+      const std::vector<Word>& samples,
+      std::size_t& rank,
+      SuperblockRank&& superblock_rank,
+      BlockRank&& block_rank) const {
+    // Step 1: Fetch the range of superblocks containing the occurence using the
+    // samples. If the next sample has not been taken yet, the occurence is
+    // located at most in the current superblock.
+    const std::size_t nearest_prev_sample = (rank - 1) / kStride;
+
+    std::size_t num_superblock = samples[nearest_prev_sample];
+    std::size_t num_last_superblock =
+        (nearest_prev_sample + 1 < samples.size())
+            ? samples[nearest_prev_sample + 1]
+            : _superblock_ranks.size() - 1;
+
+    // Step 2: Find the superblock using a binary search.
+    while (num_superblock < num_last_superblock) {
+      const std::size_t mid = (num_superblock + num_last_superblock + 1) / 2;
+
+      if (superblock_rank(mid) < rank) {
+        num_superblock = mid;
+      } else {
+        num_last_superblock = mid - 1;
+      }
+    }
+
+    rank -= superblock_rank(num_superblock);
+
+    // Step 3: Find the block within the superblock using a binary search over
+    // the blocks that have been started.
+    std::size_t num_block = num_superblock * kNumBlocksPerSuperblock;
+    std::size_t num_last_block =
+        std::min(_num_blocks, num_block + kNumBlocksPerSuperblock) - 1;
+    while (num_block < num_last_block) {
+      const std::size_t mid = (num_block + num_last_block + 1) / 2;
+
+      if (block_rank(mid, block_data(mid)) < rank) {
+        num_block = mid;
+      } else {
+        num_last_block = mid - 1;
+      }
+    }
+
+    const Word* const data = block_data(num_block);
+    rank -= block_rank(num_block, data);
+    return {num_block, data};
+  }
+
+  std::size_t _length;
+  std::size_t _num_ones;
+
+  std::size_t _num_blocks;
+  std::vector<StaticVector<Word>> _segments;
+
+  std::vector<Word> _superblock_ranks;
+  Word _cur_superblock_ones;
+
+  std::vector<Word> _zero_samples;
+  std::vector<Word> _one_samples;
+};
+
+}  // namespace bitsy
@@ -0,0 +1,398 @@
+/// A vector of fixed-width integers that are stored bit-packed.
+/// @file int_vector.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "bitsy/util/math.hpp"
+#include "bitsy/util/static_vector.hpp"
+
+#if defined(BITSY_USE_PDEP) && defined(__BMI2__)
+#define USE_PDEP
+#endif
+
+#ifdef USE_PDEP
+#include <immintrin.h>
+#endif
+
+namespace bitsy {
+
+/**
+ * A vector of fixed-width integers that are stored bit-packed, i.e., each
+ * integer occupies exactly \a Width bits and the integers are stored
+ * consecutively in 64-bit words, whereby the first integer within a word is
+ * stored at the least significant position.
+ *
+ * The width can either be fixed at compile-time, such that the compiler can
+ * specialize the shifts and masks, or be chosen at runtime by setting \a Width
+ * to zero. We store one padding word after the integers, such that an integer
+ * can be read from two consecutive words without a conditional jump.
+ *
+ * @tparam Width The width in bits of each integer, or zero if the width is
+ * chosen at runtime.
+ */
+template <std::size_t Width = 0>
+class IntVector {
+  static_assert(Width <= 64, "Width has to be at most 64 bits.");
+
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordWidth = sizeof(Word) * 8;
+
+ public:
+  //! The type of integer that is stored.
+  using Int = std::uint64_t;
+
+  //! The width in bits of each integer, or zero if it is chosen at runtime.
+  static constexpr std::size_t kWidth = Width;
+
+  /**
+   * An iterator over the integers of the vector.
+   */
+  class ConstIterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Int;
+    using difference_type = std::ptrdiff_t;
+
+    ConstIterator() : _vector(nullptr), _pos(0) {}
+
+    ConstIterator(const IntVector* const vector, const std::size_t pos)
+        : _vector(vector), _pos(pos) {}
+
+    [[nodiscard]] inline Int operator*() const {
+      return _vector->get(_pos);
+    }
+
+    inline ConstIterator& operator++() {
+      _pos += 1;
+      return *this;
+    }
+
+    inline ConstIterator operator++(int) {
+      ConstIterator prev = *this;
+      _pos += 1;
+      return prev;
+    }
+
+    [[nodiscard]] inline bool operator==(const ConstIterator& other) const {
+      return _pos == other._pos;
+    }
+
+   private:
+    const IntVector* _vector;
+    std::size_t _pos;
+  };
+
+  /**
+   * Constructs a vector whose integers are all set to zero.
+   *
+   * @param length The number of integers that this vector contains.
+   * @param width The width in bits of each integer, which has to be between one
+   * and 64 and equal to \a Width if it is fixed at compile-time.
+   */
+  explicit IntVector(const std::size_t length, const std::size_t width = Width)
+      : _length(length),
+        _width(width),
+        _data(math::div_ceil(length * width, kWordWidth) + 1) {
+    assert(width >= 1 && width <= kWordWidth);
+    assert(Width == 0 || width == Width);
+    std::fill_n(_data.data(), _data.size(), 0);
+  }
+
+  // Create the default destructor.
+  ~IntVector() = default;
+
+  // Create the default move constructor/move assignment operator.
+  IntVector(IntVector&&) noexcept = default;
+  IntVector& operator=(IntVector&&) noexcept = default;
+
+  // Delete the copy constructor/copy assignment operator as we do not intend
+  // to copy the vector.
+  IntVector(IntVector const&) = delete;
+  IntVector& operator=(IntVector const&) = delete;
+
+  /**
+   * Sets an integer within this vector.
+   *
+   * @param pos The position of the integer that is to be set.
+   * @param value The integer, whose bits beyond the width are ignored.
+   */
+  inline void set(const std::size_t pos, const Int value) {
+    write_bits(pos * width(), width(), value);
+  }
+
+  /**
+   * Returns an integer within this vector.
+   *
+   * @param pos The position of the integer that is to be returned.
+   * @return The integer.
+   */
+  [[nodiscard]] inline Int get(const std::size_t pos) const {
+    return read_bits(pos * width(), width());
+  }
+
+  /**
+   * Decodes consecutive integers into an array of 64-bit integers.
+   *
+   * If PDEP is available, eight integers of width at most eight or four
+   * integers of width at most 16 are decoded at once by depositing their bits
+   * into the bytes or 16-bit lanes of a word.
+   *
+   * @param first The position of the first integer to decode.
+   * @param count The number of integers to decode.
+   * @param out A pointer to the array, which has to hold at least count
+   * integers.
+   */
+  void decode(const std::size_t first,
+              const std::size_t count,
+              Int* const out) const {
+    std::size_t i = 0;
+
+#ifdef USE_PDEP
+    if (width() <= 8) {
+      i = decode_lanes<8>(first, count, out);
+    } else if (width() <= 16) {
+      i = decode_lanes<16>(first, count, out);
+    }
+#endif
+
+    for (; i < count; ++i) {
+      out[i] = get(first + i);
+    }
+  }
+
+  /**
+   * Encodes consecutive integers from an array of 64-bit integers.
+   *
+   * If PDEP is available, eight integers of width at most eight or four
+   * integers of width at most 16 are encoded at once by extracting their bits
+   * from the bytes or 16-bit lanes of a word.
+   *
+   * @param first The position of the first integer to encode.
+   * @param count The number of integers to encode.
+   * @param in A pointer to the array, which has to hold at least count
+   * integers.
+   */
+  void encode(const std::size_t first,
+              const std::size_t count,
+              const Int* const in) {
+    std::size_t i = 0;
+
+#ifdef USE_PDEP
+    if (width() <= 8) {
+      i = encode_lanes<8>(first, count, in);
+    } else if (width() <= 16) {
+      i = encode_lanes<16>(first, count, in);
+    }
+#endif
+
+    for (; i < count; ++i) {
+      set(first + i, in[i]);
+    }
+  }
+
+  /**
+   * Returns an iterator to the first integer.
+   *
+   * @return An iterator to the first integer.
+   */
+  [[nodiscard]] inline ConstIterator begin() const {
+    return ConstIterator(this, 0);
+  }
+
+  /**
+   * Returns an iterator past the last integer.
+   *
+   * @return An iterator past the last integer.
+   */
+  [[nodiscard]] inline ConstIterator end() const {
+    return ConstIterator(this, _length);
+  }
+
+  /**
+   * Returns the number of integers that this vector contains.
+   *
+   * @return The number of integers that this vector contains.
+   */
+  [[nodiscard]] inline std::size_t length() const {
+    return _length;
+  }
+
+  /**
+   * Returns the width in bits of each integer.
+   *
+   * @return The width in bits of each integer.
+   */
+  [[nodiscard]] inline std::size_t width() const {
+    if constexpr (Width != 0) {
+      return Width;
+    } else {
+      return _width;
+    }
+  }
+
+  /**
+   * Returns a pointer to the underlying memory at which the integers are
+   * stored.
+   *
+   * @return A pointer to the underlying memory at which the integers are
+   * stored.
+   */
+  [[nodiscard]] inline const Word* data() const {
+    return _data.data();
+  }
+
+  /**
+   * Returns the used memory space of this vector in bits.
+   *
+   * Note that it only accounts for the memory that is stored on the heap, i.e.,
+   * the memory that depends on the length of this vector.
+   *
+   * @return The used memory space of this vector in bits.
+   */
+  [[nodiscard]] inline std::size_t memory_space() const {
+    return _data.size() * kWordWidth;
+  }
+
+ private:
+#ifdef USE_PDEP
+  /**
+   * Decodes groups of integers, each of which fills the lanes of a word, using
+   * PDEP. The width has to be at most the lane width.
+   *
+   * @tparam LaneWidth The width in bits of a lane, which divides 64.
+   * @param first The position of the first integer to decode.
+   * @param count The number of integers to decode.
+   * @param out A pointer to the array, which has to hold at least count
+   * integers.
+   * @return The number of integers that have been decoded.
+   */
+  template <std::size_t LaneWidth>
+  std::size_t decode_lanes(const std::size_t first,
+                           const std::size_t count,
+                           Int* const out) const {
+    constexpr std::size_t kNumLanes = kWordWidth / LaneWidth;
+    constexpr Word kLaneMask = math::setbits<Word>(LaneWidth);
+
+    const std::size_t w = width();
+    const Word mask = lane_mask<LaneWidth>(w);
+
+    std::size_t i = 0;
+    for (; i + kNumLanes <= count; i += kNumLanes) {
+      const Word lanes =
+          _pdep_u64(read_bits((first + i) * w, kNumLanes * w), mask);
+      for (std::size_t j = 0; j < kNumLanes; ++j) {
+        out[i + j] = (lanes >> (j * LaneWidth)) & kLaneMask;
+      }
+    }
+
+    return i;
+  }
+
+  /**
+   * Encodes groups of integers, each of which fills the lanes of a word, using
+   * PEXT. The width has to be at most the lane width.
+   *
+   * @tparam LaneWidth The width in bits of a lane, which divides 64.
+   * @param first The position of the first integer to encode.
+   * @param count The number of integers to encode.
+   * @param in A pointer to the array, which has to hold at least count
+   * integers.
+   * @return The number of integers that have been encoded.
+   */
+  template <std::size_t LaneWidth>
+  std::size_t encode_lanes(const std::size_t first,
+                           const std::size_t count,
+                           const Int* const in) {
+    constexpr std::size_t kNumLanes = kWordWidth / LaneWidth;
+    constexpr Word kLaneMask = math::setbits<Word>(LaneWidth);
+
+    const std::size_t w = width();
+    const Word mask = lane_mask<LaneWidth>(w);
+
+    std::size_t i = 0;
+    for (; i + kNumLanes <= count; i += kNumLanes) {
+      Word lanes = 0;
+      for (std::size_t j = 0; j < kNumLanes; ++j) {
+        lanes |= (in[i + j] & kLaneMask) << (j * LaneWidth);
+      }
+
+      write_bits((first + i) * w, kNumLanes * w, _pext_u64(lanes, mask));
+    }
+
+    return i;
+  }
+
+  /**
+   * Returns a mask whose lowest bits of each lane are set.
+   *
+   * @tparam LaneWidth The width in bits of a lane, which divides 64.
+   * @param num_bits The number of bits that are set per lane.
+   * @return The mask.
+   */
+  template <std::size_t LaneWidth>
+  [[nodiscard]] static constexpr Word lane_mask(const std::size_t num_bits) {
+    // Dividing the word with all bits set by the lane mask yields a word whose
+    // least significant bit of each lane is set.
+    constexpr Word kLowBits =
+        math::setbits<Word>(kWordWidth) / math::setbits<Word>(LaneWidth);
+    return kLowBits * math::setbits<Word>(num_bits);
+  }
+#endif
+
+  /**
+   * Returns at most 64 consecutive bits.
+   *
+   * @param pos The position of the first bit.
+   * @param len The number of bits, which is at most 64.
+   * @return The bits.
+   */
+  [[nodiscard]] inline Word read_bits(const std::size_t pos,
+                                      const std::size_t len) const {
+    const std::size_t num_word = pos / kWordWidth;
+    const std::size_t word_pos = pos % kWordWidth;
+
+    // Shift the next word in two steps, such that it is shifted out entirely
+    // if the bits start at a word boundary, which avoids a conditional jump.
+    const Word next_word = _data[num_word + 1] << 1;
+    const Word bits = (_data[num_word] >> word_pos) |
+                      (next_word << (kWordWidth - 1 - word_pos));
+    return bits & math::setbits<Word>(len);
+  }
+
+  /**
+   * Overwrites at most 64 consecutive bits.
+   *
+   * @param pos The position of the first bit.
+   * @param len The number of bits, which is at most 64.
+   * @param value The bits, whose bits beyond the length are ignored.
+   */
+  inline void write_bits(const std::size_t pos,
+                         const std::size_t len,
+                         Word value) {
+    const std::size_t num_word = pos / kWordWidth;
+    const std::size_t word_pos = pos % kWordWidth;
+
+    const Word mask = math::setbits<Word>(len);
+    value &= mask;
+
+    _data[num_word] =
+        (_data[num_word] & ~(mask << word_pos)) | (value << word_pos);
+    if (word_pos + len > kWordWidth) {
+      const std::size_t shift = kWordWidth - word_pos;
+      _data[num_word + 1] =
+          (_data[num_word + 1] & ~(mask >> shift)) | (value >> shift);
+    }
+  }
+
+  std::size_t _length;
+  std::size_t _width;
+  StaticVector<Word> _data;
+};
+
+}  // namespace bitsy
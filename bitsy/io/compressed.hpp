@@ -0,0 +1,901 @@
+/// A file format that compresses the bits of a bit vector with rank and select
+/// support per superblock, and a data structure that queries such a file using
+/// a cache of decompressed superblocks.
+/// @file compressed.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "bitsy/io/serialization.hpp"
+#include "bitsy/rank/two_layer_rank_combined_bitvector.hpp"
+#include "bitsy/select/two_layer_select.hpp"
+#include "bitsy/util/math.hpp"
+#include "bitsy/util/static_vector.hpp"
+
+namespace bitsy::serialization {
+
+// clang-format off
+/**
+ * The header at the start of a file that stores a two-layer rank-combined bit
+ * vector and its two-layer select data structure, whose bits are compressed
+ * per superblock.
+ *
+ * The file consists of the header followed by five sections, each of which
+ * starts at an offset that is a multiple of the page size:
+ *
+ * --------------------------------------------------------------------------
+ * | Header | Superblocks | Zero | One | Compressed superblocks | Index     |
+ * --------------------------------------------------------------------------
+ *
+ * The superblock ranks and the samples are stored uncompressed as for the
+ * uncompressed format. Each superblock is compressed independently without its
+ * block headers, which are recomputed when it is decompressed, and the index
+ * stores the offset in bytes of each compressed superblock within the section
+ * as well as the size of the section.
+ */
+// clang-format on
+struct CompressedHeader {
+  //! Identifies the file format.
+  char magic[8];
+  //! The version of the file format.
+  std::uint64_t version;
+
+  //! The width in bits of a block.
+  std::uint64_t block_width;
+  //! The width in bits of a block header.
+  std::uint64_t block_header_width;
+  //! The stride with which the select samples are taken.
+  std::uint64_t stride;
+  //! Whether the samples for select queries for zeros are stored.
+  std::uint64_t support_select0;
+  //! Whether the samples for select queries for ones are stored.
+  std::uint64_t support_select1;
+
+  //! The number of bits.
+  std::uint64_t length;
+  //! The number of bits set to one.
+  std::uint64_t num_ones;
+
+  //! The number of superblock ranks.
+  std::uint64_t num_superblocks;
+  //! The number of samples for select queries for zeros.
+  std::uint64_t num_zero_samples;
+  //! The number of samples for select queries for ones.
+  std::uint64_t num_one_samples;
+  //! The number of words in the section with the compressed superblocks.
+  std::uint64_t num_data_words;
+
+  //! The offset in bytes of the superblock section.
+  std::uint64_t superblock_offset;
+  //! The offset in bytes of the section with the samples for zeros.
+  std::uint64_t zero_samples_offset;
+  //! The offset in bytes of the section with the samples for ones.
+  std::uint64_t one_samples_offset;
+  //! The offset in bytes of the section with the compressed superblocks.
+  std::uint64_t data_offset;
+  //! The offset in bytes of the index of the compressed superblocks.
+  std::uint64_t index_offset;
+};
+
+//! The magic bytes at the start of a file with compressed superblocks.
+constexpr char kCompressedMagic[8] = {'B', 'I', 'T', 'S', 'Y', 'C', 'S', '\0'};
+
+/**
+ * A codec for words of bits that encodes runs of words with all bits set to
+ * zero or one and runs of repeated words, and stores the other words literally.
+ *
+ * The words are encoded as a sequence of tokens. Each token starts with a byte
+ * whose two most significant bits store the kind of the token and whose other
+ * bits store the number of words minus one that it encodes. A run of words
+ * with all bits set to zero or one needs no further bytes, a run of a repeated
+ * word is followed by the word and literals are followed by the words.
+ */
+class WordCodec {
+  using Word = std::uint64_t;
+
+  static constexpr std::size_t kKindWidth = 2;
+  static constexpr std::size_t kCountWidth = 8 - kKindWidth;
+  static constexpr std::size_t kMaxCount = math::pow2(kCountWidth);
+
+  enum Kind : std::uint8_t {
+    ZEROS = 0,
+    ONES = 1,
+    REPEAT = 2,
+    LITERALS = 3,
+  };
+
+ public:
+  /**
+   * Encodes words and appends the encoding to a buffer.
+   *
+   * @param words A pointer to the words to encode.
+   * @param num_words The number of words to encode.
+   * @param buffer The buffer to append the encoding to.
+   */
+  static void encode(const Word* const words,
+                     const std::size_t num_words,
+                     std::vector<std::uint8_t>& buffer) {
+    // Returns the length of the run of equal words that starts at a position.
+    const auto run_length = [&](const std::size_t pos) {
+      std::size_t length = 1;
+      while (pos + length < num_words && length < kMaxCount &&
+             words[pos + length] == words[pos]) {
+        length += 1;
+      }
+
+      return length;
+    };
+
+    std::size_t pos = 0;
+    while (pos < num_words) {
+      const Word word = words[pos];
+      const std::size_t length = run_length(pos);
+
+      if (word == 0 || word == ~static_cast<Word>(0)) {
+        append_token(buffer, (word == 0) ? ZEROS : ONES, length);
+        pos += length;
+        continue;
+      }
+
+      if (length > 1) {
+        append_token(buffer, REPEAT, length);
+        append_word(buffer, word);
+        pos += length;
+        continue;
+      }
+
+      // Collect literal words until a run starts, which is encoded by its own
+      // token.
+      std::size_t num_literals = 1;
+      while (pos + num_literals < num_words && num_literals < kMaxCount) {
+        const Word next = words[pos + num_literals];
+        if (next == 0 || next == ~static_cast<Word>(0) ||
+            run_length(pos + num_literals) > 1) {
+          break;
+        }
+
+        num_literals += 1;
+      }
+
+      append_token(buffer, LITERALS, num_literals);
+      for (std::size_t i = 0; i < num_literals; ++i) {
+        append_word(buffer, words[pos + i]);
+      }
+      pos += num_literals;
+    }
+  }
+
+  /**
+   * Decodes words that have been encoded and throws an exception if the
+   * encoding is corrupted, i.e., if a token reads past the end of the encoding
+   * or encodes more words than are to be decoded.
+   *
+   * @param encoding A pointer to the encoding.
+   * @param end A pointer past the last byte of the encoding.
+   * @param words A pointer to the memory to store the decoded words.
+   * @param num_words The number of words to decode.
+   * @return A pointer past the last byte of the encoding that has been read.
+   */
+  static const std::uint8_t* decode(const std::uint8_t* encoding,
+                                    const std::uint8_t* const end,
+                                    Word* const words,
+                                    const std::size_t num_words) {
+    std::size_t pos = 0;
+    while (pos < num_words) {
+      if (encoding == end) {
+        throw std::runtime_error("The encoding is corrupted.");
+      }
+
+      const std::uint8_t token = *encoding++;
+      const std::size_t length = (token & (kMaxCount - 1)) + 1;
+      if (length > num_words - pos) {
+        throw std::runtime_error("The encoding is corrupted.");
+      }
+
+      const auto num_bytes = static_cast<std::size_t>(end - encoding);
+      switch (static_cast<Kind>(token >> kCountWidth)) {
+        case ZEROS:
+          std::fill_n(words + pos, length, 0);
+          break;
+        case ONES:
+          std::fill_n(words + pos, length, ~static_cast<Word>(0));
+          break;
+        case REPEAT:
+          if (num_bytes < sizeof(Word)) {
+            throw std::runtime_error("The encoding is corrupted.");
+          }
+
+          std::fill_n(words + pos, length, read_word(encoding));
+          encoding += sizeof(Word);
+          break;
+        case LITERALS:
+          if (num_bytes < length * sizeof(Word)) {
+            throw std::runtime_error("The encoding is corrupted.");
+          }
+
+          std::memcpy(words + pos, encoding, length * sizeof(Word));
+          encoding += length * sizeof(Word);
+          break;
+      }
+
+      pos += length;
+    }
+
+    return encoding;
+  }
+
+ private:
+  static void append_token(std::vector<std::uint8_t>& buffer,
+                           const Kind kind,
+                           const std::size_t length) {
+    buffer.push_back(static_cast<std::uint8_t>((kind << kCountWidth) |
+                                               (length - 1)));
+  }
+
+  static void append_word(std::vector<std::uint8_t>& buffer, const Word word) {
+    std::uint8_t bytes[sizeof(Word)];
+    std::memcpy(bytes, &word, sizeof(Word));
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(Word));
+  }
+
+  [[nodiscard]] static Word read_word(const std::uint8_t* const bytes) {
+    Word word;
+    std::memcpy(&word, bytes, sizeof(Word));
+    return word;
+  }
+};
+
+/**
+ * Computes the header of a file with compressed superblocks, including the
+ * offsets of its sections, from the sizes of the sections.
+ *
+ * @tparam BitVector The type of rank-combined bit vector that is stored.
+ * @tparam Select The type of select data structure that is stored.
+ * @param length The number of bits.
+ * @param num_ones The number of bits set to one.
+ * @param num_superblocks The number of superblock ranks.
+ * @param num_zero_samples The number of samples for zeros.
+ * @param num_one_samples The number of samples for ones.
+ * @param num_data_words The number of words in the section with the
+ * compressed superblocks.
+ * @return The header.
+ */
+template <typename BitVector, typename Select>
+[[nodiscard]] CompressedHeader make_compressed_header(
+    const std::size_t length,
+    const std::size_t num_ones,
+    const std::size_t num_superblocks,
+    const std::size_t num_zero_samples,
+    const std::size_t num_one_samples,
+    const std::size_t num_data_words) {
+  constexpr std::size_t kWordSize = sizeof(std::uint64_t);
+
+  CompressedHeader header;
+  std::memcpy(header.magic, kCompressedMagic, sizeof(kCompressedMagic));
+  header.version = kVersion;
+  header.block_width = BitVector::kBlockWidth;
+  header.block_header_width = BitVector::kBlockHeaderWidth;
+  header.stride = Select::kStride;
+  header.support_select0 = Select::kSupportSelect0;
+  header.support_select1 = Select::kSupportSelect1;
+  header.length = length;
+  header.num_ones = num_ones;
+  header.num_superblocks = num_superblocks;
+  header.num_zero_samples = num_zero_samples;
+  header.num_one_samples = num_one_samples;
+  header.num_data_words = num_data_words;
+
+  header.superblock_offset =
+      math::round_to(sizeof(CompressedHeader), kAlignment);
+  header.zero_samples_offset = math::round_to(
+      header.superblock_offset + num_superblocks * kWordSize, kAlignment);
+  header.one_samples_offset = math::round_to(
+      header.zero_samples_offset + num_zero_samples * kWordSize, kAlignment);
+  header.data_offset = math::round_to(
+      header.one_samples_offset + num_one_samples * kWordSize, kAlignment);
+  header.index_offset = math::round_to(
+      header.data_offset + num_data_words * kWordSize, kAlignment);
+  return header;
+}
+
+/**
+ * Stores a two-layer rank-combined bit vector and its select data structure in
+ * a file, whereby the bits are compressed per superblock. The rank information
+ * of the bit vector and the select data structure have to be up-to-date.
+ *
+ * @tparam BitVector The type of rank-combined bit vector to store.
+ * @tparam Select The type of select data structure to store.
+ * @param filename The name of the file to write.
+ * @param bitvector The bit vector to store.
+ * @param select The select data structure to store.
+ */
+template <typename BitVector, typename Select>
+void save_compressed(const std::string& filename,
+                     const BitVector& bitvector,
+                     const Select& select) {
+  using Word = std::uint64_t;
+  constexpr std::size_t kWordSize = sizeof(Word);
+  constexpr std::size_t kBlockHeaderWidth = BitVector::kBlockHeaderWidth;
+  constexpr std::size_t kNumWordsPerBlock = BitVector::kNumWordsPerBlock;
+  constexpr std::size_t kNumWordsPerSuperblock =
+      BitVector::kNumWordsPerSuperblock;
+
+  const auto zero_samples = select.zero_samples();
+  const auto one_samples = select.one_samples();
+
+  // The offsets of the sections before the compressed superblocks do not
+  // depend on their size, which is only known once they have been written.
+  const auto compute_header = [&](const std::size_t num_data_words) {
+    return make_compressed_header<BitVector, Select>(
+        bitvector.length(), bitvector.num_ones(), bitvector.num_superblocks(),
+        zero_samples.size(), one_samples.size(), num_data_words);
+  };
+  CompressedHeader header = compute_header(0);
+
+  const File file = open(filename, "wb");
+  pad(file.get(), header.superblock_offset);
+  write(file.get(), bitvector.superblock_data(),
+        header.num_superblocks * kWordSize);
+
+  pad(file.get(), header.zero_samples_offset);
+  write(file.get(), zero_samples.data(), zero_samples.size() * kWordSize);
+
+  pad(file.get(), header.one_samples_offset);
+  write(file.get(), one_samples.data(), one_samples.size() * kWordSize);
+
+  // Compress the superblocks one after another, whereby the header bits of
+  // each block are replaced by copies of its first bit such that they do not
+  // interrupt runs of words with all bits set to zero or one.
+  pad(file.get(), header.data_offset);
+
+  std::vector<Word> index;
+  index.reserve(header.num_superblocks + 1);
+
+  std::vector<std::uint8_t> buffer;
+  Word superblock[kNumWordsPerSuperblock];
+  const std::size_t num_words = bitvector.num_blocks() * kNumWordsPerBlock;
+  for (std::size_t first_word = 0; first_word < num_words;
+       first_word += kNumWordsPerSuperblock) {
+    const std::size_t num_superblock_words =
+        std::min(kNumWordsPerSuperblock, num_words - first_word);
+    std::copy_n(bitvector.data() + first_word, num_superblock_words,
+                superblock);
+
+    constexpr Word kHeaderMask = math::setbits<Word>(kBlockHeaderWidth);
+    for (std::size_t i = 0; i < num_superblock_words; i += kNumWordsPerBlock) {
+      const Word first_bit = (superblock[i] >> kBlockHeaderWidth) & 1;
+      superblock[i] =
+          (superblock[i] & ~kHeaderMask) | (-first_bit & kHeaderMask);
+    }
+
+    index.push_back(buffer.size());
+    WordCodec::encode(superblock, num_superblock_words, buffer);
+  }
+  index.push_back(buffer.size());
+
+  buffer.resize(math::round_to(buffer.size(), kWordSize));
+  write(file.get(), buffer.data(), buffer.size());
+
+  header = compute_header(buffer.size() / kWordSize);
+  pad(file.get(), header.index_offset);
+  write(file.get(), index.data(), index.size() * kWordSize);
+
+  if (std::fseek(file.get(), 0, SEEK_SET) != 0) {
+    throw std::runtime_error("Cannot seek in file " + filename + ".");
+  }
+  write(file.get(), &header, sizeof(CompressedHeader));
+}
+
+/**
+ * A two-layer rank-combined bit vector and its two-layer select data structure
+ * that are queried from a file whose bits are compressed per superblock.
+ *
+ * Only the superblock ranks, the select samples and the index of the compressed
+ * superblocks are kept in memory, while the section with the compressed
+ * superblocks is mapped and read on demand. A query first determines the
+ * superblock that contains the answer using the superblock ranks and samples,
+ * then decompresses this superblock (i.e., a query touches one compressed
+ * superblock) and answers the query using the rank and select data structure
+ * of the decompressed superblock. The most recently used decompressed
+ * superblocks are kept in a cache, such that repeated queries to the same
+ * superblocks do not have to decompress them again.
+ *
+ * As queries update the cache, they must not be issued concurrently.
+ *
+ * @tparam BitVector The type of rank-combined bit vector that is stored.
+ * @tparam Select The type of select data structure that is stored.
+ */
+template <typename BitVector = TwoLayerRankCombinedBitVector<>,
+          typename Select = TwoLayerSelect<BitVector>>
+class CompressedRankSelect {
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordWidth = sizeof(Word) * 8;
+  static constexpr std::size_t kWordSize = sizeof(Word);
+
+  static constexpr std::size_t kNumWordsPerBlock = BitVector::kNumWordsPerBlock;
+  static constexpr std::size_t kNumBlocksPerSuperblock =
+      BitVector::kNumBlocksPerSuperblock;
+  static constexpr std::size_t kSuperblockDataWidth =
+      BitVector::kSuperblockDataWidth;
+
+  static constexpr std::size_t kStride = Select::kStride;
+
+  /**
+   * A decompressed superblock, which is stored as a bit vector with the rank
+   * and select data structure of its own.
+   */
+  struct Superblock {
+    BitVector bitvector;
+    Select select;
+
+    Superblock(const std::size_t length, StaticVector<Word>&& data)
+        : bitvector(update(
+              BitVector(length, 0, std::move(data), StaticVector<Word>(1)))),
+          select(bitvector) {
+    }
+
+    /**
+     * Recomputes the rank and select data after the words of the bit vector
+     * have been overwritten with those of another superblock of the same
+     * length, such that the memory of the superblock is reused.
+     */
+    void update() {
+      bitvector.update();
+      select.update();
+    }
+
+    [[nodiscard]] static BitVector update(BitVector&& bitvector) {
+      bitvector.update();
+      return std::move(bitvector);
+    }
+  };
+
+ public:
+  /**
+   * Opens a file whose bits are compressed per superblock.
+   *
+   * @param filename The name of the file to open.
+   * @param cache_capacity The maximum number of decompressed superblocks that
+   * are cached.
+   */
+  explicit CompressedRankSelect(const std::string& filename,
+                                const std::size_t cache_capacity = 64)
+      : CompressedRankSelect(filename, open(filename, "rb"), cache_capacity) {
+  }
+
+  // Create the default destructor.
+  ~CompressedRankSelect() = default;
+
+  // Delete the move and copy constructor/assignment operator, as the cached
+  // superblocks are not intended to be moved or copied.
+  CompressedRankSelect(CompressedRankSelect&&) = delete;
+  CompressedRankSelect& operator=(CompressedRankSelect&&) = delete;
+  CompressedRankSelect(CompressedRankSelect const&) = delete;
+  CompressedRankSelect& operator=(CompressedRankSelect const&) = delete;
+
+  /**
+   * Returns whether a bit is set.
+   *
+   * @param pos The position of the bit that is to be queried.
+   * @return Whether the bit is set.
+   */
+  [[nodiscard]] bool is_set(const std::size_t pos) {
+    const std::size_t num_superblock = pos / kSuperblockDataWidth;
+    return superblock(num_superblock)
+        .bitvector.is_set(pos % kSuperblockDataWidth);
+  }
+
+  /**
+   * Returns the number of bits equal to zero up to a position.
+   *
+   * @param pos The position up to which bits are to be taken into account.
+   * @return The number of bits equal to zero up to the position.
+   */
+  [[nodiscard]] Word rank0(const std::size_t pos) {
+    return static_cast<Word>(pos) - rank1(pos);
+  }
+
+  /**
+   * Returns the number of bits equal to one up to a position.
+   *
+   * @param pos The position up to which bits are to be taken into account.
+   * @return The number of bits equal to one up to the position.
+   */
+  [[nodiscard]] Word rank1(const std::size_t pos) {
+    const std::size_t num_superblock = pos / kSuperblockDataWidth;
+    if (num_superblock == _header.num_superblocks) [[unlikely]] {
+      return _header.num_ones;
+    }
+
+    return _superblock_data[num_superblock] +
+           superblock(num_superblock)
+               .bitvector.rank1(pos % kSuperblockDataWidth);
+  }
+
+  /**
+   * Returns the position of the rank-th occurence of zero.
+   *
+   * @param rank The rank of the zero whose position is to be returned.
+   * @return The position of the zero with given rank.
+   */
+  [[nodiscard]] Word select0(const std::size_t rank)
+    requires Select::kSupportSelect0
+  {
+    const auto superblock_rank = [&](const Word num_superblock) {
+      return num_superblock * kSuperblockDataWidth -
+             _superblock_data[num_superblock];
+    };
+
+    const Word num_superblock =
+        find_superblock(_zero_samples, rank, superblock_rank);
+    const Word local_rank = rank - superblock_rank(num_superblock);
+    return num_superblock * kSuperblockDataWidth +
+           superblock(num_superblock).select.select0(local_rank);
+  }
+
+  /**
+   * Returns the position of the rank-th occurence of one.
+   *
+   * @param rank The rank of the one whose position is to be returned.
+   * @return The position of the one with given rank.
+   */
+  [[nodiscard]] Word select1(const std::size_t rank)
+    requires Select::kSupportSelect1
+  {
+    const auto superblock_rank = [&](const Word num_superblock) {
+      return _superblock_data[num_superblock];
+    };
+
+    const Word num_superblock =
+        find_superblock(_one_samples, rank, superblock_rank);
+    const Word local_rank = rank - superblock_rank(num_superblock);
+    return num_superblock * kSuperblockDataWidth +
+           superblock(num_superblock).select.select1(local_rank);
+  }
+
+  /**
+   * Returns the number of bits.
+   *
+   * @return The number of bits.
+   */
+  [[nodiscard]] inline std::size_t length() const {
+    return _header.length;
+  }
+
+  /**
+   * Returns the number of bits set to one.
+   *
+   * @return The number of bits set to one.
+   */
+  [[nodiscard]] inline std::size_t num_ones() const {
+    return _header.num_ones;
+  }
+
+  /**
+   * Returns the number of superblocks that have been decompressed, i.e., the
+   * number of queries that have missed the cache.
+   *
+   * @return The number of superblocks that have been decompressed.
+   */
+  [[nodiscard]] inline std::size_t num_decompressions() const {
+    return _num_decompressions;
+  }
+
+  /**
+   * Returns the size in bits of the compressed superblocks.
+   *
+   * @return The size in bits of the compressed superblocks.
+   */
+  [[nodiscard]] inline std::size_t compressed_space() const {
+    return _index[_header.num_superblocks] * 8;
+  }
+
+  /**
+   * Returns the used memory space of this data structure in bits, excluding
+   * the mapped compressed superblocks and the cache.
+   *
+   * @return The used memory space of this data structure in bits.
+   */
+  [[nodiscard]] inline std::size_t memory_space() const {
+    return (_superblock_data.size() + _zero_samples.size() +
+            _one_samples.size() + _index.size()) *
+           kWordWidth;
+  }
+
+ private:
+  CompressedRankSelect(const std::string& filename,
+                       const File& file,
+                       const std::size_t cache_capacity)
+      : _header(read_header(filename, file.get())),
+        _superblock_data(read_section(file.get(), _header.superblock_offset,
+                                      _header.num_superblocks)),
+        _zero_samples(read_section(file.get(), _header.zero_samples_offset,
+                                   _header.num_zero_samples)),
+        _one_samples(read_section(file.get(), _header.one_samples_offset,
+                                  _header.num_one_samples)),
+        _index(read_section(file.get(), _header.index_offset,
+                            _header.num_superblocks + 1)),
+        _data(read_data(file.get(), _header)),
+        _cache_capacity(std::max<std::size_t>(cache_capacity, 1)),
+        _num_decompressions(0) {
+    check_index(filename);
+  }
+
+  /**
+   * Reads the header of a file and checks whether it has been written for the
+   * given types of bit vector and select data structure.
+   *
+   * Besides the configuration, the sizes and offsets of the sections are
+   * checked against the ones that follow from the length, the number of ones
+   * and the size of the section with the compressed superblocks, and the
+   * sections are checked to lie within the file, such that a corrupted or
+   * truncated file cannot lead to out-of-bounds accesses.
+   *
+   * @param filename The name of the file, which is reported on failure.
+   * @param file The file to read from.
+   * @return The header.
+   */
+  [[nodiscard]] static CompressedHeader read_header(
+      const std::string& filename,
+      std::FILE* file) {
+    CompressedHeader header;
+    read(file, &header, sizeof(CompressedHeader));
+
+    if (std::memcmp(header.magic, kCompressedMagic,
+                    sizeof(kCompressedMagic)) != 0) {
+      throw std::runtime_error("The file " + filename +
+                               " is not a compressed Bitsy rank/select file.");
+    }
+
+    if (header.version != kVersion) {
+      throw std::runtime_error("The file " + filename +
+                               " has an unsupported version of the format.");
+    }
+
+    if (header.block_width != BitVector::kBlockWidth ||
+        header.block_header_width != BitVector::kBlockHeaderWidth ||
+        header.stride != kStride ||
+        header.support_select0 != Select::kSupportSelect0 ||
+        header.support_select1 != Select::kSupportSelect1) {
+      throw std::runtime_error("The file " + filename +
+                               " stores a different configuration.");
+    }
+
+    if (std::fseek(file, 0, SEEK_END) != 0) {
+      throw std::runtime_error("Cannot seek in file " + filename + ".");
+    }
+    const long file_size = std::ftell(file);
+    if (file_size < 0) {
+      throw std::runtime_error("Cannot seek in file " + filename + ".");
+    }
+
+    const auto num_file_words = static_cast<std::size_t>(file_size) / kWordSize;
+    if (header.num_ones > header.length ||
+        header.num_data_words > num_file_words) {
+      throw std::runtime_error("The file " + filename + " is corrupted.");
+    }
+
+    const std::size_t length = header.length;
+    const std::size_t num_ones = header.num_ones;
+    const CompressedHeader expected =
+        make_compressed_header<BitVector, Select>(
+            length, num_ones, math::div_ceil(length, kSuperblockDataWidth),
+            Select::kSupportSelect0 ? (length - num_ones) / kStride + 2 : 0,
+            Select::kSupportSelect1 ? num_ones / kStride + 2 : 0,
+            header.num_data_words);
+
+    // The header consists of integers only and thus contains no padding.
+    if (std::memcmp(&header, &expected, sizeof(CompressedHeader)) != 0 ||
+        header.index_offset + (header.num_superblocks + 1) * kWordSize >
+            static_cast<std::size_t>(file_size)) {
+      throw std::runtime_error("The file " + filename + " is corrupted.");
+    }
+
+    return header;
+  }
+
+  /**
+   * Checks whether the offsets of the compressed superblocks are increasing
+   * and lie within the section with the compressed superblocks, and throws an
+   * exception otherwise.
+   *
+   * @param filename The name of the file, which is reported on failure.
+   */
+  void check_index(const std::string& filename) const {
+    const std::size_t num_data_bytes = _header.num_data_words * kWordSize;
+    bool is_valid = _index[0] == 0;
+    for (std::size_t i = 1; i <= _header.num_superblocks; ++i) {
+      is_valid &= _index[i - 1] <= _index[i];
+    }
+    is_valid &= _index[_header.num_superblocks] <= num_data_bytes;
+
+    if (!is_valid) {
+      throw std::runtime_error("The file " + filename + " is corrupted.");
+    }
+  }
+
+  /**
+   * Maps the section with the compressed superblocks of a file into memory, or
+   * reads it if mapping files is not supported.
+   *
+   * @param file The file to read from.
+   * @param header The header of the file.
+   * @return The words of the section.
+   */
+  [[nodiscard]] static StaticVector<Word> read_data(
+      std::FILE* file,
+      const CompressedHeader& header) {
+#ifdef __linux__
+    // Only the compressed superblocks that are queried are read from disk, and
+    // each query reads a single compressed superblock.
+    auto data = StaticVector<Word>::map(fileno(file), header.data_offset,
+                                        header.num_data_words);
+    data.advise(MADV_RANDOM);
+    return data;
+#else
+    return read_section(file, header.data_offset, header.num_data_words);
+#endif
+  }
+
+  /**
+   * Finds the superblock that contains the rank-th occurence of a bit, using
+   * the samples to narrow down the superblocks and a binary search over the
+   * ranks of the superblocks.
+   *
+   * @tparam SuperblockRank The type of function that returns the rank.
+   * @param samples The samples of the bit.
+   * @param rank The rank of the occurence.
+   * @param superblock_rank A function that returns the number of occurences up
+   * to the start of a superblock.
+   * @return The number of the superblock.
+   */
+  template <typename SuperblockRank>
+  [[nodiscard]] static Word find_superblock(
+      const StaticVector<Word>& samples,
+      const std::size_t rank,
+      SuperblockRank&& superblock_rank) {
+    const std::size_t nearest_prev_sample = (rank - 1) / kStride;
+
+    Word num_superblock = samples[nearest_prev_sample];
+    Word length = samples[nearest_prev_sample + 1] - num_superblock + 1;
+    while (length > 1) {
+      const Word half = length / 2;
+      length -= half;
+      num_superblock += (superblock_rank(num_superblock + half) < rank) * half;
+    }
+
+    return num_superblock;
+  }
+
+  /**
+   * Returns a decompressed superblock, which is decompressed if it is not
+   * cached and then becomes the most recently used one.
+   *
+   * @param num_superblock The number of the superblock.
+   * @return The decompressed superblock.
+   */
+  [[nodiscard]] Superblock& superblock(const std::size_t num_superblock) {
+    if (const auto it = _cache_index.find(num_superblock);
+        it != _cache_index.end()) {
+      _cache.splice(_cache.begin(), _cache, it->second);
+      return *_cache.front().second;
+    }
+
+    if (_cache.size() < _cache_capacity) {
+      _cache.emplace_front(num_superblock, decompress(num_superblock));
+    } else {
+      // Evict the least recently used superblock and reuse its memory, unless
+      // its length differs (i.e., one of them is the last superblock).
+      _cache_index.erase(_cache.back().first);
+      _cache.splice(_cache.begin(), _cache, std::prev(_cache.end()));
+
+      auto& [num_cached, cached] = _cache.front();
+      num_cached = num_superblock;
+      try {
+        if (cached->bitvector.length() == superblock_length(num_superblock)) {
+          decode(num_superblock, cached->bitvector.mutable_data());
+          cached->update();
+        } else {
+          cached = decompress(num_superblock);
+        }
+      } catch (...) {
+        // Drop the superblock whose memory has been partially overwritten.
+        _cache.pop_front();
+        throw;
+      }
+    }
+
+    _cache_index.emplace(num_superblock, _cache.begin());
+    return *_cache.front().second;
+  }
+
+  /**
+   * Returns the number of bits of a superblock.
+   *
+   * @param num_superblock The number of the superblock.
+   * @return The number of bits of the superblock.
+   */
+  [[nodiscard]] std::size_t superblock_length(
+      const std::size_t num_superblock) const {
+    return std::min(kSuperblockDataWidth,
+                    _header.length - num_superblock * kSuperblockDataWidth);
+  }
+
+  /**
+   * Decompresses a superblock into newly allocated memory and recomputes its
+   * block headers.
+   *
+   * @param num_superblock The number of the superblock.
+   * @return The decompressed superblock.
+   */
+  [[nodiscard]] std::unique_ptr<Superblock> decompress(
+      const std::size_t num_superblock) {
+    const std::size_t length = superblock_length(num_superblock);
+    const std::size_t num_blocks =
+        math::div_ceil(length, BitVector::kBlockDataWidth);
+
+    // Allocate the padding blocks that the bit vector expects after its last
+    // block, whose headers are written by its update.
+    const std::size_t num_words = num_blocks * kNumWordsPerBlock;
+    StaticVector<Word> data(num_words +
+                            (kNumBlocksPerSuperblock / 2) * kNumWordsPerBlock);
+    std::fill(data.data() + num_words, data.data() + data.size(), 0);
+
+    decode(num_superblock, data.data());
+    return std::make_unique<Superblock>(length, std::move(data));
+  }
+
+  /**
+   * Decodes the words of a compressed superblock, whose block headers are not
+   * yet computed.
+   *
+   * @param num_superblock The number of the superblock.
+   * @param out The memory to which the words are written.
+   */
+  void decode(const std::size_t num_superblock, Word* const out) {
+    _num_decompressions += 1;
+
+    const std::size_t num_words =
+        math::div_ceil(superblock_length(num_superblock),
+                       BitVector::kBlockDataWidth) *
+        kNumWordsPerBlock;
+    const auto* const encoding =
+        reinterpret_cast<const std::uint8_t*>(_data.data());
+    WordCodec::decode(encoding + _index[num_superblock],
+                      encoding + _index[num_superblock + 1], out, num_words);
+  }
+
+  CompressedHeader _header;
+
+  StaticVector<Word> _superblock_data;
+  StaticVector<Word> _zero_samples;
+  StaticVector<Word> _one_samples;
+  StaticVector<Word> _index;
+  StaticVector<Word> _data;
+
+  std::size_t _cache_capacity;
+  std::size_t _num_decompressions;
+  std::list<std::pair<std::size_t, std::unique_ptr<Superblock>>> _cache;
+  std::unordered_map<std::size_t, typename decltype(_cache)::iterator>
+      _cache_index;
+};
+
+}  // namespace bitsy::serialization
@@ -0,0 +1,229 @@
+/// Functions to query a bit vector with rank and select support that is larger
+/// than the main memory by mapping it from a file.
+/// @file out_of_core.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "bitsy/io/serialization.hpp"
+#include "bitsy/rank/two_layer_rank_combined_bitvector.hpp"
+#include "bitsy/select/two_layer_select.hpp"
+#include "bitsy/util/static_vector.hpp"
+
+namespace bitsy::serialization {
+
+/**
+ * The expected pattern with which the bits of a mapped bit vector are accessed,
+ * which controls how many pages the kernel reads from disk at once.
+ */
+enum class Access {
+  //! Read only the page that is accessed, i.e., at most one page per query.
+  RANDOM,
+  //! Read ahead aggressively, e.g., for scans over the bit vector.
+  SEQUENTIAL,
+};
+
+/**
+ * Maps a two-layer rank-combined bit vector and its select data structure from
+ * a file, such that bit vectors that are larger than the main memory can be
+ * queried.
+ *
+ * Only the superblock ranks and the select samples, which are small compared to
+ * the bits, are read into memory. The data section with the bits and the block
+ * headers is mapped and its pages are read on demand. As the data section is
+ * page-aligned and a block never crosses a page boundary, a rank query reads a
+ * single page and a select query reads the pages of the block headers of one
+ * superblock and of the block that contains the answer, which is a single page
+ * for superblocks of at most 4 KiB. With random access, the readahead of the
+ * kernel is disabled such that no other pages are read.
+ *
+ * On platforms that do not support mapping files, the file is loaded instead.
+ *
+ * @tparam BitVector The type of rank-combined bit vector to map.
+ * @tparam Select The type of select data structure to map.
+ * @param filename The name of the file to map.
+ * @param access The expected access pattern.
+ * @return The bit vector and select data structure.
+ */
+template <typename BitVector = TwoLayerRankCombinedBitVector<>,
+          typename Select = TwoLayerSelect<BitVector>>
+[[nodiscard]] std::unique_ptr<RankSelect<BitVector, Select>> map(
+    const std::string& filename,
+    [[maybe_unused]] const Access access = Access::RANDOM) {
+#ifdef __linux__
+  const File file = open(filename, "rb");
+
+  Header header;
+  read(file.get(), &header, sizeof(Header));
+  check_header<BitVector, Select>(header);
+
+  auto data = StaticVector<std::uint64_t>::map(
+      fileno(file.get()), header.data_offset, header.num_data_words);
+  data.advise(access == Access::RANDOM ? MADV_RANDOM : MADV_SEQUENTIAL);
+
+  auto superblock_data = read_section(file.get(), header.superblock_offset,
+                                      header.num_superblocks);
+  auto zero_samples = read_section(file.get(), header.zero_samples_offset,
+                                   header.num_zero_samples);
+  auto one_samples = read_section(file.get(), header.one_samples_offset,
+                                  header.num_one_samples);
+
+  return std::make_unique<RankSelect<BitVector, Select>>(
+      header, std::move(data), std::move(superblock_data),
+      std::move(zero_samples), std::move(one_samples));
+#else
+  return load<BitVector, Select>(filename);
+#endif
+}
+
+/**
+ * Sorts the arguments of a batch of queries together with their indices.
+ *
+ * @param arguments The arguments of the queries.
+ * @return The pairs of argument and index in ascending order of the arguments.
+ */
+[[nodiscard]] inline std::vector<std::pair<std::size_t, std::size_t>>
+sort_queries(const std::span<const std::size_t> arguments) {
+  std::vector<std::pair<std::size_t, std::size_t>> order(arguments.size());
+  for (std::size_t i = 0; i < arguments.size(); ++i) {
+    order[i] = {arguments[i], i};
+  }
+
+  std::sort(order.begin(), order.end());
+  return order;
+}
+
+/**
+ * Tells the kernel which pages of a mapped bit vector a batch of rank queries
+ * is going to access, such that their reads are issued at once and overlap.
+ *
+ * @tparam BitVector The type of rank-combined bit vector that is queried.
+ * @param bitvector The bit vector that is queried.
+ * @param order The positions of the queries in ascending order.
+ */
+template <typename BitVector>
+void prefetch(
+    [[maybe_unused]] const BitVector& bitvector,
+    [[maybe_unused]] const std::vector<std::pair<std::size_t, std::size_t>>&
+        order) {
+#ifdef __linux__
+  constexpr std::size_t kPageSize = kAlignment;
+  constexpr std::size_t kBlockSize = BitVector::kBlockWidth / 8;
+
+  const auto* const data = reinterpret_cast<const char*>(bitvector.data());
+
+  // As the positions are sorted, each page is only advised once.
+  std::size_t last_page = static_cast<std::size_t>(-1);
+  for (const auto& [pos, _] : order) {
+    const std::size_t num_block = pos / BitVector::kBlockDataWidth;
+    const std::size_t page = (num_block * kBlockSize) / kPageSize;
+
+    if (page != last_page) {
+      last_page = page;
+      madvise(const_cast<char*>(data + page * kPageSize), kPageSize,
+              MADV_WILLNEED);
+    }
+  }
+#endif
+}
+
+/**
+ * Answers a batch of rank queries for zeros on a (mapped) bit vector. The
+ * queries are answered in ascending order of their positions, such that queries
+ * that access the same page share its read, and the pages are prefetched.
+ *
+ * @tparam BitVector The type of rank-combined bit vector that is queried.
+ * @param bitvector The bit vector that is queried.
+ * @param positions The positions of the queries.
+ * @param ranks The memory to store the answers in the order of the queries.
+ */
+template <typename BitVector>
+void batch_rank0(const BitVector& bitvector,
+                 const std::span<const std::size_t> positions,
+                 const std::span<std::uint64_t> ranks) {
+  const auto order = sort_queries(positions);
+  prefetch(bitvector, order);
+
+  for (const auto& [pos, i] : order) {
+    ranks[i] = bitvector.rank0(pos);
+  }
+}
+
+/**
+ * Answers a batch of rank queries for ones on a (mapped) bit vector. The
+ * queries are answered in ascending order of their positions, such that queries
+ * that access the same page share its read, and the pages are prefetched.
+ *
+ * @tparam BitVector The type of rank-combined bit vector that is queried.
+ * @param bitvector The bit vector that is queried.
+ * @param positions The positions of the queries.
+ * @param ranks The memory to store the answers in the order of the queries.
+ */
+template <typename BitVector>
+void batch_rank1(const BitVector& bitvector,
+                 const std::span<const std::size_t> positions,
+                 const std::span<std::uint64_t> ranks) {
+  const auto order = sort_queries(positions);
+  prefetch(bitvector, order);
+
+  for (const auto& [pos, i] : order) {
+    ranks[i] = bitvector.rank1(pos);
+  }
+}
+
+/**
+ * Answers a batch of select queries for zeros on a (mapped) bit vector. As
+ * select is monotone, answering the queries in ascending order of their ranks
+ * accesses the pages in ascending order, such that queries that access the same
+ * page share its read.
+ *
+ * @tparam Select The type of select data structure that is queried.
+ * @param select The select data structure that is queried.
+ * @param ranks The ranks of the queries.
+ * @param positions The memory to store the answers in the order of the
+ * queries.
+ */
+template <typename Select>
+void batch_select0(const Select& select,
+                   const std::span<const std::size_t> ranks,
+                   const std::span<std::uint64_t> positions) {
+  for (const auto& [rank, i] : sort_queries(ranks)) {
+    positions[i] = select.select0(rank);
+  }
+}
+
+/**
+ * Answers a batch of select queries for ones on a (mapped) bit vector. As
+ * select is monotone, answering the queries in ascending order of their ranks
+ * accesses the pages in ascending order, such that queries that access the same
+ * page share its read.
+ *
+ * @tparam Select The type of select data structure that is queried.
+ * @param select The select data structure that is queried.
+ * @param ranks The ranks of the queries.
+ * @param positions The memory to store the answers in the order of the
+ * queries.
+ */
+template <typename Select>
+void batch_select1(const Select& select,
+                   const std::span<const std::size_t> ranks,
+                   const std::span<std::uint64_t> positions) {
+  for (const auto& [rank, i] : sort_queries(ranks)) {
+    positions[i] = select.select1(rank);
+  }
+}
+
+}  // namespace bitsy::serialization
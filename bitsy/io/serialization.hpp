@@ -0,0 +1,390 @@
+/// Functions to store a bit vector with rank and select support in a file and
+/// to load it again.
+/// @file serialization.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "bitsy/rank/two_layer_rank_combined_bitvector.hpp"
+#include "bitsy/select/two_layer_select.hpp"
+#include "bitsy/util/math.hpp"
+#include "bitsy/util/static_vector.hpp"
+
+namespace bitsy::serialization {
+
+// clang-format off
+/**
+ * The header at the start of a file that stores a two-layer rank-combined bit
+ * vector and its two-layer select data structure.
+ *
+ * The file consists of the header followed by four sections, each of which
+ * starts at an offset that is a multiple of the page size, such that it can be
+ * mapped into memory directly:
+ *
+ * --------------------------------------------------------------------------
+ * | Header | Data (bits and block headers) | Superblocks | Zero | One      |
+ * --------------------------------------------------------------------------
+ *
+ * The data section stores the words of the bit vector exactly as they are laid
+ * out in memory, including the padding blocks, and the other sections store the
+ * superblock ranks and the samples of the select data structure. All integers
+ * are stored in the byte order of the machine that has written the file.
+ */
+// clang-format on
+struct Header {
+  //! Identifies the file format.
+  char magic[8];
+  //! The version of the file format.
+  std::uint64_t version;
+
+  //! The width in bits of a block.
+  std::uint64_t block_width;
+  //! The width in bits of a block header.
+  std::uint64_t block_header_width;
+  //! The stride with which the select samples are taken.
+  std::uint64_t stride;
+  //! Whether the samples for select queries for zeros are stored.
+  std::uint64_t support_select0;
+  //! Whether the samples for select queries for ones are stored.
+  std::uint64_t support_select1;
+
+  //! The number of bits.
+  std::uint64_t length;
+  //! The number of bits set to one.
+  std::uint64_t num_ones;
+
+  //! The number of words in the data section.
+  std::uint64_t num_data_words;
+  //! The number of superblock ranks.
+  std::uint64_t num_superblocks;
+  //! The number of samples for select queries for zeros.
+  std::uint64_t num_zero_samples;
+  //! The number of samples for select queries for ones.
+  std::uint64_t num_one_samples;
+
+  //! The offset in bytes of the data section.
+  std::uint64_t data_offset;
+  //! The offset in bytes of the superblock section.
+  std::uint64_t superblock_offset;
+  //! The offset in bytes of the section with the samples for zeros.
+  std::uint64_t zero_samples_offset;
+  //! The offset in bytes of the section with the samples for ones.
+  std::uint64_t one_samples_offset;
+};
+
+//! The magic bytes at the start of a file.
+constexpr char kMagic[8] = {'B', 'I', 'T', 'S', 'Y', 'R', 'S', '\0'};
+//! The current version of the file format.
+constexpr std::uint64_t kVersion = 2;
+//! The alignment in bytes of each section, which is the page size.
+constexpr std::size_t kAlignment = 4096;
+
+/**
+ * Computes the header of a file, including the offsets of its sections, from
+ * the sizes of the sections.
+ *
+ * @tparam BitVector The type of rank-combined bit vector that is stored.
+ * @tparam Select The type of select data structure that is stored.
+ * @param length The number of bits.
+ * @param num_ones The number of bits set to one.
+ * @param num_data_words The number of words in the data section.
+ * @param num_superblocks The number of superblock ranks.
+ * @param num_zero_samples The number of samples for zeros.
+ * @param num_one_samples The number of samples for ones.
+ * @return The header.
+ */
+template <typename BitVector, typename Select>
+[[nodiscard]] Header make_header(const std::size_t length,
+                                 const std::size_t num_ones,
+                                 const std::size_t num_data_words,
+                                 const std::size_t num_superblocks,
+                                 const std::size_t num_zero_samples,
+                                 const std::size_t num_one_samples) {
+  constexpr std::size_t kWordSize = sizeof(std::uint64_t);
+
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.block_width = BitVector::kBlockWidth;
+  header.block_header_width = BitVector::kBlockHeaderWidth;
+  header.stride = Select::kStride;
+  header.support_select0 = Select::kSupportSelect0;
+  header.support_select1 = Select::kSupportSelect1;
+  header.length = length;
+  header.num_ones = num_ones;
+  header.num_data_words = num_data_words;
+  header.num_superblocks = num_superblocks;
+  header.num_zero_samples = num_zero_samples;
+  header.num_one_samples = num_one_samples;
+
+  header.data_offset = math::round_to(sizeof(Header), kAlignment);
+  header.superblock_offset = math::round_to(
+      header.data_offset + num_data_words * kWordSize, kAlignment);
+  header.zero_samples_offset = math::round_to(
+      header.superblock_offset + num_superblocks * kWordSize, kAlignment);
+  header.one_samples_offset = math::round_to(
+      header.zero_samples_offset + num_zero_samples * kWordSize, kAlignment);
+  return header;
+}
+
+/**
+ * Checks whether a header has been written for the given types of bit vector
+ * and select data structure and throws an exception otherwise.
+ *
+ * Besides the configuration, the sizes and offsets of the sections are checked
+ * against the ones that follow from the length and the number of ones, such
+ * that a corrupted header cannot lead to out-of-bounds accesses.
+ *
+ * @tparam BitVector The type of rank-combined bit vector to load.
+ * @tparam Select The type of select data structure to load.
+ * @param header The header to check.
+ */
+template <typename BitVector, typename Select>
+void check_header(const Header& header) {
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error("Not a Bitsy rank/select file.");
+  }
+
+  if (header.version != kVersion) {
+    throw std::runtime_error("Unsupported version of the file format.");
+  }
+
+  if (header.block_width != BitVector::kBlockWidth ||
+      header.block_header_width != BitVector::kBlockHeaderWidth ||
+      header.stride != Select::kStride ||
+      header.support_select0 != Select::kSupportSelect0 ||
+      header.support_select1 != Select::kSupportSelect1) {
+    throw std::runtime_error("The file stores a different configuration.");
+  }
+
+  if (header.num_ones > header.length) {
+    throw std::runtime_error("The file is corrupted.");
+  }
+
+  const std::size_t length = header.length;
+  const std::size_t num_ones = header.num_ones;
+  const std::size_t num_blocks =
+      math::div_ceil(length, BitVector::kBlockDataWidth) +
+      BitVector::kNumBlocksPerSuperblock / 2;
+  const Header expected = make_header<BitVector, Select>(
+      length, num_ones, num_blocks * BitVector::kNumWordsPerBlock,
+      math::div_ceil(length, BitVector::kSuperblockDataWidth),
+      Select::kSupportSelect0 ? (length - num_ones) / Select::kStride + 2 : 0,
+      Select::kSupportSelect1 ? num_ones / Select::kStride + 2 : 0);
+
+  // The header consists of integers only and thus contains no padding.
+  if (std::memcmp(&header, &expected, sizeof(Header)) != 0) {
+    throw std::runtime_error("The file is corrupted.");
+  }
+}
+
+/**
+ * A file that is closed when it is destructed.
+ */
+using File = std::unique_ptr<std::FILE, int (*)(std::FILE*)>;
+
+/**
+ * Opens a file and throws an exception if this fails.
+ *
+ * @param filename The name of the file to open.
+ * @param mode The mode in which to open the file as for std::fopen.
+ * @return The opened file.
+ */
+[[nodiscard]] inline File open(const std::string& filename,
+                               const char* mode) {
+  File file(std::fopen(filename.c_str(), mode), &std::fclose);
+  if (!file) {
+    throw std::runtime_error("Cannot open file " + filename + ".");
+  }
+
+  return file;
+}
+
+/**
+ * Writes raw bytes to a file and throws an exception if this fails.
+ *
+ * @param file The file to write to.
+ * @param data A pointer to the bytes to write.
+ * @param num_bytes The number of bytes to write.
+ */
+inline void write(std::FILE* file,
+                  const void* data,
+                  const std::size_t num_bytes) {
+  if (num_bytes > 0 && std::fwrite(data, 1, num_bytes, file) != num_bytes) {
+    throw std::runtime_error("Cannot write to file.");
+  }
+}
+
+/**
+ * Reads raw bytes from a file and throws an exception if this fails.
+ *
+ * @param file The file to read from.
+ * @param data A pointer to the memory to read into.
+ * @param num_bytes The number of bytes to read.
+ */
+inline void read(std::FILE* file, void* data, const std::size_t num_bytes) {
+  if (num_bytes > 0 && std::fread(data, 1, num_bytes, file) != num_bytes) {
+    throw std::runtime_error("Cannot read from file.");
+  }
+}
+
+/**
+ * Reads a section of words from a file into memory and throws an exception if
+ * this fails.
+ *
+ * @param file The file to read from.
+ * @param offset The offset in bytes of the section.
+ * @param num_words The number of words stored in the section.
+ * @return The words of the section.
+ */
+[[nodiscard]] inline StaticVector<std::uint64_t> read_section(
+    std::FILE* file,
+    const std::uint64_t offset,
+    const std::uint64_t num_words) {
+  StaticVector<std::uint64_t> section(num_words);
+
+  if (std::fseek(file, static_cast<long>(offset), SEEK_SET) != 0) {
+    throw std::runtime_error("Cannot seek in file.");
+  }
+
+  read(file, section.data(), num_words * sizeof(std::uint64_t));
+  return section;
+}
+
+/**
+ * Writes zeros to a file until its position is a multiple of the alignment.
+ *
+ * @param file The file to write to.
+ * @param offset The offset to which the position is to be advanced.
+ */
+inline void pad(std::FILE* file, const std::uint64_t offset) {
+  static constexpr char kZeros[kAlignment] = {};
+
+  const long position = std::ftell(file);
+  if (position < 0 || static_cast<std::uint64_t>(position) > offset) {
+    throw std::runtime_error("Cannot pad file.");
+  }
+
+  write(file, kZeros, offset - static_cast<std::uint64_t>(position));
+}
+
+/**
+ * A two-layer rank-combined bit vector and its two-layer select data structure
+ * that have been loaded from a file. As the select data structure refers to
+ * the bit vector, it is not movable and handed out indirectly.
+ *
+ * @tparam BitVector The type of rank-combined bit vector.
+ * @tparam Select The type of select data structure.
+ */
+template <typename BitVector = TwoLayerRankCombinedBitVector<>,
+          typename Select = TwoLayerSelect<BitVector>>
+struct RankSelect {
+  //! The bit vector with rank support.
+  BitVector bitvector;
+  //! The select data structure for the bit vector.
+  Select select;
+
+  /**
+   * Constructs a bit vector and its select data structure from their data.
+   *
+   * @param header The header of the file that the data has been read from.
+   * @param data The bits interleaved with the block headers.
+   * @param superblock_data The ranks of the superblocks.
+   * @param zero_samples The samples for zeros.
+   * @param one_samples The samples for ones.
+   */
+  RankSelect(const Header& header,
+             StaticVector<std::uint64_t>&& data,
+             StaticVector<std::uint64_t>&& superblock_data,
+             StaticVector<std::uint64_t>&& zero_samples,
+             StaticVector<std::uint64_t>&& one_samples)
+      : bitvector(header.length,
+                  header.num_ones,
+                  std::move(data),
+                  std::move(superblock_data)),
+        select(bitvector, std::move(zero_samples), std::move(one_samples)) {
+  }
+};
+
+/**
+ * Stores a two-layer rank-combined bit vector and its select data structure in
+ * a file. The rank information of the bit vector and the select data structure
+ * have to be up-to-date.
+ *
+ * @tparam BitVector The type of rank-combined bit vector to store.
+ * @tparam Select The type of select data structure to store.
+ * @param filename The name of the file to write.
+ * @param bitvector The bit vector to store.
+ * @param select The select data structure to store.
+ */
+template <typename BitVector, typename Select>
+void save(const std::string& filename,
+          const BitVector& bitvector,
+          const Select& select) {
+  constexpr std::size_t kWordSize = sizeof(std::uint64_t);
+
+  const auto zero_samples = select.zero_samples();
+  const auto one_samples = select.one_samples();
+  const Header header = make_header<BitVector, Select>(
+      bitvector.length(), bitvector.num_ones(), bitvector.num_words(),
+      bitvector.num_superblocks(), zero_samples.size(), one_samples.size());
+
+  const File file = open(filename, "wb");
+  write(file.get(), &header, sizeof(Header));
+
+  pad(file.get(), header.data_offset);
+  write(file.get(), bitvector.data(), header.num_data_words * kWordSize);
+
+  pad(file.get(), header.superblock_offset);
+  write(file.get(), bitvector.superblock_data(),
+        header.num_superblocks * kWordSize);
+
+  pad(file.get(), header.zero_samples_offset);
+  write(file.get(), zero_samples.data(), zero_samples.size() * kWordSize);
+
+  pad(file.get(), header.one_samples_offset);
+  write(file.get(), one_samples.data(), one_samples.size() * kWordSize);
+}
+
+/**
+ * Loads a two-layer rank-combined bit vector and its select data structure
+ * from a file, whose sections are read into memory.
+ *
+ * @tparam BitVector The type of rank-combined bit vector to load.
+ * @tparam Select The type of select data structure to load.
+ * @param filename The name of the file to read.
+ * @return The bit vector and select data structure.
+ */
+template <typename BitVector = TwoLayerRankCombinedBitVector<>,
+          typename Select = TwoLayerSelect<BitVector>>
+[[nodiscard]] std::unique_ptr<RankSelect<BitVector, Select>> load(
+    const std::string& filename) {
+  const File file = open(filename, "rb");
+
+  Header header;
+  read(file.get(), &header, sizeof(Header));
+  check_header<BitVector, Select>(header);
+
+  auto data =
+      read_section(file.get(), header.data_offset, header.num_data_words);
+  auto superblock_data = read_section(file.get(), header.superblock_offset,
+                                      header.num_superblocks);
+  auto zero_samples = read_section(file.get(), header.zero_samples_offset,
+                                   header.num_zero_samples);
+  auto one_samples = read_section(file.get(), header.one_samples_offset,
+                                  header.num_one_samples);
+
+  return std::make_unique<RankSelect<BitVector, Select>>(
+      header, std::move(data), std::move(superblock_data),
+      std::move(zero_samples), std::move(one_samples));
+}
+
+}  // namespace bitsy::serialization
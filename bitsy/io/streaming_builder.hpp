@@ -0,0 +1,329 @@
+/// A builder that writes a bit vector with rank and select support to a file
+/// while the bits are streamed in, using memory independent of the length.
+/// @file streaming_builder.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include "bitsy/io/serialization.hpp"
+#include "bitsy/rank/two_layer_rank_combined_bitvector.hpp"
+#include "bitsy/select/two_layer_select.hpp"
+#include "bitsy/util/math.hpp"
+
+namespace bitsy::serialization {
+
+/**
+ * A builder that writes a bit vector with rank and select support to a file
+ * while the bits are streamed in, using memory independent of the length.
+ *
+ * The builder keeps only the current superblock in memory. Once a superblock
+ * is complete, its words (including the block headers) are appended to the data
+ * section of the file and its rank as well as the samples that fall into it
+ * are appended to temporary files, since the superblock ranks and samples are
+ * stored after the data section. When the build is finished, the temporary
+ * files are copied into the file and the header is written. Thus, the peak
+ * memory of the builder is one superblock plus the state of the samples.
+ *
+ * The resulting file is identical to the one that is written when storing a
+ * bit vector and select data structure whose update() has been called, and can
+ * be loaded in the same way.
+ *
+ * @tparam BitVector The type of rank-combined bit vector to build.
+ * @tparam Select The type of select data structure to build.
+ */
+template <typename BitVector = TwoLayerRankCombinedBitVector<>,
+          typename Select = TwoLayerSelect<BitVector>>
+class StreamingBuilder {
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordWidth = sizeof(Word) * 8;
+
+  static constexpr std::size_t kBlockHeaderWidth = BitVector::kBlockHeaderWidth;
+  static constexpr std::size_t kBlockDataWidth = BitVector::kBlockDataWidth;
+  static constexpr std::size_t kNumWordsPerBlock = BitVector::kNumWordsPerBlock;
+  static constexpr std::size_t kNumBlocksPerSuperblock =
+      BitVector::kNumBlocksPerSuperblock;
+  static constexpr std::size_t kNumWordsPerSuperblock =
+      BitVector::kNumWordsPerSuperblock;
+  static constexpr std::size_t kSuperblockDataWidth =
+      BitVector::kSuperblockDataWidth;
+
+  static constexpr std::size_t kStride = Select::kStride;
+
+ public:
+  /**
+   * Constructs a builder that writes to a file.
+   *
+   * @param filename The name of the file to write.
+   */
+  explicit StreamingBuilder(const std::string& filename)
+      : _file(open(filename, "wb")),
+        _superblock_file(temporary()),
+        _zero_samples_file(temporary()),
+        _one_samples_file(temporary()),
+        _length(0),
+        _num_ones(0),
+        _cur_superblock_rank(0),
+        _num_zero_samples(0),
+        _num_one_samples(0),
+        _superblock{} {
+    // Reserve the space of the header, which is written once the sizes of the
+    // sections are known.
+    pad(_file.get(), math::round_to(sizeof(Header), kAlignment));
+
+    // The first occurence is always located in the first superblock.
+    append_sample(_zero_samples_file, _num_zero_samples, 0);
+    append_sample(_one_samples_file, _num_one_samples, 0);
+  }
+
+  // Create the default destructor.
+  ~StreamingBuilder() = default;
+
+  // Delete the move and copy constructor/assignment operator, as the builder
+  // is not intended to be moved or copied.
+  StreamingBuilder(StreamingBuilder&&) = delete;
+  StreamingBuilder& operator=(StreamingBuilder&&) = delete;
+  StreamingBuilder(StreamingBuilder const&) = delete;
+  StreamingBuilder& operator=(StreamingBuilder const&) = delete;
+
+  /**
+   * Appends a bit to the end of the bit vector.
+   *
+   * @param value Whether the bit is set.
+   */
+  inline void push_back(const bool value) {
+    append_word(static_cast<Word>(value), 1);
+  }
+
+  /**
+   * Appends the least significant bits of a word to the end of the bit vector,
+   * whereby the least significant bit is appended first.
+   *
+   * @param word The word whose bits are to be appended.
+   * @param num_bits The number of bits to append, which has to be at most 64.
+   */
+  void append_word(Word word, std::size_t num_bits) {
+    if (num_bits < kWordWidth) {
+      word &= math::setbits<Word>(num_bits);
+    }
+
+    while (num_bits > 0) {
+      const std::size_t block_pos = _length % kBlockDataWidth;
+      const std::size_t num_appended =
+          std::min(num_bits, kBlockDataWidth - block_pos);
+      const Word bits = (num_appended < kWordWidth)
+                            ? (word & math::setbits<Word>(num_appended))
+                            : word;
+
+      // Write the header of a block when its first bit is appended, which is
+      // the number of ones up to the block within the superblock.
+      const std::size_t num_local_block =
+          (_length % kSuperblockDataWidth) / kBlockDataWidth;
+      Word* const data = _superblock + num_local_block * kNumWordsPerBlock;
+      if (block_pos == 0) {
+        *data = _num_ones - _cur_superblock_rank;
+      }
+
+      const std::size_t data_pos = block_pos + kBlockHeaderWidth;
+      const std::size_t num_word = data_pos / kWordWidth;
+      const std::size_t word_pos = data_pos % kWordWidth;
+
+      data[num_word] |= bits << word_pos;
+      if (word_pos + num_appended > kWordWidth) {
+        data[num_word + 1] |= bits >> (kWordWidth - word_pos);
+      }
+
+      _length += num_appended;
+      _num_ones += static_cast<std::size_t>(std::popcount(bits));
+
+      if (_length % kSuperblockDataWidth == 0) {
+        finish_superblock(kNumWordsPerSuperblock);
+      }
+
+      word = (num_appended < kWordWidth) ? (word >> num_appended) : 0;
+      num_bits -= num_appended;
+    }
+  }
+
+  /**
+   * Appends a range of bits to the end of the bit vector.
+   *
+   * @tparam Iterator The type of iterator over values convertible to bool.
+   * @param begin An iterator to the first bit.
+   * @param end An iterator past the last bit.
+   */
+  template <typename Iterator>
+  void append(Iterator begin, const Iterator end) {
+    while (begin != end) {
+      push_back(static_cast<bool>(*begin));
+      ++begin;
+    }
+  }
+
+  /**
+   * Writes the remaining superblock, the padding blocks, the superblock ranks,
+   * the samples and the header. No more bits can be appended afterwards.
+   */
+  void finish() {
+    const std::size_t num_blocks = math::div_ceil(_length, kBlockDataWidth);
+    const std::size_t num_superblocks =
+        math::div_ceil(_length, kSuperblockDataWidth);
+
+    // Write the words of the blocks of the last superblock that has not been
+    // completed yet.
+    Word cur_block_rank = _num_ones - _cur_superblock_rank;
+    const std::size_t num_remaining_blocks =
+        num_blocks - (_length / kSuperblockDataWidth) * kNumBlocksPerSuperblock;
+    if (num_remaining_blocks > 0) {
+      finish_superblock(num_remaining_blocks * kNumWordsPerBlock);
+    }
+
+    // Write the padding blocks, whose headers are filled in the same way as
+    // the update of the bit vector does.
+    for (std::size_t num_block = num_blocks;
+         num_block < num_blocks + kNumBlocksPerSuperblock / 2; ++num_block) {
+      if (num_block % kNumBlocksPerSuperblock == 0) {
+        cur_block_rank = 0;
+      }
+
+      Word padding[kNumWordsPerBlock] = {cur_block_rank};
+      write(_file.get(), padding, sizeof(padding));
+    }
+
+    // Store one more sample so that the "next superblock" can be retrieved for
+    // a bit in the last superblock, as the select data structure does, which
+    // is the first superblock for an empty bit vector.
+    const Word last_superblock = std::max<std::size_t>(num_superblocks, 1) - 1;
+    append_sample(_zero_samples_file, _num_zero_samples, last_superblock);
+    append_sample(_one_samples_file, _num_one_samples, last_superblock);
+
+    const std::size_t num_words =
+        (num_blocks + kNumBlocksPerSuperblock / 2) * kNumWordsPerBlock;
+    const Header header = make_header<BitVector, Select>(
+        _length, _num_ones, num_words, num_superblocks,
+        Select::kSupportSelect0 ? _num_zero_samples : 0,
+        Select::kSupportSelect1 ? _num_one_samples : 0);
+
+    pad(_file.get(), header.superblock_offset);
+    copy(_superblock_file.get(), header.num_superblocks);
+
+    pad(_file.get(), header.zero_samples_offset);
+    copy(_zero_samples_file.get(), header.num_zero_samples);
+
+    pad(_file.get(), header.one_samples_offset);
+    copy(_one_samples_file.get(), header.num_one_samples);
+
+    if (std::fseek(_file.get(), 0, SEEK_SET) != 0) {
+      throw std::runtime_error("Cannot seek in file.");
+    }
+    write(_file.get(), &header, sizeof(Header));
+
+    if (std::fflush(_file.get()) != 0) {
+      throw std::runtime_error("Cannot write to file.");
+    }
+  }
+
+  /**
+   * Returns the number of bits that have been appended.
+   *
+   * @return The number of bits that have been appended.
+   */
+  [[nodiscard]] inline std::size_t length() const {
+    return _length;
+  }
+
+  /**
+   * Returns the number of bits set to one that have been appended.
+   *
+   * @return The number of bits set to one.
+   */
+  [[nodiscard]] inline std::size_t num_ones() const {
+    return _num_ones;
+  }
+
+ private:
+  [[nodiscard]] static File temporary() {
+    File file(std::tmpfile(), &std::fclose);
+    if (!file) {
+      throw std::runtime_error("Cannot create temporary file.");
+    }
+
+    return file;
+  }
+
+  static void append_sample(const File& file,
+                            std::size_t& num_samples,
+                            const Word sample) {
+    write(file.get(), &sample, sizeof(Word));
+    num_samples += 1;
+  }
+
+  /**
+   * Writes the words of the current superblock, stores its rank and the
+   * samples that fall into it, and starts the next superblock.
+   *
+   * @param num_words The number of words of the superblock to write.
+   */
+  void finish_superblock(const std::size_t num_words) {
+    write(_file.get(), _superblock, num_words * sizeof(Word));
+    write(_superblock_file.get(), &_cur_superblock_rank, sizeof(Word));
+
+    // The number of the superblock is stored for every k-th occurence of a bit
+    // up to the end of the superblock, as the select data structure does.
+    const Word num_superblock = (_length - 1) / kSuperblockDataWidth;
+    const std::size_t num_zeros = _length - _num_ones;
+    if constexpr (Select::kSupportSelect0) {
+      while (_num_zero_samples * kStride <= num_zeros) {
+        append_sample(_zero_samples_file, _num_zero_samples, num_superblock);
+      }
+    }
+    if constexpr (Select::kSupportSelect1) {
+      while (_num_one_samples * kStride <= _num_ones) {
+        append_sample(_one_samples_file, _num_one_samples, num_superblock);
+      }
+    }
+
+    _cur_superblock_rank = _num_ones;
+    std::fill_n(_superblock, kNumWordsPerSuperblock, 0);
+  }
+
+  /**
+   * Appends the words stored in a temporary file to the file.
+   *
+   * @param source The temporary file to copy.
+   * @param num_words The number of words stored in the temporary file.
+   */
+  void copy(std::FILE* source, std::size_t num_words) {
+    std::rewind(source);
+
+    while (num_words > 0) {
+      const std::size_t num_copied =
+          std::min(num_words, kNumWordsPerSuperblock);
+      read(source, _superblock, num_copied * sizeof(Word));
+      write(_file.get(), _superblock, num_copied * sizeof(Word));
+      num_words -= num_copied;
+    }
+  }
+
+  File _file;
+  File _superblock_file;
+  File _zero_samples_file;
+  File _one_samples_file;
+
+  std::size_t _length;
+  std::size_t _num_ones;
+  Word _cur_superblock_rank;
+
+  std::size_t _num_zero_samples;
+  std::size_t _num_one_samples;
+
+  Word _superblock[kNumWordsPerSuperblock];
+};
+
+}  // namespace bitsy::serialization
@@ -0,0 +1,463 @@
+/// A k²-tree that represents a sparse adjacency matrix compactly.
+/// @file k2_tree.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "bitsy/bitvector.hpp"
+#include "bitsy/rank/two_layer_rank_combined_bitvector.hpp"
+#include "bitsy/util/parallel.hpp"
+
+namespace bitsy {
+
+/**
+ * A k²-tree that represents a sparse adjacency matrix compactly, see Brisaboa
+ * et al. "k²-trees for compact web graph representation".
+ *
+ * The adjacency matrix is padded to a size of K^h x K^h and recursively split
+ * into K² submatrices of equal size, whereby a node of the tree stores for each
+ * of its K² submatrices one bit that states whether it contains an edge. Only
+ * the children of non-empty submatrices are stored. The bits of the inner
+ * levels are stored level by level in a bit vector with rank support, and the
+ * bits of the last level, which correspond to the cells of the matrix, in a
+ * separate bit vector. Thus, the children of the i-th set bit of the inner
+ * levels start at position (i + 1) * K², such that navigating to a child takes
+ * one rank query.
+ *
+ * @tparam K The arity of the tree, which has to be a power of two.
+ */
+template <std::size_t K = 2>
+class K2Tree {
+  static_assert(K >= 2 && std::has_single_bit(K),
+                "Arity has to be a power of two.");
+
+  static constexpr std::size_t kLogK = std::countr_zero(K);
+  //! The logarithm of the maximum number of rows of the padded matrix, such
+  //! that a path from the root fits into a word.
+  static constexpr std::size_t kMaxLogMatrixSize = 32;
+
+  using Key = std::uint64_t;
+
+ public:
+  //! The type of integer that represents a node.
+  using Node = std::uint64_t;
+  //! The type that represents an edge, i.e., a cell of the matrix.
+  using Edge = std::pair<Node, Node>;
+
+  //! The arity of the tree.
+  static constexpr std::size_t kArity = K;
+  //! The number of children of a node.
+  static constexpr std::size_t kNumChildren = K * K;
+
+  /**
+   * Constructs a k²-tree that represents the adjacency matrix of a graph.
+   *
+   * The edges are sorted by their paths from the root in parallel, and the bits
+   * of each level are written in parallel afterwards.
+   *
+   * @param num_nodes The number of nodes of the graph, whereby the size K^h of
+   * the padded matrix has to be at most 2^32 such that a path fits into a word.
+   * @param edges The edges of the graph, which may contain duplicates and whose
+   * sources and targets have to be less than the number of nodes.
+   * @param num_threads The number of threads to use.
+   * @throws std::invalid_argument If the size of the padded matrix exceeds
+   * 2^32.
+   */
+  explicit K2Tree(const std::size_t num_nodes,
+                  const std::span<const Edge> edges,
+                  const std::size_t num_threads = 1)
+      : _num_nodes(num_nodes),
+        _height(compute_height(num_nodes)),
+        _num_edges(0),
+        _tree(0),
+        _leaves(0) {
+    std::vector<Key> keys = sorted_keys(edges, num_threads);
+    _num_edges = keys.size();
+
+    // Count the number of non-empty submatrices per level, i.e., the number of
+    // distinct paths to the parents of the cells.
+    std::vector<std::size_t> num_parents(_height, 0);
+    for (std::size_t level = 0; level < _height; ++level) {
+      for (std::size_t i = 0; i < keys.size(); ++i) {
+        if (i == 0 || parent_key(keys[i], level) !=
+                          parent_key(keys[i - 1], level)) {
+          num_parents[level] += 1;
+        }
+      }
+    }
+
+    std::vector<std::size_t> level_offsets(_height + 1, 0);
+    for (std::size_t level = 0; level < _height; ++level) {
+      level_offsets[level + 1] =
+          level_offsets[level] + num_parents[level] * kNumChildren;
+    }
+
+    const std::size_t tree_length = level_offsets[_height - 1];
+    _tree = TwoLayerRankCombinedBitVector<>(tree_length, false);
+    _leaves = BitVector(level_offsets[_height] - tree_length, false);
+
+    // The levels are written concurrently and may share the words at their
+    // boundaries, thus we write the bits atomically.
+    parallel::for_each_range(
+        0, _height, num_threads,
+        [&](const std::size_t first_level, const std::size_t last_level) {
+          for (std::size_t level = first_level; level < last_level; ++level) {
+            std::size_t num_parent = 0;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+              if (i > 0 && parent_key(keys[i], level) !=
+                               parent_key(keys[i - 1], level)) {
+                num_parent += 1;
+              }
+
+              const std::size_t pos = level_offsets[level] +
+                                      num_parent * kNumChildren +
+                                      child_digit(keys[i], level);
+              if (pos < tree_length) {
+                _tree.atomic_set(pos);
+              } else {
+                _leaves.atomic_set(pos - tree_length);
+              }
+            }
+          }
+        });
+
+    _tree.update(num_threads);
+  }
+
+  // Create the default destructor.
+  ~K2Tree() = default;
+
+  // Create the default move constructor/move assignment operator.
+  K2Tree(K2Tree&&) noexcept = default;
+  K2Tree& operator=(K2Tree&&) noexcept = default;
+
+  // Delete the copy constructor/copy assignment operator as we do not intend
+  // to copy the data structure.
+  K2Tree(K2Tree const&) = delete;
+  K2Tree& operator=(K2Tree const&) = delete;
+
+  /**
+   * Returns whether the graph contains an edge.
+   *
+   * @param source The source of the edge, which has to be less than the number
+   * of nodes.
+   * @param target The target of the edge, which has to be less than the number
+   * of nodes.
+   * @return Whether the graph contains the edge.
+   */
+  [[nodiscard]] bool has_edge(const Node source, const Node target) const {
+    assert(source < _num_nodes && target < _num_nodes);
+    if (_num_edges == 0) {
+      return false;
+    }
+
+    const std::size_t tree_length = _tree.length();
+
+    std::size_t children = 0;
+    for (std::size_t level = 0; level < _height; ++level) {
+      const std::size_t shift = (_height - 1 - level) * kLogK;
+      const std::size_t pos = children + ((source >> shift) % K) * K +
+                              (target >> shift) % K;
+
+      if (pos >= tree_length) {
+        return _leaves.is_set(pos - tree_length);
+      }
+
+      if (!_tree.is_set(pos)) {
+        return false;
+      }
+
+      children = (_tree.rank1(pos) + 1) * kNumChildren;
+    }
+
+    return false;
+  }
+
+  /**
+   * Invokes a function for each edge whose source and target are within given
+   * ranges, whereby the edges are visited in order of their paths from the
+   * root.
+   *
+   * @tparam Function The type of function to invoke.
+   * @param first_source The first source of the range.
+   * @param last_source The (exclusive) last source of the range.
+   * @param first_target The first target of the range.
+   * @param last_target The (exclusive) last target of the range.
+   * @param function The function to invoke with the source and target.
+   */
+  template <typename Function>
+  void for_each_edge(const Node first_source,
+                     const Node last_source,
+                     const Node first_target,
+                     const Node last_target,
+                     Function&& function) const {
+    assert(last_source <= _num_nodes && last_target <= _num_nodes);
+    if (_num_edges == 0) {
+      return;
+    }
+
+    const Range range{first_source, last_source, first_target, last_target};
+    const std::size_t size = static_cast<std::size_t>(1)
+                             << ((_height - 1) * kLogK);
+    visit(0, size, 0, 0, range, function);
+  }
+
+  /**
+   * Returns the targets of the edges whose source is a given node in ascending
+   * order.
+   *
+   * @param source The source of the edges, which has to be less than the
+   * number of nodes.
+   * @return The targets of the edges.
+   */
+  [[nodiscard]] std::vector<Node> neighbors(const Node source) const {
+    assert(source < _num_nodes);
+    std::vector<Node> targets;
+    for_each_edge(source, source + 1, 0, _num_nodes,
+                  [&](Node, const Node target) { targets.push_back(target); });
+    return targets;
+  }
+
+  /**
+   * Returns the sources of the edges whose target is a given node in ascending
+   * order.
+   *
+   * @param target The target of the edges, which has to be less than the
+   * number of nodes.
+   * @return The sources of the edges.
+   */
+  [[nodiscard]] std::vector<Node> reverse_neighbors(const Node target) const {
+    assert(target < _num_nodes);
+    std::vector<Node> sources;
+    for_each_edge(0, _num_nodes, target, target + 1,
+                  [&](const Node source, Node) { sources.push_back(source); });
+    return sources;
+  }
+
+  /**
+   * Returns the number of nodes.
+   *
+   * @return The number of nodes.
+   */
+  [[nodiscard]] inline std::size_t num_nodes() const {
+    return _num_nodes;
+  }
+
+  /**
+   * Returns the number of (distinct) edges.
+   *
+   * @return The number of edges.
+   */
+  [[nodiscard]] inline std::size_t num_edges() const {
+    return _num_edges;
+  }
+
+  /**
+   * Returns the height of the tree.
+   *
+   * @return The height of the tree.
+   */
+  [[nodiscard]] inline std::size_t height() const {
+    return _height;
+  }
+
+  /**
+   * Returns the used memory space of this data structure in bits.
+   *
+   * Note that it only accounts for the memory that is stored on the heap, i.e.,
+   * the memory that depends on the number of edges.
+   *
+   * @return The used memory space of this data structure in bits.
+   */
+  [[nodiscard]] inline std::size_t memory_space() const {
+    return _tree.memory_space() + _leaves.memory_space();
+  }
+
+ private:
+  struct Range {
+    Node first_source;
+    Node last_source;
+    Node first_target;
+    Node last_target;
+  };
+
+  /**
+   * Returns the height of the tree, i.e., the smallest number h such that K^h
+   * is at least the number of nodes, and throws an exception if K^h exceeds
+   * 2^32.
+   *
+   * @param num_nodes The number of nodes.
+   * @return The height of the tree.
+   */
+  [[nodiscard]] static std::size_t compute_height(const std::size_t num_nodes) {
+    std::size_t height = 1;
+    while ((height + 1) * kLogK <= kMaxLogMatrixSize &&
+           (static_cast<std::size_t>(1) << (height * kLogK)) < num_nodes) {
+      height += 1;
+    }
+
+    if ((static_cast<std::size_t>(1) << (height * kLogK)) < num_nodes) {
+      throw std::invalid_argument(
+          "The padded matrix has to consist of at most 2^32 rows.");
+    }
+
+    return height;
+  }
+
+  /**
+   * Returns the key of an edge, which consists of the child digits on the path
+   * from the root to the cell of the edge, such that sorting the keys orders
+   * the cells level by level as they are stored.
+   *
+   * @param edge The edge.
+   * @return The key of the edge.
+   */
+  [[nodiscard]] Key edge_key(const Edge& edge) const {
+    assert(edge.first < _num_nodes && edge.second < _num_nodes);
+    Key key = 0;
+    for (std::size_t level = 0; level < _height; ++level) {
+      const std::size_t shift = (_height - 1 - level) * kLogK;
+      key = (key << (2 * kLogK)) | (((edge.first >> shift) % K) * K) |
+            ((edge.second >> shift) % K);
+    }
+
+    return key;
+  }
+
+  /**
+   * Returns the keys of the edges in sorted order without duplicates.
+   *
+   * Each thread computes and sorts the keys of a chunk of the edges, and the
+   * sorted chunks are merged afterwards.
+   *
+   * @param edges The edges.
+   * @param num_threads The number of threads to use.
+   * @return The sorted keys.
+   */
+  [[nodiscard]] std::vector<Key> sorted_keys(const std::span<const Edge> edges,
+                                             const std::size_t num_threads) {
+    std::vector<Key> keys(edges.size());
+    std::vector<std::size_t> chunk_ends;
+
+    const std::size_t num_chunks =
+        std::max<std::size_t>(1, std::min(num_threads, edges.size()));
+    for (std::size_t chunk = 0; chunk <= num_chunks; ++chunk) {
+      chunk_ends.push_back((edges.size() * chunk) / num_chunks);
+    }
+
+    parallel::for_each_thread(num_chunks, [&](const std::size_t chunk) {
+      for (std::size_t i = chunk_ends[chunk]; i < chunk_ends[chunk + 1]; ++i) {
+        keys[i] = edge_key(edges[i]);
+      }
+
+      std::sort(keys.begin() + chunk_ends[chunk],
+                keys.begin() + chunk_ends[chunk + 1]);
+    });
+
+    // Merge pairs of adjacent sorted chunks until a single chunk remains.
+    for (std::size_t step = 1; step < num_chunks; step *= 2) {
+      for (std::size_t chunk = 0; chunk + step < num_chunks;
+           chunk += 2 * step) {
+        const std::size_t last = std::min(chunk + 2 * step, num_chunks);
+        std::inplace_merge(keys.begin() + chunk_ends[chunk],
+                           keys.begin() + chunk_ends[chunk + step],
+                           keys.begin() + chunk_ends[last]);
+      }
+    }
+
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+  }
+
+  /**
+   * Returns the digit of the child on a level on the path to the cell of a key.
+   *
+   * @param key The key.
+   * @param level The level.
+   * @return The digit of the child, i.e., its index among its siblings.
+   */
+  [[nodiscard]] std::size_t child_digit(const Key key,
+                                        const std::size_t level) const {
+    const std::size_t shift = (_height - 1 - level) * 2 * kLogK;
+    return (key >> shift) % kNumChildren;
+  }
+
+  /**
+   * Returns the path to the parent of the child on a level on the path to the
+   * cell of a key.
+   *
+   * @param key The key.
+   * @param level The level.
+   * @return The path to the parent.
+   */
+  [[nodiscard]] Key parent_key(const Key key, const std::size_t level) const {
+    // The parent of the children on the first level is the root, whose path
+    // is empty. Otherwise, the shift is less than the width of a key.
+    const std::size_t shift = (_height - level) * 2 * kLogK;
+    return (level == 0) ? 0 : key >> shift;
+  }
+
+  /**
+   * Visits the children of a node whose submatrices intersect a range.
+   *
+   * @tparam Function The type of function to invoke.
+   * @param children The position of the first child of the node.
+   * @param size The size of the submatrices of the children.
+   * @param source The first source of the submatrix of the node.
+   * @param target The first target of the submatrix of the node.
+   * @param range The range to report edges for.
+   * @param function The function to invoke for each edge.
+   */
+  template <typename Function>
+  void visit(const std::size_t children,
+             const std::size_t size,
+             const Node source,
+             const Node target,
+             const Range& range,
+             Function& function) const {
+    const std::size_t tree_length = _tree.length();
+
+    for (std::size_t i = 0; i < K; ++i) {
+      const Node child_source = source + i * size;
+      if (child_source >= range.last_source ||
+          child_source + size <= range.first_source) {
+        continue;
+      }
+
+      for (std::size_t j = 0; j < K; ++j) {
+        const Node child_target = target + j * size;
+        if (child_target >= range.last_target ||
+            child_target + size <= range.first_target) {
+          continue;
+        }
+
+        const std::size_t pos = children + i * K + j;
+        if (pos >= tree_length) {
+          if (_leaves.is_set(pos - tree_length)) {
+            function(child_source, child_target);
+          }
+        } else if (_tree.is_set(pos)) {
+          visit((_tree.rank1(pos) + 1) * kNumChildren, size / K, child_source,
+                child_target, range, function);
+        }
+      }
+    }
+  }
+
+  std::size_t _num_nodes;
+  std::size_t _height;
+  std::size_t _num_edges;
+  TwoLayerRankCombinedBitVector<> _tree;
+  BitVector _leaves;
+};
+
+}  // namespace bitsy
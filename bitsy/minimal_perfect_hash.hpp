@@ -0,0 +1,361 @@
+/// A minimal perfect hash function that maps keys to consecutive integers using
+/// rank queries.
+/// @file minimal_perfect_hash.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "bitsy/bitvector.hpp"
+#include "bitsy/rank/two_layer_rank_combined_bitvector.hpp"
+#include "bitsy/util/math.hpp"
+#include "bitsy/util/parallel.hpp"
+
+namespace bitsy {
+
+/**
+ * A static minimal perfect hash function, which maps each of n distinct keys to
+ * a distinct integer in [0, n), see Limasset et al. "Fast and scalable minimal
+ * perfect hashing for massive key sets" (BBHash).
+ *
+ * The keys are hashed into a bit array of gamma * n bits, whereby the bits
+ * that are hit by exactly one key are set and the keys that collide are hashed
+ * into the next level, whose bit array is gamma times the number of colliding
+ * keys long, and so on. The few keys that remain after the last level are
+ * stored in a sorted fallback array. The bit arrays of all levels are stored
+ * consecutively in a bit vector with rank support, such that the integer of a
+ * key is the rank of the first set bit that it is hashed to. For the default
+ * gamma of two, a key is found on the first level with a probability of ~61%,
+ * and the data structure takes ~3.4 bits per key including the rank support.
+ *
+ * Keys of other types have to be hashed to 64-bit integers beforehand, such
+ * that the hashes are distinct.
+ *
+ * @tparam MaxNumLevels The maximum number of levels, after which the remaining
+ * keys are stored in the fallback array.
+ */
+template <std::size_t MaxNumLevels = 32>
+class MinimalPerfectHash {
+  static_assert(MaxNumLevels > 0, "There has to be at least one level.");
+
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordWidth = sizeof(Word) * 8;
+
+  using BitVector = TwoLayerRankCombinedBitVector<>;
+
+ public:
+  //! The type of key that is hashed.
+  using Key = std::uint64_t;
+
+  //! The maximum number of levels, after which the remaining keys are stored
+  //! in the fallback array.
+  static constexpr std::size_t kMaxNumLevels = MaxNumLevels;
+  //! The number of keys whose bits are prefetched at once by a bulk lookup.
+  static constexpr std::size_t kBatchSize = 32;
+
+  /**
+   * Constructs a minimal perfect hash function for a set of keys.
+   *
+   * @param keys The keys, which have to be distinct.
+   * @param gamma The ratio of the length of the bit array of each level to the
+   * number of keys that are hashed into it, which has to be at least one.
+   * Larger values make lookups and construction faster and use more space.
+   * @param num_threads The number of threads to use for the construction,
+   * which has to be at least one.
+   * @throws std::invalid_argument If the number of threads is zero.
+   */
+  explicit MinimalPerfectHash(const std::span<const Key> keys,
+                              const double gamma = 2.0,
+                              const std::size_t num_threads = 1)
+      : _num_keys(keys.size()), _bitvector(0) {
+    if (num_threads == 0) {
+      throw std::invalid_argument("The number of threads has to be positive.");
+    }
+
+    std::vector<Word> level_data;
+    std::vector<Key> remaining_keys;
+    std::span<const Key> level_keys = keys;
+
+    std::size_t offset = 0;
+    while (!level_keys.empty() && _levels.size() < kMaxNumLevels) {
+      const std::size_t min_length =
+          static_cast<std::size_t>(std::ceil(gamma * level_keys.size()));
+      const std::size_t length =
+          math::round_to(std::max<std::size_t>(1, min_length), kWordWidth);
+      const Level level = {offset, length, _levels.size()};
+
+      // Mark the positions that are hit by a key and, if they have been hit
+      // before, as a collision.
+      bitsy::BitVector hits(length, false);
+      bitsy::BitVector collisions(length, false);
+      parallel::for_each_range(
+          0, level_keys.size(), num_threads,
+          [&](const std::size_t first, const std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+              const std::size_t pos = level.local_pos(level_keys[i]);
+              if (hits.atomic_test_and_set(pos)) {
+                collisions.atomic_set(pos);
+              }
+            }
+          });
+
+      // The keys that collide are hashed into the next level, whereby each
+      // thread collects its keys separately and in order.
+      std::vector<std::vector<Key>> thread_keys(num_threads);
+      parallel::for_each_thread(num_threads, [&](const std::size_t thread) {
+        const std::size_t first = (level_keys.size() * thread) / num_threads;
+        const std::size_t last =
+            (level_keys.size() * (thread + 1)) / num_threads;
+
+        for (std::size_t i = first; i < last; ++i) {
+          if (collisions.is_set(level.local_pos(level_keys[i]))) {
+            thread_keys[thread].push_back(level_keys[i]);
+          }
+        }
+      });
+
+      for (std::size_t num_word = 0; num_word < length / kWordWidth;
+           ++num_word) {
+        level_data.push_back(hits.data()[num_word] &
+                             ~collisions.data()[num_word]);
+      }
+
+      std::vector<Key> next_keys;
+      for (const std::vector<Key>& keys_of_thread : thread_keys) {
+        next_keys.insert(next_keys.end(), keys_of_thread.begin(),
+                         keys_of_thread.end());
+      }
+
+      remaining_keys = std::move(next_keys);
+      level_keys = remaining_keys;
+
+      _levels.push_back(level);
+      offset += length;
+    }
+
+    // Copy the bits of all levels into the bit vector with rank support, such
+    // that each thread writes the bits of different blocks.
+    _bitvector = BitVector(offset);
+    const std::size_t num_blocks = math::div_ceil(offset, kBlockDataWidth);
+    parallel::for_each_range(
+        0, num_blocks, num_threads,
+        [&](const std::size_t first_block, const std::size_t last_block) {
+          const std::size_t first = first_block * kBlockDataWidth;
+          const std::size_t last =
+              std::min(offset, last_block * kBlockDataWidth);
+
+          for (std::size_t pos = first; pos < last; ++pos) {
+            const Word word = level_data[pos / kWordWidth];
+            _bitvector.set(pos, ((word >> (pos % kWordWidth)) & 1) == 1);
+          }
+        });
+    _bitvector.update(num_threads);
+
+    _fallback_keys = std::move(remaining_keys);
+    std::sort(_fallback_keys.begin(), _fallback_keys.end());
+  }
+
+  // Create the default destructor.
+  ~MinimalPerfectHash() = default;
+
+  // Create the default move constructor/move assignment operator.
+  MinimalPerfectHash(MinimalPerfectHash&&) noexcept = default;
+  MinimalPerfectHash& operator=(MinimalPerfectHash&&) noexcept = default;
+
+  // Delete the copy constructor/copy assignment operator as we do not intend
+  // to copy the hash function.
+  MinimalPerfectHash(MinimalPerfectHash const&) = delete;
+  MinimalPerfectHash& operator=(MinimalPerfectHash const&) = delete;
+
+  /**
+   * Returns the integer of a key. If the key is not one of the keys for which
+   * this hash function has been constructed, an arbitrary integer is returned.
+   *
+   * @param key The key.
+   * @return The integer of the key, which is less than the number of keys.
+   */
+  [[nodiscard]] inline std::size_t lookup(const Key key) const {
+    return lookup_from(key, 0);
+  }
+
+  /**
+   * Computes the integers of multiple keys.
+   *
+   * The keys are processed in batches, whereby the blocks of the bit vector to
+   * which the keys of a batch are hashed on the first level are prefetched
+   * before any of them is queried, such that the cache misses overlap.
+   *
+   * @param keys The keys.
+   * @param out A pointer to the array, which has to hold at least as many
+   * integers as there are keys.
+   */
+  void lookup(const std::span<const Key> keys, std::size_t* const out) const {
+    if (_levels.empty()) {
+      std::fill_n(out, keys.size(), 0);
+      return;
+    }
+
+    const Level& first_level = _levels.front();
+    std::size_t positions[kBatchSize];
+
+    for (std::size_t first = 0; first < keys.size(); first += kBatchSize) {
+      const std::size_t batch_size = std::min(kBatchSize, keys.size() - first);
+
+      for (std::size_t i = 0; i < batch_size; ++i) {
+        positions[i] = first_level.pos(keys[first + i]);
+
+        const std::size_t num_block = positions[i] / kBlockDataWidth;
+        __builtin_prefetch(_bitvector.data() +
+                           num_block * BitVector::kNumWordsPerBlock);
+      }
+
+      for (std::size_t i = 0; i < batch_size; ++i) {
+        const std::size_t pos = positions[i];
+        out[first + i] = _bitvector.is_set(pos)
+                             ? _bitvector.rank1(pos)
+                             : lookup_from(keys[first + i], 1);
+      }
+    }
+  }
+
+  /**
+   * Returns the number of keys.
+   *
+   * @return The number of keys.
+   */
+  [[nodiscard]] inline std::size_t num_keys() const {
+    return _num_keys;
+  }
+
+  /**
+   * Returns the number of levels.
+   *
+   * @return The number of levels.
+   */
+  [[nodiscard]] inline std::size_t num_levels() const {
+    return _levels.size();
+  }
+
+  /**
+   * Returns the number of keys that are stored in the fallback array, as they
+   * collide on all levels.
+   *
+   * @return The number of keys that are stored in the fallback array.
+   */
+  [[nodiscard]] inline std::size_t num_fallback_keys() const {
+    return _fallback_keys.size();
+  }
+
+  /**
+   * Returns the used memory space of this hash function in bits.
+   *
+   * Note that it only accounts for the memory that is stored on the heap, i.e.,
+   * the memory that depends on the number of keys.
+   *
+   * @return The used memory space of this hash function in bits.
+   */
+  [[nodiscard]] inline std::size_t memory_space() const {
+    return _bitvector.memory_space() + _levels.size() * sizeof(Level) * 8 +
+           _fallback_keys.size() * sizeof(Key) * 8;
+  }
+
+ private:
+  static constexpr std::size_t kBlockDataWidth = BitVector::kBlockDataWidth;
+
+  /**
+   * The bit array of a level within the bit vector.
+   */
+  struct Level {
+    //! The position of the first bit of the level.
+    std::size_t offset;
+    //! The number of bits of the level.
+    std::size_t length;
+    //! The seed with which the keys are hashed on this level.
+    std::size_t seed;
+
+    /**
+     * Returns the position within the level to which a key is hashed.
+     *
+     * @param key The key.
+     * @return The position within the level to which the key is hashed.
+     */
+    [[nodiscard]] inline std::size_t local_pos(const Key key) const {
+      // Map the hash onto the level by a multiplication instead of a modulo
+      // operation, which is considerably faster.
+      return static_cast<std::size_t>(
+          math::mul_high(hash(key, seed), static_cast<std::uint64_t>(length)));
+    }
+
+    /**
+     * Returns the position within the bit vector to which a key is hashed.
+     *
+     * @param key The key.
+     * @return The position within the bit vector to which the key is hashed.
+     */
+    [[nodiscard]] inline std::size_t pos(const Key key) const {
+      return offset + local_pos(key);
+    }
+  };
+
+  /**
+   * Returns a hash of a key, which is the finalizer of MurmurHash3 applied to
+   * the key mixed with a seed.
+   *
+   * @param key The key.
+   * @param seed The seed.
+   * @return The hash of the key.
+   */
+  [[nodiscard]] static inline Word hash(const Key key, const std::size_t seed) {
+    Word x = key ^ ((seed + 1) * 0x9E3779B97F4A7C15);
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCD;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53;
+    x ^= x >> 33;
+    return x;
+  }
+
+  /**
+   * Returns the integer of a key, whereby the first levels are skipped.
+   *
+   * @param key The key.
+   * @param first_level The first level to which the key is hashed.
+   * @return The integer of the key.
+   */
+  [[nodiscard]] std::size_t lookup_from(const Key key,
+                                        const std::size_t first_level) const {
+    for (std::size_t num_level = first_level; num_level < _levels.size();
+         ++num_level) {
+      const std::size_t pos = _levels[num_level].pos(key);
+      if (_bitvector.is_set(pos)) {
+        return _bitvector.rank1(pos);
+      }
+    }
+
+    if (_fallback_keys.empty()) {
+      return 0;
+    }
+
+    // The keys in the fallback array are numbered after the keys that are
+    // stored in the levels.
+    const auto it =
+        std::lower_bound(_fallback_keys.begin(), _fallback_keys.end(), key);
+    const std::size_t index = std::min<std::size_t>(
+        it - _fallback_keys.begin(), _fallback_keys.size() - 1);
+    return _num_keys - _fallback_keys.size() + index;
+  }
+
+  std::size_t _num_keys;
+  std::vector<Level> _levels;
+  BitVector _bitvector;
+  std::vector<Key> _fallback_keys;
+};
+
+}  // namespace bitsy
@@ -0,0 +1,191 @@
+/// A writer that allows multiple threads to set the bits of a bit vector
+/// concurrently without atomic operations.
+/// @file partitioned_writer.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "bitsy/type_traits.hpp"
+#include "bitsy/util/math.hpp"
+#include "bitsy/util/parallel.hpp"
+
+namespace bitsy {
+
+/**
+ * A writer that allows multiple threads to set the bits of a bit vector
+ * concurrently without atomic operations.
+ *
+ * The bit vector is split into as many consecutive partitions as there are
+ * threads, whereby each partition consists of whole words (or whole blocks for
+ * bit vectors that group their bits into blocks). Thus, two threads never
+ * write to the same word as long as each thread only writes to its own
+ * partition. Writes of a thread to its own partition, which is the common case
+ * if the positions of a thread are (mostly) local, are applied immediately.
+ * Writes to a foreign partition are buffered instead and applied by the owning
+ * thread during a flush, once all threads have finished writing.
+ *
+ * A thread must only ever use its own number when calling set() and flush(),
+ * and there has to be a barrier between the last call to set() of any thread
+ * and the first call to flush().
+ *
+ * @tparam BitVector The type of bit vector to write to.
+ */
+template <type_traits::BitVector BitVector>
+class PartitionedWriter {
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordWidth = sizeof(Word) * 8;
+
+  // The number of bits that are always stored in distinct words from the bits
+  // of other units, i.e., the granularity at which the bits are partitioned.
+  static constexpr std::size_t kUnitWidth = [] {
+    if constexpr (requires { BitVector::kBlockDataWidth; }) {
+      return BitVector::kBlockDataWidth;
+    } else {
+      return kWordWidth;
+    }
+  }();
+
+ public:
+  /**
+   * Constructs a new writer for a bit vector.
+   *
+   * @param bitvector The bit vector to write to.
+   * @param num_threads The number of threads that write to the bit vector,
+   * which has to be at least one.
+   * @throws std::invalid_argument If the number of threads is zero.
+   */
+  explicit PartitionedWriter(BitVector& bitvector,
+                             const std::size_t num_threads)
+      : _bitvector(bitvector),
+        _num_threads(num_threads),
+        _partition_width(partition_width(bitvector.length(), num_threads)),
+        _buffers(num_threads * num_threads) {
+  }
+
+  // Create the default destructor.
+  ~PartitionedWriter() = default;
+
+  // Delete the move and copy constructor/assignment operator, as the writer is
+  // shared among threads and is not intended to be moved or copied.
+  PartitionedWriter(PartitionedWriter&&) = delete;
+  PartitionedWriter& operator=(PartitionedWriter&&) = delete;
+  PartitionedWriter(PartitionedWriter const&) = delete;
+  PartitionedWriter& operator=(PartitionedWriter const&) = delete;
+
+  /**
+   * Returns the number of the thread that owns the partition containing a bit.
+   *
+   * @param pos The position of the bit.
+   * @return The number of the thread that owns the partition.
+   */
+  [[nodiscard]] inline std::size_t owner(const std::size_t pos) const {
+    return pos / _partition_width;
+  }
+
+  /**
+   * Sets a bit within the bit vector depending on a boolean value.
+   *
+   * @param thread The number of the thread that is writing.
+   * @param pos The position of the bit that is to be set.
+   * @param value Whether to set the bit.
+   */
+  inline void set(const std::size_t thread,
+                  const std::size_t pos,
+                  const bool value = true) {
+    const std::size_t num_partition = owner(pos);
+
+    if (num_partition == thread) [[likely]] {
+      _bitvector.set(pos, value);
+    } else {
+      // Pack the value into the least significant bit of the buffered write,
+      // which leaves 63 bits for the position.
+      buffer(thread, num_partition).push_back((pos << 1) | value);
+    }
+  }
+
+  /**
+   * Applies all writes of all threads to the partition of a thread that have
+   * been buffered.
+   *
+   * @param thread The number of the thread whose partition to flush.
+   */
+  void flush(const std::size_t thread) {
+    for (std::size_t source = 0; source < _num_threads; ++source) {
+      std::vector<Word>& writes = buffer(source, thread);
+
+      for (const Word write : writes) {
+        _bitvector.set(write >> 1, (write & 1) == 1);
+      }
+
+      writes.clear();
+    }
+  }
+
+ private:
+  [[nodiscard]] static std::size_t partition_width(
+      const std::size_t length,
+      const std::size_t num_threads) {
+    if (num_threads == 0) {
+      throw std::invalid_argument("The number of threads has to be positive.");
+    }
+
+    const std::size_t num_units = math::div_ceil(length, kUnitWidth);
+    const std::size_t num_units_per_partition =
+        std::max<std::size_t>(1, math::div_ceil(num_units, num_threads));
+    return num_units_per_partition * kUnitWidth;
+  }
+
+  [[nodiscard]] inline std::vector<Word>& buffer(const std::size_t source,
+                                                 const std::size_t target) {
+    return _buffers[source * _num_threads + target];
+  }
+
+  BitVector& _bitvector;
+  std::size_t _num_threads;
+  std::size_t _partition_width;
+  std::vector<std::vector<Word>> _buffers;
+};
+
+/**
+ * Sets the bits at given positions within a bit vector to one in parallel.
+ *
+ * Each thread is assigned a consecutive range of the positions, whose bits are
+ * written using a partitioned writer, such that no atomic operations are
+ * required.
+ *
+ * @tparam BitVector The type of bit vector to write to.
+ * @param bitvector The bit vector to write to.
+ * @param positions The positions of the bits that are to be set to one.
+ * @param num_threads The number of threads to use, which has to be at least
+ * one.
+ * @throws std::invalid_argument If the number of threads is zero.
+ */
+template <type_traits::BitVector BitVector>
+void parallel_set(BitVector& bitvector,
+                  const std::span<const std::size_t> positions,
+                  const std::size_t num_threads) {
+  PartitionedWriter<BitVector> writer(bitvector, num_threads);
+
+  parallel::for_each_thread(num_threads, [&](const std::size_t thread) {
+    const std::size_t begin = (positions.size() * thread) / num_threads;
+    const std::size_t end = (positions.size() * (thread + 1)) / num_threads;
+
+    for (std::size_t i = begin; i < end; ++i) {
+      writer.set(thread, positions[i]);
+    }
+  });
+
+  // Joining the threads above acts as the barrier that is required before the
+  // buffered writes can be flushed.
+  parallel::for_each_thread(num_threads, [&](const std::size_t thread) {
+    writer.flush(thread);
+  });
+}
+
+}  // namespace bitsy
@@ -0,0 +1,771 @@
+/// An approximate membership filter that supports deletions and resizing,
+/// which locates the runs of remainders using rank and select on words.
+/// @file quotient_filter.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include "bitsy/select/word_select.hpp"
+#include "bitsy/util/math.hpp"
+#include "bitsy/util/static_vector.hpp"
+
+namespace bitsy {
+
+/**
+ * A rank-and-select quotient filter (RSQF), which is an approximate membership
+ * filter that supports insertions, deletions, counting and resizing, see Pandey
+ * et al. "A general-purpose counting filter: Making every bit count".
+ *
+ * Each key is hashed to a fingerprint whose upper bits are the quotient, which
+ * is the home slot of the key, and whose lower bits are the remainder, which is
+ * stored in a slot. The remainders of a quotient are stored consecutively as a
+ * run, which starts at the home slot or, if it is used by other runs, after the
+ * previous run. For each slot, the filter stores whether it is the home slot of
+ * a run (occupieds) and whether it is the last slot of a run (runends), such
+ * that the end of the run of a quotient is the position of the runend whose
+ * rank equals the rank of the quotient within the occupieds.
+ *
+ * The slots are grouped into blocks of 64 slots, whereby a block stores the
+ * occupieds and runends of its slots in a word each, its remainders, and the
+ * number of its slots that are used by runs of earlier blocks (offset). Thus,
+ * the end of a run is found using a rank query on a word of occupieds and a
+ * select query on the words of runends that follow the offset, which mostly
+ * touches a single block.
+ *
+ * Note that the false positive rate is about the load factor divided by
+ * 2^RemainderWidth, and that each resize moves one bit of the remainder into
+ * the quotient, which doubles the false positive rate.
+ *
+ * @tparam Remainder The type of integer that stores a remainder.
+ */
+template <std::unsigned_integral Remainder = std::uint8_t>
+class QuotientFilter {
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordWidth = sizeof(Word) * 8;
+
+ public:
+  //! The type of key that is inserted.
+  using Key = std::uint64_t;
+
+  //! The number of slots per block.
+  static constexpr std::size_t kNumSlotsPerBlock = kWordWidth;
+  //! The maximum width in bits of a remainder.
+  static constexpr std::size_t kMaxRemainderWidth = sizeof(Remainder) * 8;
+  //! The load factor above which the filter is resized by an insertion.
+  static constexpr double kMaxLoadFactor = 0.95;
+  //! The number of keys whose blocks are prefetched at once by a bulk
+  //! operation.
+  static constexpr std::size_t kBatchSize = 32;
+
+  /**
+   * Constructs an empty filter.
+   *
+   * @param quotient_width The width in bits of a quotient, i.e., the filter has
+   * 2^quotient_width slots, which has to be at least six.
+   * @param remainder_width The width in bits of a remainder, which has to be
+   * at least one and at most the width of a remainder type, such that the
+   * widths of the quotient and remainder sum up to at most 64.
+   * @throws std::invalid_argument If the widths violate these bounds.
+   */
+  explicit QuotientFilter(
+      const std::size_t quotient_width,
+      const std::size_t remainder_width = kMaxRemainderWidth)
+      : _quotient_width(check_widths(quotient_width, remainder_width)),
+        _remainder_width(remainder_width),
+        _num_home_slots(math::pow2<std::size_t>(quotient_width)),
+        // Store additional blocks such that the runs of the last home slots
+        // can overflow past them.
+        _blocks(_num_home_slots / kNumSlotsPerBlock +
+                std::max<std::size_t>(4, _num_home_slots / kOverflowRatio)),
+        _num_slots(_blocks.size() * kNumSlotsPerBlock),
+        _num_elements(0) {
+    std::fill_n(_blocks.data(), _blocks.size(), Block{});
+  }
+
+  // Create the default destructor.
+  ~QuotientFilter() = default;
+
+  // Create the default move constructor/move assignment operator.
+  QuotientFilter(QuotientFilter&&) noexcept = default;
+  QuotientFilter& operator=(QuotientFilter&&) noexcept = default;
+
+  // Delete the copy constructor/copy assignment operator as we do not intend
+  // to copy the filter.
+  QuotientFilter(QuotientFilter const&) = delete;
+  QuotientFilter& operator=(QuotientFilter const&) = delete;
+
+  /**
+   * Inserts a key into this filter. If the key is already contained, another
+   * copy is inserted. If the load factor becomes too large or a run overflows
+   * past the last slot, the filter is resized.
+   *
+   * @param key The key to insert.
+   * @return Whether the key has been inserted, which fails only if the filter
+   * is full and the remainder cannot be shortened further.
+   */
+  bool insert(const Key key) {
+    return insert_hash(hash(key));
+  }
+
+  /**
+   * Inserts multiple keys into this filter.
+   *
+   * The keys are processed in batches, whereby the blocks of the home slots of
+   * the keys of a batch are prefetched before any of them is inserted, such
+   * that the cache misses overlap.
+   *
+   * @param keys The keys to insert.
+   * @return Whether all keys have been inserted.
+   */
+  bool insert(const std::span<const Key> keys) {
+    bool inserted = true;
+
+    Word hashes[kBatchSize];
+    for (std::size_t first = 0; first < keys.size(); first += kBatchSize) {
+      const std::size_t batch_size = std::min(kBatchSize, keys.size() - first);
+      prefetch(keys.subspan(first, batch_size), hashes);
+
+      for (std::size_t i = 0; i < batch_size; ++i) {
+        inserted &= insert_hash(hashes[i]);
+      }
+    }
+
+    return inserted;
+  }
+
+  /**
+   * Returns whether a key is contained in this filter, whereby false positives
+   * are possible but false negatives are not.
+   *
+   * @param key The key.
+   * @return Whether the key is (probably) contained in this filter.
+   */
+  [[nodiscard]] bool contains(const Key key) const {
+    const Word hash_value = hash(key);
+    return find(quotient(hash_value), remainder(hash_value)) != kNotFound;
+  }
+
+  /**
+   * Computes for multiple keys whether they are contained in this filter.
+   *
+   * The keys are processed in batches, whereby the blocks of the home slots of
+   * the keys of a batch are prefetched before any of them is queried, such
+   * that the cache misses overlap.
+   *
+   * @param keys The keys.
+   * @param out A pointer to the array, which has to hold at least as many
+   * booleans as there are keys.
+   */
+  void contains(const std::span<const Key> keys, bool* const out) const {
+    Word hashes[kBatchSize];
+    for (std::size_t first = 0; first < keys.size(); first += kBatchSize) {
+      const std::size_t batch_size = std::min(kBatchSize, keys.size() - first);
+      prefetch(keys.subspan(first, batch_size), hashes);
+
+      for (std::size_t i = 0; i < batch_size; ++i) {
+        out[first + i] =
+            find(quotient(hashes[i]), remainder(hashes[i])) != kNotFound;
+      }
+    }
+  }
+
+  /**
+   * Returns how often a key has been inserted into this filter, whereby the
+   * count can be too large due to false positives but not too small.
+   *
+   * @param key The key.
+   * @return How often the key has (probably) been inserted.
+   */
+  [[nodiscard]] std::size_t count(const Key key) const {
+    const Word hash_value = hash(key);
+    const std::size_t home_slot = quotient(hash_value);
+    const Remainder rem = remainder(hash_value);
+    if (!is_occupied(home_slot)) {
+      return 0;
+    }
+
+    std::size_t count = 0;
+    for_each_run_slot(home_slot, [&](const std::size_t slot) {
+      count += (remainder_at(slot) == rem) ? 1 : 0;
+      return false;
+    });
+
+    return count;
+  }
+
+  /**
+   * Removes one copy of a key from this filter. Note that only keys that have
+   * been inserted must be removed, as otherwise the copy of another key with
+   * the same fingerprint may be removed.
+   *
+   * @param key The key to remove.
+   * @return Whether a copy of the key has been found and removed.
+   */
+  bool erase(const Key key) {
+    const Word hash_value = hash(key);
+    const std::size_t home_slot = quotient(hash_value);
+    const std::size_t slot = find(home_slot, remainder(hash_value));
+    if (slot == kNotFound) {
+      return false;
+    }
+
+    const std::size_t run_end = end(home_slot) - 1;
+    const bool is_single = slot == run_end &&
+                           (slot == home_slot || is_runend(slot - 1));
+
+    // Remove the remainder from its run, which leaves a hole at the end of the
+    // run.
+    std::size_t hole;
+    if (is_single) {
+      set_occupied(home_slot, false);
+      set_runend(slot, false);
+      hole = slot;
+    } else {
+      for (std::size_t pos = slot; pos < run_end; ++pos) {
+        remainder_at(pos) = remainder_at(pos + 1);
+      }
+
+      set_runend(run_end, false);
+      set_runend(run_end - 1, true);
+      hole = run_end;
+    }
+
+    // The following runs of the cluster are shifted by one slot to the left,
+    // until a run starts at its home slot and cannot be shifted.
+    std::size_t cur_quotient = home_slot;
+    while (true) {
+      const std::size_t next_quotient = next_occupied(cur_quotient + 1, hole);
+      if (next_quotient == kNotFound) {
+        break;
+      }
+
+      const std::size_t next_run_end = next_runend(hole + 1);
+      for (std::size_t pos = hole; pos < next_run_end; ++pos) {
+        remainder_at(pos) = remainder_at(pos + 1);
+      }
+
+      set_runend(next_run_end, false);
+      set_runend(next_run_end - 1, true);
+      cur_quotient = next_quotient;
+      hole = next_run_end;
+    }
+
+    // The blocks that start after the home slot and within the shifted slots
+    // are used by one slot less by runs of earlier blocks.
+    for (std::size_t num_block = home_slot / kNumSlotsPerBlock + 1;
+         num_block * kNumSlotsPerBlock <= hole; ++num_block) {
+      Block& block = _blocks[num_block];
+      block.offset -= (block.offset > 0) ? 1 : 0;
+    }
+
+    _num_elements -= 1;
+    return true;
+  }
+
+  /**
+   * Doubles the number of slots of this filter, whereby the first bit of each
+   * remainder becomes the last bit of its quotient. If the runs of the resized
+   * filter overflow past its last slot, the number of slots is doubled again.
+   *
+   * @return Whether the filter has been resized, which fails only if the
+   * remainder cannot be shortened further.
+   */
+  bool resize() {
+    std::size_t quotient_width = _quotient_width;
+    std::size_t remainder_width = _remainder_width;
+    while (remainder_width > 1) {
+      quotient_width += 1;
+      remainder_width -= 1;
+      const Word remainder_mask = math::setbits<Word>(remainder_width);
+
+      // The fingerprints are visited in increasing order, such that each of
+      // them is appended to the last cluster of the new filter.
+      QuotientFilter filter(quotient_width, remainder_width);
+      bool inserted = true;
+      for_each_fingerprint([&](const Word fingerprint) {
+        inserted = inserted &&
+                   filter.insert_fingerprint(fingerprint >> remainder_width,
+                                             fingerprint & remainder_mask);
+      });
+
+      if (inserted) {
+        *this = std::move(filter);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * Returns the number of elements of this filter, including the copies.
+   *
+   * @return The number of elements of this filter.
+   */
+  [[nodiscard]] inline std::size_t num_elements() const {
+    return _num_elements;
+  }
+
+  /**
+   * Returns the number of home slots, i.e., 2^quotient_width.
+   *
+   * @return The number of home slots.
+   */
+  [[nodiscard]] inline std::size_t num_home_slots() const {
+    return _num_home_slots;
+  }
+
+  /**
+   * Returns the width in bits of a quotient.
+   *
+   * @return The width in bits of a quotient.
+   */
+  [[nodiscard]] inline std::size_t quotient_width() const {
+    return _quotient_width;
+  }
+
+  /**
+   * Returns the width in bits of a remainder.
+   *
+   * @return The width in bits of a remainder.
+   */
+  [[nodiscard]] inline std::size_t remainder_width() const {
+    return _remainder_width;
+  }
+
+  /**
+   * Returns the used memory space of this filter in bits.
+   *
+   * Note that it only accounts for the memory that is stored on the heap, i.e.,
+   * the memory that depends on the number of slots.
+   *
+   * @return The used memory space of this filter in bits.
+   */
+  [[nodiscard]] inline std::size_t memory_space() const {
+    return _blocks.size() * sizeof(Block) * 8;
+  }
+
+ private:
+  //! The ratio of home slots to additional blocks.
+  static constexpr std::size_t kOverflowRatio = 32 * kNumSlotsPerBlock;
+
+  //! The position that is returned if a slot is not found.
+  static constexpr std::size_t kNotFound = static_cast<std::size_t>(-1);
+
+  /**
+   * A block of 64 slots.
+   *
+   * Note that a block is not the size of a cache line: for 8-bit remainders,
+   * the remainders alone fill 64 bytes, such that a block takes 88 bytes. The
+   * blocks are packed rather than aligned to cache lines, as padding them to
+   * 128 bytes would increase the space of the filter by almost half.
+   */
+  struct Block {
+    //! Whether each slot is the home slot of a run.
+    Word occupieds;
+    //! Whether each slot is the last slot of a run.
+    Word runends;
+    //! The number of slots of this block that are used by runs of quotients
+    //! of earlier blocks.
+    std::uint32_t offset;
+    //! The remainders that are stored in the slots.
+    Remainder remainders[kNumSlotsPerBlock];
+  };
+
+  /**
+   * Checks the widths of a quotient and a remainder and throws an exception if
+   * they are out of bounds.
+   *
+   * With fewer than 64 home slots, no block would consist of home slots only,
+   * such that a resize would not visit any fingerprint, and with more than 64
+   * bits, a fingerprint would not fit into a hash.
+   *
+   * @param quotient_width The width in bits of a quotient.
+   * @param remainder_width The width in bits of a remainder.
+   * @return The width in bits of the quotient.
+   */
+  [[nodiscard]] static std::size_t check_widths(
+      const std::size_t quotient_width,
+      const std::size_t remainder_width) {
+    if (quotient_width < 6) {
+      throw std::invalid_argument("Quotient has to be at least 6 bits wide.");
+    }
+
+    if (remainder_width < 1 || remainder_width > kMaxRemainderWidth) {
+      throw std::invalid_argument(
+          "Remainder has to fit into the remainder type.");
+    }
+
+    if (quotient_width + remainder_width > kWordWidth) {
+      throw std::invalid_argument(
+          "Quotient and remainder have to be at most 64 bits wide.");
+    }
+
+    return quotient_width;
+  }
+
+  /**
+   * Returns a hash of a key, which is the finalizer of MurmurHash3.
+   *
+   * @param key The key.
+   * @return The hash of the key.
+   */
+  [[nodiscard]] static inline Word hash(const Key key) {
+    Word x = key;
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCD;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53;
+    x ^= x >> 33;
+    return x;
+  }
+
+  /**
+   * Returns the quotient of a hash, which consists of its most significant
+   * bits.
+   *
+   * @param hash_value The hash.
+   * @return The quotient of the hash.
+   */
+  [[nodiscard]] inline std::size_t quotient(const Word hash_value) const {
+    const std::size_t shift = kWordWidth - _quotient_width;
+    return static_cast<std::size_t>(hash_value >> shift);
+  }
+
+  /**
+   * Returns the remainder of a hash, which consists of the bits following the
+   * quotient.
+   *
+   * @param hash_value The hash.
+   * @return The remainder of the hash.
+   */
+  [[nodiscard]] inline Remainder remainder(const Word hash_value) const {
+    const std::size_t shift = kWordWidth - _quotient_width - _remainder_width;
+    return static_cast<Remainder>((hash_value >> shift) &
+                                  math::setbits<Word>(_remainder_width));
+  }
+
+  /**
+   * Computes the hashes of a batch of keys and prefetches the blocks of their
+   * home slots.
+   *
+   * @param keys The keys of the batch.
+   * @param hashes A pointer to the array that stores the hashes.
+   */
+  void prefetch(const std::span<const Key> keys, Word* const hashes) const {
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      hashes[i] = hash(keys[i]);
+      __builtin_prefetch(&_blocks[quotient(hashes[i]) / kNumSlotsPerBlock]);
+    }
+  }
+
+  /**
+   * Inserts a hash into this filter, which is resized if necessary.
+   *
+   * @param hash_value The hash to insert.
+   * @return Whether the hash has been inserted.
+   */
+  bool insert_hash(const Word hash_value) {
+    if (_num_elements + 1 > kMaxLoadFactor * _num_home_slots) {
+      resize();
+    }
+
+    while (!insert_fingerprint(quotient(hash_value), remainder(hash_value))) {
+      if (!resize()) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Inserts a remainder at the end of the run of its quotient.
+   *
+   * @param home_slot The quotient.
+   * @param rem The remainder.
+   * @return Whether the remainder has been inserted, which fails only if the
+   * runs would overflow past the last slot.
+   */
+  bool insert_fingerprint(const std::size_t home_slot, const Remainder rem) {
+    const std::size_t pos = end(home_slot);
+    if (pos <= home_slot) {
+      remainder_at(home_slot) = rem;
+      set_occupied(home_slot, true);
+      set_runend(home_slot, true);
+      _num_elements += 1;
+      return true;
+    }
+
+    const std::size_t unused = first_unused(pos);
+    if (unused >= _num_slots) {
+      return false;
+    }
+
+    // Shift the following slots of the cluster by one slot to the right.
+    for (std::size_t slot = unused; slot > pos; --slot) {
+      remainder_at(slot) = remainder_at(slot - 1);
+      set_runend(slot, is_runend(slot - 1));
+    }
+
+    remainder_at(pos) = rem;
+    if (is_occupied(home_slot)) {
+      set_runend(pos - 1, false);
+    } else {
+      set_occupied(home_slot, true);
+    }
+    set_runend(pos, true);
+
+    // The blocks that start after the home slot and within the shifted slots
+    // are used by one slot more by runs of earlier blocks.
+    for (std::size_t num_block = home_slot / kNumSlotsPerBlock + 1;
+         num_block * kNumSlotsPerBlock <= unused; ++num_block) {
+      _blocks[num_block].offset += 1;
+    }
+
+    _num_elements += 1;
+    return true;
+  }
+
+  /**
+   * Returns the slot of a remainder within the run of its quotient.
+   *
+   * @param home_slot The quotient.
+   * @param rem The remainder.
+   * @return The slot of the remainder, or kNotFound if it is not contained.
+   */
+  [[nodiscard]] std::size_t find(const std::size_t home_slot,
+                                 const Remainder rem) const {
+    if (!is_occupied(home_slot)) {
+      return kNotFound;
+    }
+
+    std::size_t found_slot = kNotFound;
+    for_each_run_slot(home_slot, [&](const std::size_t slot) {
+      if (remainder_at(slot) == rem) {
+        found_slot = slot;
+        return true;
+      }
+
+      return false;
+    });
+
+    return found_slot;
+  }
+
+  /**
+   * Invokes a function for each slot of the run of an occupied quotient, from
+   * the last slot to the first one, until the function returns true.
+   *
+   * @tparam Function The type of function to invoke.
+   * @param home_slot The quotient.
+   * @param function The function to invoke with a slot.
+   */
+  template <typename Function>
+  void for_each_run_slot(const std::size_t home_slot,
+                         Function&& function) const {
+    std::size_t slot = end(home_slot) - 1;
+    while (true) {
+      if (function(slot)) {
+        return;
+      }
+
+      if (slot == home_slot || is_runend(slot - 1)) {
+        return;
+      }
+
+      slot -= 1;
+    }
+  }
+
+  /**
+   * Invokes a function for each fingerprint, i.e., quotient and remainder
+   * concatenated, in increasing order of the quotients.
+   *
+   * @tparam Function The type of function to invoke.
+   * @param function The function to invoke with a fingerprint.
+   */
+  template <typename Function>
+  void for_each_fingerprint(Function&& function) const {
+    std::size_t next_slot = 0;
+    for (std::size_t num_block = 0;
+         num_block < _num_home_slots / kNumSlotsPerBlock; ++num_block) {
+      Word occupieds = _blocks[num_block].occupieds;
+
+      while (occupieds != 0) {
+        const std::size_t home_slot =
+            num_block * kNumSlotsPerBlock + std::countr_zero(occupieds);
+        occupieds &= occupieds - 1;
+
+        const std::size_t run_start = std::max(home_slot, next_slot);
+        const std::size_t run_end = next_runend(run_start);
+        for (std::size_t slot = run_start; slot <= run_end; ++slot) {
+          function((static_cast<Word>(home_slot) << _remainder_width) |
+                   remainder_at(slot));
+        }
+
+        next_slot = run_end + 1;
+      }
+    }
+  }
+
+  /**
+   * Returns the slot after the runs of all quotients up to a quotient, or a
+   * slot that is not after the quotient if these runs end before it.
+   *
+   * @param home_slot The quotient.
+   * @return The slot after the runs of all quotients up to the quotient.
+   */
+  [[nodiscard]] inline std::size_t end(const std::size_t home_slot) const {
+    const std::size_t num_block = home_slot / kNumSlotsPerBlock;
+    const Block& block = _blocks[num_block];
+
+    // The quotients of the block up to the quotient own the runs that end at
+    // the runends following the slots that are used by earlier blocks.
+    const std::size_t rank = std::popcount(
+        block.occupieds &
+        math::setbits<Word>(home_slot % kNumSlotsPerBlock + 1));
+    const std::size_t first_slot =
+        num_block * kNumSlotsPerBlock + block.offset;
+    if (rank == 0) {
+      return first_slot;
+    }
+
+    return select_runend(first_slot, rank) + 1;
+  }
+
+  /**
+   * Returns the first unused slot at or after a slot.
+   *
+   * @param slot The slot.
+   * @return The first unused slot at or after the slot.
+   */
+  [[nodiscard]] inline std::size_t first_unused(std::size_t slot) const {
+    while (slot < _num_slots) {
+      const std::size_t next_slot = end(slot);
+      if (next_slot <= slot) {
+        return slot;
+      }
+
+      slot = next_slot;
+    }
+
+    return slot;
+  }
+
+  /**
+   * Returns the position of the rank-th runend at or after a slot.
+   *
+   * @param slot The slot.
+   * @param rank The rank of the runend, which is at least one.
+   * @return The position of the runend.
+   */
+  [[nodiscard]] inline std::size_t select_runend(const std::size_t slot,
+                                                 std::size_t rank) const {
+    std::size_t num_block = slot / kNumSlotsPerBlock;
+    Word runends = _blocks[num_block].runends &
+                   ~math::setbits<Word>(slot % kNumSlotsPerBlock);
+
+    while (true) {
+      const std::size_t num_runends = std::popcount(runends);
+      if (rank <= num_runends) {
+        return num_block * kNumSlotsPerBlock +
+               word_select1<true>(runends, rank);
+      }
+
+      rank -= num_runends;
+      num_block += 1;
+      runends = _blocks[num_block].runends;
+    }
+  }
+
+  /**
+   * Returns the position of the first runend at or after a slot.
+   *
+   * @param slot The slot.
+   * @return The position of the runend.
+   */
+  [[nodiscard]] inline std::size_t next_runend(const std::size_t slot) const {
+    return select_runend(slot, 1);
+  }
+
+  /**
+   * Returns the first occupied quotient within a range of quotients.
+   *
+   * @param first The first quotient of the range.
+   * @param last The last quotient of the range.
+   * @return The first occupied quotient, or kNotFound if there is none.
+   */
+  [[nodiscard]] inline std::size_t next_occupied(const std::size_t first,
+                                                 const std::size_t last) const {
+    std::size_t num_block = first / kNumSlotsPerBlock;
+    Word occupieds = _blocks[num_block].occupieds &
+                     ~math::setbits<Word>(first % kNumSlotsPerBlock);
+
+    while (num_block * kNumSlotsPerBlock <= last) {
+      if (occupieds != 0) {
+        const std::size_t quotient =
+            num_block * kNumSlotsPerBlock + std::countr_zero(occupieds);
+        return (quotient <= last) ? quotient : kNotFound;
+      }
+
+      num_block += 1;
+      if (num_block >= _blocks.size()) {
+        break;
+      }
+
+      occupieds = _blocks[num_block].occupieds;
+    }
+
+    return kNotFound;
+  }
+
+  [[nodiscard]] inline bool is_occupied(const std::size_t slot) const {
+    const Word occupieds = _blocks[slot / kNumSlotsPerBlock].occupieds;
+    return ((occupieds >> (slot % kNumSlotsPerBlock)) & 1) == 1;
+  }
+
+  inline void set_occupied(const std::size_t slot, const bool value) {
+    Word& occupieds = _blocks[slot / kNumSlotsPerBlock].occupieds;
+    const Word mask = static_cast<Word>(1) << (slot % kNumSlotsPerBlock);
+    occupieds = (occupieds & ~mask) | (-static_cast<Word>(value) & mask);
+  }
+
+  [[nodiscard]] inline bool is_runend(const std::size_t slot) const {
+    const Word runends = _blocks[slot / kNumSlotsPerBlock].runends;
+    return ((runends >> (slot % kNumSlotsPerBlock)) & 1) == 1;
+  }
+
+  inline void set_runend(const std::size_t slot, const bool value) {
+    Word& runends = _blocks[slot / kNumSlotsPerBlock].runends;
+    const Word mask = static_cast<Word>(1) << (slot % kNumSlotsPerBlock);
+    runends = (runends & ~mask) | (-static_cast<Word>(value) & mask);
+  }
+
+  [[nodiscard]] inline Remainder& remainder_at(const std::size_t slot) {
+    return _blocks[slot / kNumSlotsPerBlock]
+        .remainders[slot % kNumSlotsPerBlock];
+  }
+
+  [[nodiscard]] inline Remainder remainder_at(const std::size_t slot) const {
+    return _blocks[slot / kNumSlotsPerBlock]
+        .remainders[slot % kNumSlotsPerBlock];
+  }
+
+  std::size_t _quotient_width;
+  std::size_t _remainder_width;
+  std::size_t _num_home_slots;
+  StaticVector<Block> _blocks;
+  std::size_t _num_slots;
+  std::size_t _num_elements;
+};
+
+}  // namespace bitsy
@@ -0,0 +1,312 @@
+/// A bit vector with a fixed length and rank and select support whose
+/// operations can be evaluated at compile time.
+/// @file fixed_rank_bitvector.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "bitsy/select/word_select.hpp"
+#include "bitsy/util/math.hpp"
+
+namespace bitsy {
+
+/**
+ * A bit vector with a length that is fixed at compile time and rank and select
+ * support, which stores its bits and rank-data inline in arrays rather than on
+ * the heap and whose operations are all constexpr.
+ *
+ * It is intended for small tables such as character classes, which can then be
+ * built at compile time, placed in read-only memory and queried without
+ * following a pointer:
+ *
+ *   constexpr auto kDigits = [] {
+ *     FixedRankBitVector<256> bitvector;
+ *     for (char c = '0'; c <= '9'; ++c) bitvector.set(c);
+ *     bitvector.update();
+ *     return bitvector;
+ *   }();
+ *
+ * The bits are grouped into blocks of \a BlockWidth bits, for each of which we
+ * store the number of ones up to the start of the block using the smallest
+ * unsigned integer type that can hold the length. A rank query thus takes one
+ * lookup and at most \a BlockWidth / 64 popcounts, and a select query a binary
+ * search over the blocks followed by a linear search over the words of a block.
+ *
+ * @tparam Length The number of bits that the bit vector contains.
+ * @tparam BlockWidth The size of each block in bits.
+ */
+template <std::size_t Length, std::size_t BlockWidth = 512>
+class FixedRankBitVector {
+  static_assert(Length > 0, "Length has to be greater than zero.");
+  static_assert(BlockWidth % 64 == 0,
+                "Block width has to be a multiple of 64 bits.");
+
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordWidth = sizeof(Word) * 8;
+
+  using Rank = std::conditional_t<
+      Length <= std::numeric_limits<std::uint16_t>::max(), std::uint16_t,
+      std::conditional_t<Length <= std::numeric_limits<std::uint32_t>::max(),
+                         std::uint32_t, std::uint64_t>>;
+
+ public:
+  //! The number of bits that this bit vector contains.
+  static constexpr std::size_t kLength = Length;
+  //! The width in bits of a block.
+  static constexpr std::size_t kBlockWidth = BlockWidth;
+  //! The number of words per block.
+  static constexpr std::size_t kNumWordsPerBlock = kBlockWidth / kWordWidth;
+  //! The number of words that store the bits.
+  static constexpr std::size_t kNumWords = math::div_ceil(Length, kWordWidth);
+  //! The number of blocks.
+  static constexpr std::size_t kNumBlocks =
+      math::div_ceil(kNumWords, kNumWordsPerBlock);
+
+  /**
+   * Constructs a bit vector whose bits are all set to zero.
+   */
+  constexpr FixedRankBitVector() : _data{}, _block_ranks{} {}
+
+  /**
+   * Sets a bit to zero. Note that the rank-data is not updated.
+   *
+   * @param pos The position of the bit to set to zero.
+   */
+  constexpr void unset(const std::size_t pos) {
+    _data[pos / kWordWidth] &= ~(static_cast<Word>(1) << (pos % kWordWidth));
+  }
+
+  /**
+   * Sets a bit to one. Note that the rank-data is not updated.
+   *
+   * @param pos The position of the bit to set to one.
+   */
+  constexpr void set(const std::size_t pos) {
+    _data[pos / kWordWidth] |= static_cast<Word>(1) << (pos % kWordWidth);
+  }
+
+  /**
+   * Sets a bit to a value. Note that the rank-data is not updated.
+   *
+   * @param pos The position of the bit to set.
+   * @param value The value to set the bit to.
+   */
+  constexpr void set(const std::size_t pos, const bool value) {
+    const std::size_t word_pos = pos % kWordWidth;
+    Word& word = _data[pos / kWordWidth];
+    word = (word & ~(static_cast<Word>(1) << word_pos)) |
+           (static_cast<Word>(value) << word_pos);
+  }
+
+  /**
+   * Returns whether a bit is set.
+   *
+   * @param pos The position of the bit to check.
+   * @return Whether the bit is set.
+   */
+  [[nodiscard]] constexpr bool is_set(const std::size_t pos) const {
+    return ((_data[pos / kWordWidth] >> (pos % kWordWidth)) & 1) == 1;
+  }
+
+  /**
+   * Computes the rank-data, which has to be done after the bits have been set
+   * and before any rank or select query is issued.
+   */
+  constexpr void update() {
+    Rank cur_rank = 0;
+    for (std::size_t num_block = 0; num_block < kNumBlocks; ++num_block) {
+      _block_ranks[num_block] = cur_rank;
+
+      const std::size_t first = num_block * kNumWordsPerBlock;
+      const std::size_t last = std::min(first + kNumWordsPerBlock, kNumWords);
+      for (std::size_t num_word = first; num_word < last; ++num_word) {
+        cur_rank += std::popcount(_data[num_word]);
+      }
+    }
+
+    _block_ranks[kNumBlocks] = cur_rank;
+  }
+
+  /**
+   * Returns the number of bits equal to zero up to a position.
+   *
+   * @param pos The position up to which bits are to be taken into account,
+   * which has to be at most the length of the bit vector.
+   * @return The number of bits equal to zero up to the position.
+   */
+  [[nodiscard]] constexpr std::size_t rank0(const std::size_t pos) const {
+    return pos - rank1(pos);
+  }
+
+  /**
+   * Returns the number of bits equal to one up to a position.
+   *
+   * @param pos The position up to which bits are to be taken into account,
+   * which has to be at most the length of the bit vector.
+   * @return The number of bits equal to one up to the position.
+   */
+  [[nodiscard]] constexpr std::size_t rank1(const std::size_t pos) const {
+    const std::size_t last_word = pos / kWordWidth;
+    std::size_t num_word = (last_word / kNumWordsPerBlock) * kNumWordsPerBlock;
+
+    std::size_t rank = _block_ranks[num_word / kNumWordsPerBlock];
+    while (num_word < last_word) {
+      rank += std::popcount(_data[num_word++]);
+    }
+
+    const std::size_t word_pos = pos % kWordWidth;
+    if (word_pos != 0) {
+      rank += std::popcount(_data[last_word] << (kWordWidth - word_pos));
+    }
+
+    return rank;
+  }
+
+  /**
+   * Returns the position of the rank-th occurence of zero.
+   *
+   * @param rank The rank of the zero whose position is to be returned, which
+   * has to be at least one and at most the number of zeros.
+   * @return The position of the zero with given rank.
+   */
+  [[nodiscard]] constexpr std::size_t select0(std::size_t rank) const {
+    const auto block_rank = [&](const std::size_t num_block) {
+      return num_block * kBlockWidth - _block_ranks[num_block];
+    };
+
+    const std::size_t num_block = find_block(rank, block_rank);
+    rank -= block_rank(num_block);
+
+    std::size_t num_word = num_block * kNumWordsPerBlock;
+    std::size_t word_rank;
+    while ((word_rank = std::popcount(~_data[num_word])) < rank) {
+      rank -= word_rank;
+      num_word += 1;
+    }
+
+    return num_word * kWordWidth + select_in_word(~_data[num_word], rank);
+  }
+
+  /**
+   * Returns the position of the rank-th occurence of one.
+   *
+   * @param rank The rank of the one whose position is to be returned, which
+   * has to be at least one and at most the number of ones.
+   * @return The position of the one with given rank.
+   */
+  [[nodiscard]] constexpr std::size_t select1(std::size_t rank) const {
+    const auto block_rank = [&](const std::size_t num_block) {
+      return static_cast<std::size_t>(_block_ranks[num_block]);
+    };
+
+    const std::size_t num_block = find_block(rank, block_rank);
+    rank -= block_rank(num_block);
+
+    std::size_t num_word = num_block * kNumWordsPerBlock;
+    std::size_t word_rank;
+    while ((word_rank = std::popcount(_data[num_word])) < rank) {
+      rank -= word_rank;
+      num_word += 1;
+    }
+
+    return num_word * kWordWidth + select_in_word(_data[num_word], rank);
+  }
+
+  /**
+   * Returns the number of bits set to one, which is only valid after the
+   * rank-data has been computed.
+   *
+   * @return The number of bits set to one.
+   */
+  [[nodiscard]] constexpr std::size_t num_ones() const {
+    return _block_ranks[kNumBlocks];
+  }
+
+  /**
+   * Returns the number of bits that this bit vector contains.
+   *
+   * @return The number of bits that this bit vector contains.
+   */
+  [[nodiscard]] static constexpr std::size_t length() {
+    return kLength;
+  }
+
+  /**
+   * Returns a pointer to the data of this bit vector.
+   *
+   * @return A pointer to the data of this bit vector.
+   */
+  [[nodiscard]] constexpr const Word* data() const {
+    return _data.data();
+  }
+
+  /**
+   * Returns the used memory space of this data structure in bits.
+   *
+   * Note that, unlike for the other bit vectors, the memory is stored inline
+   * rather than on the heap.
+   *
+   * @return The used memory space of this data structure in bits.
+   */
+  [[nodiscard]] static constexpr std::size_t memory_space() {
+    return sizeof(FixedRankBitVector) * 8;
+  }
+
+ private:
+  /**
+   * Returns the last block whose number of occurences up to its start is less
+   * than a rank using a binary search.
+   *
+   * @param rank The rank of the occurence.
+   * @param block_rank A function that returns the number of occurences up to
+   * the start of a block.
+   * @return The number of the block that contains the occurence.
+   */
+  template <typename BlockRank>
+  [[nodiscard]] static constexpr std::size_t find_block(
+      const std::size_t rank, BlockRank&& block_rank) {
+    std::size_t num_block = 0;
+    std::size_t num_last_block = kNumBlocks - 1;
+    while (num_block < num_last_block) {
+      const std::size_t mid = (num_block + num_last_block + 1) / 2;
+
+      if (block_rank(mid) < rank) {
+        num_block = mid;
+      } else {
+        num_last_block = mid - 1;
+      }
+    }
+
+    return num_block;
+  }
+
+  /**
+   * Returns the position of the rank-th set bit in a word, whereby the PDEP
+   * implementation is only used outside of constant evaluation, as it relies on
+   * an intrinsic.
+   *
+   * @param word The word in which to find the position.
+   * @param rank The rank of the set bit.
+   * @return The position of the set bit with given rank.
+   */
+  [[nodiscard]] static constexpr std::size_t select_in_word(
+      const Word word, const std::size_t rank) {
+    if (std::is_constant_evaluated()) {
+      return word_select1<true, true>(word, rank);
+    }
+
+    return word_select1<true>(word, rank);
+  }
+
+  std::array<Word, kNumWords> _data;
+  std::array<Rank, kNumBlocks + 1> _block_ranks;
+};
+
+}  // namespace bitsy
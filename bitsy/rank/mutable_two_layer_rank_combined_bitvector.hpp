@@ -0,0 +1,548 @@
+/// A bit vector with rank and select support which groups the bits into
+/// superblocks and blocks and keeps the rank-data up-to-date on every write.
+/// @file mutable_two_layer_rank_combined_bitvector.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "bitsy/select/word_select.hpp"
+#include "bitsy/util/math.hpp"
+#include "bitsy/util/static_vector.hpp"
+
+namespace bitsy {
+
+/**
+ * A bit vector with rank and select support which groups the bits into
+ * superblocks and blocks and keeps the rank-data up-to-date on every write.
+ *
+ * The bits and block headers use the same interleaved layout as the two-layer
+ * rank-combined bit vector, i.e., the number of ones up to the start of a block
+ * within its superblock is stored in the first \a BlockHeaderWidth bits of the
+ * block. However, instead of storing the absolute rank of each superblock, we
+ * store the number of ones within the superblocks in a Fenwick tree.
+ *
+ * When a write changes a bit, we thus only have to adjust the headers of the
+ * following blocks within the same superblock (at most 31 for a block width of
+ * 512) and O(log n) nodes of the Fenwick tree. In turn, the rank of a
+ * superblock is obtained with a prefix sum over O(log n) nodes, whose upper
+ * levels are shared by all queries and usually cached. Select queries descend
+ * the Fenwick tree to find the superblock and then search the block headers in
+ * the same way as the two-layer select data structure, so that no samples have
+ * to be maintained.
+ *
+ * @tparam BlockWidth The size of each block in bits.
+ * @tparam BlockHeaderWidth The size of the block header in bits.
+ */
+template <std::size_t BlockWidth = 512, std::size_t BlockHeaderWidth = 14>
+class MutableTwoLayerRankCombinedBitVector {
+  static_assert(BlockWidth % 2 == 0, "Block width has to be a power of two.");
+  static_assert(BlockWidth > 64, "Block width has to greater than 64 bits.");
+  static_assert(BlockHeaderWidth <= 64,
+                "Block header has to be a at most 64 bits wide.");
+  static_assert(math::pow2(BlockHeaderWidth) > BlockWidth,
+                "Superblock width has to be greater than the block width.");
+
+  using BitVector = MutableTwoLayerRankCombinedBitVector;
+
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordWidth = sizeof(Word) * 8;
+
+ public:
+  //! The width in bits of a block.
+  static constexpr std::size_t kBlockWidth = BlockWidth;
+  //! The width in bits of the header that is stored in the first word of a
+  //! block.
+  static constexpr std::size_t kBlockHeaderWidth = BlockHeaderWidth;
+  //! The width in bits of the data that is stored in a block.
+  static constexpr std::size_t kBlockDataWidth =
+      kBlockWidth - kBlockHeaderWidth;
+  //! The width in bits of the data this is stored in the first word of a block.
+  static constexpr std::size_t kHeaderDataWidth =
+      kWordWidth - kBlockHeaderWidth;
+  //! The number of words per block.
+  static constexpr std::size_t kNumWordsPerBlock = kBlockWidth / kWordWidth;
+
+  //! The width in bits of a superblock.
+  static constexpr std::size_t kSuperblockWidth = math::pow2(BlockHeaderWidth);
+  //! The number of blocks per superblock.
+  static constexpr std::size_t kNumBlocksPerSuperblock =
+      kSuperblockWidth / kBlockWidth;
+  //! The number of words per superblock.
+  static constexpr std::size_t kNumWordsPerSuperblock =
+      kSuperblockWidth / kWordWidth;
+  //! The width in bits of the data that is stored in a superblock.
+  static constexpr std::size_t kSuperblockDataWidth =
+      kSuperblockWidth - kNumBlocksPerSuperblock * kBlockHeaderWidth;
+
+  /**
+   * Constructs a bit vector whose bits are all set to zero. Unlike the static
+   * variant, the bits have to be initialized, as the rank information is kept
+   * up-to-date from the start.
+   *
+   * @param length The number of bits that this bit vector contains.
+   */
+  explicit MutableTwoLayerRankCombinedBitVector(const std::size_t length)
+      : _length(length),
+        _num_blocks(math::div_ceil(length, kBlockDataWidth)),
+        // We have to pad the data with (virtual) blocks, which allow us to do
+        // an binary search (for select) without segfaulting or having to
+        // consider an edge case.
+        _data(_num_blocks * kNumWordsPerBlock +
+              (kNumBlocksPerSuperblock / 2) * kNumWordsPerBlock),
+        _num_superblocks(math::div_ceil(length, kSuperblockDataWidth)),
+        // The Fenwick tree is one-based, i.e., the first entry is unused.
+        _tree(_num_superblocks + 1),
+        _num_ones(0) {
+    std::fill_n(_data.data(), _data.size(), 0);
+    std::fill_n(_tree.data(), _tree.size(), 0);
+  }
+
+  /**
+   * Constructs a bit vector whose bits are all set to zero or one and
+   * initializes the integrated rank structure.
+   *
+   * @param length The number of bits that this bit vector contains.
+   * @param set Whether the bits are initially set to zero or one.
+   */
+  explicit MutableTwoLayerRankCombinedBitVector(const std::size_t length,
+                                                const bool set)
+      : MutableTwoLayerRankCombinedBitVector(length) {
+    if (set) {
+      // Set the bits without maintaining the rank information, which is
+      // computed once afterwards.
+      for (std::size_t pos = 0; pos < length; ++pos) {
+        word(pos) |= mask(pos);
+      }
+
+      update();
+    }
+  }
+
+  // Create the default destructor.
+  ~MutableTwoLayerRankCombinedBitVector() = default;
+
+  // Create the default move constructor/move assignment operator.
+  MutableTwoLayerRankCombinedBitVector(BitVector&&) noexcept = default;
+  MutableTwoLayerRankCombinedBitVector& operator=(BitVector&&) noexcept =
+      default;
+
+  // Delete the copy constructor/copy assignment operator as we do not intend
+  // to copy the bit vector.
+  MutableTwoLayerRankCombinedBitVector(BitVector const&) = delete;
+  MutableTwoLayerRankCombinedBitVector& operator=(BitVector const&) = delete;
+
+  /**
+   * Sets a bit within this bit vector to zero and updates the rank
+   * information if the bit was set.
+   *
+   * @param pos The position of the bit that is to be set to zero.
+   */
+  inline void unset(const std::size_t pos) {
+    Word& word = BitVector::word(pos);
+    const Word mask = BitVector::mask(pos);
+
+    if ((word & mask) != 0) {
+      word &= ~mask;
+      add(pos, static_cast<Word>(-1));
+    }
+  }
+
+  /**
+   * Sets a bit within this bit vector to one and updates the rank information
+   * if the bit was not set.
+   *
+   * @param pos The position of the bit that is to be set to one.
+   */
+  inline void set(const std::size_t pos) {
+    Word& word = BitVector::word(pos);
+    const Word mask = BitVector::mask(pos);
+
+    if ((word & mask) == 0) {
+      word |= mask;
+      add(pos, 1);
+    }
+  }
+
+  /**
+   * Sets a bit within this bit vector depending on a boolean value and updates
+   * the rank information if the bit has changed.
+   *
+   * @param pos The position of the bit that is to be set to one.
+   * @param value Whether to set the bit.
+   */
+  inline void set(const std::size_t pos, const bool value) {
+    if (value) {
+      set(pos);
+    } else {
+      unset(pos);
+    }
+  }
+
+  /**
+   * Returns whether a bit within this bit vector is set.
+   *
+   * @param pos The position of the bit that is to be queried.
+   * @param value Whether the bit is set.
+   */
+  [[nodiscard]] inline bool is_set(const std::size_t pos) const {
+    return (word(pos) & mask(pos)) != 0;
+  }
+
+  /**
+   * Recomputes the rank information from the bits in linear time.
+   *
+   * As every write keeps the rank information up-to-date, this is never
+   * required for correctness. It is provided to fulfill the rank type trait.
+   */
+  void update() {
+    const Word* const data = _data.data();
+    const std::size_t num_words = _num_blocks * kNumWordsPerBlock;
+
+    Word cur_rank = 0;
+    Word cur_block_rank = 0;
+    std::size_t cur_num_superblock = 0;
+    for (std::size_t i = 0; i < num_words; i += kNumWordsPerBlock) {
+      const bool is_superblock_word = (i % kNumWordsPerSuperblock) == 0;
+
+      if (is_superblock_word && i > 0) [[unlikely]] {
+        _tree[++cur_num_superblock] = cur_block_rank;
+        cur_rank += cur_block_rank;
+        cur_block_rank = 0;
+      }
+
+      _data[i] = (_data[i] &
+                  math::setbits<Word>(kHeaderDataWidth, kBlockHeaderWidth)) |
+                 cur_block_rank;
+      cur_block_rank += block_popcount(data + i);
+    }
+    if (_num_superblocks > 0) {
+      _tree[++cur_num_superblock] = cur_block_rank;
+    }
+    _num_ones = cur_rank + cur_block_rank;
+
+    // Fill the headers of the virtual blocks like the following blocks of the
+    // last superblock, so that a binary search for a select query works.
+    for (std::size_t i = num_words; i < _data.size(); i += kNumWordsPerBlock) {
+      if ((i % kNumWordsPerSuperblock) == 0) {
+        cur_block_rank = 0;
+      }
+
+      _data[i] = cur_block_rank;
+    }
+
+    // Build the Fenwick tree in linear time by adding the value of each node
+    // to its parent.
+    for (std::size_t node = 1; node <= _num_superblocks; ++node) {
+      const std::size_t parent = node + (node & -node);
+      if (parent <= _num_superblocks) {
+        _tree[parent] += _tree[node];
+      }
+    }
+  }
+
+  /**
+   * Returns the number of bits equal to zero up to a position.
+   *
+   * @param pos The position up to which bits are to be taken into account.
+   * @return The number of bits equal to zero up to the position.
+   */
+  [[nodiscard]] inline Word rank0(const std::size_t pos) const {
+    return static_cast<Word>(pos) - rank1(pos);
+  }
+
+  /**
+   * Returns the number of bits equal to one up to a position.
+   *
+   * @param pos The position up to which bits are to be taken into account.
+   * @return The number of bits equal to zero up to the position.
+   */
+  [[nodiscard]] inline Word rank1(const std::size_t pos) const {
+    // Step 1: Compute the block and the word within the block in which the bit
+    // is located as well as the position of the bit within the word.
+    const std::size_t num_block = pos / kBlockDataWidth;
+    const std::size_t block_pos = pos % kBlockDataWidth + kBlockHeaderWidth;
+
+    const std::size_t num_word = block_pos / kWordWidth;
+    const std::size_t word_pos = block_pos % kWordWidth;
+
+    // Step 2: Fetch the block first, so that its cache miss overlaps with the
+    // prefix sum over the Fenwick tree.
+    const Word* const data = _data.data() + num_block * kNumWordsPerBlock;
+    __builtin_prefetch(data);
+
+    Word rank = superblock_rank(pos / kSuperblockDataWidth);
+
+    // Step 3: Fetch the number of ones up to the start of the block within its
+    // superblock, which we store in the first kBlockHeaderWidth bits.
+    const Word first_word = *data;
+    rank += first_word & math::setbits<Word>(kBlockHeaderWidth);
+
+    // Step 4: Count the number of ones within the block up to the bit like the
+    // static variant does.
+    if (num_word == 0) [[unlikely]] {
+      const std::size_t shift = (kWordWidth + kBlockHeaderWidth) - word_pos;
+      rank += std::popcount((first_word >> kBlockHeaderWidth) << shift) *
+              (word_pos != kBlockHeaderWidth);
+    } else {
+      rank += std::popcount(first_word >> kBlockHeaderWidth);
+
+      std::size_t i = 1;
+      while (i < num_word) {
+        rank += std::popcount(data[i++]);
+      }
+
+      const std::size_t shift = kWordWidth - word_pos;
+      rank += std::popcount(data[i] << shift) * (word_pos != 0);
+    }
+
+    return rank;
+  }
+
+  /**
+   * Returns the position of the rank-th occurence of zero.
+   *
+   * @param rank The rank of the first zero whose position is to be returned.
+   * @return The position of the first zero with given rank.
+   */
+  [[nodiscard]] inline Word select0(std::size_t rank) const {
+    // Step 1: Find the superblock by descending the Fenwick tree, whereby the
+    // number of zeros of a node follows from the number of bits it covers.
+    std::size_t num_superblock = 0;
+    for (std::size_t step = std::bit_floor(_num_superblocks); step > 0;
+         step /= 2) {
+      const std::size_t node = num_superblock + step;
+
+      if (node <= _num_superblocks) {
+        const Word num_zeros = step * kSuperblockDataWidth - _tree[node];
+
+        if (num_zeros < rank) {
+          num_superblock = node;
+          rank -= num_zeros;
+        }
+      }
+    }
+
+    // Step 2: Find the block within the superblock using a binary search.
+    const Word* data = _data.data();
+    const auto block_rank = [&data](const std::size_t num_block) {
+      const Word header_word = data[num_block * kNumWordsPerBlock];
+      const Word num_ones =
+          header_word & math::setbits<Word>(kBlockHeaderWidth);
+      return (num_block % kNumBlocksPerSuperblock) * kBlockDataWidth -
+             num_ones;
+    };
+
+    Word num_block = num_superblock * kNumBlocksPerSuperblock;
+    Word length = kNumBlocksPerSuperblock;
+    while (length > 1) {
+      const Word half = length / 2;
+      length -= half;
+      num_block += (block_rank(num_block + half) < rank) * half;
+    }
+
+    rank -= block_rank(num_block);
+    data += num_block * kNumWordsPerBlock;
+
+    // Step 3: Find the word within the block using a linear search.
+    Word num_word = 0;
+    Word word = *data | math::setbits<Word>(kBlockHeaderWidth);
+    Word word_rank;
+    while ((word_rank = std::popcount(~word)) < rank) {
+      num_word += 1;
+      word = data[num_word];
+      rank -= word_rank;
+    }
+
+    return num_block * kBlockDataWidth + num_word * kWordWidth +
+           word_select1(~word, rank) - kBlockHeaderWidth;
+  }
+
+  /**
+   * Returns the position of the rank-th occurence of one.
+   *
+   * @param rank The rank of the first one whose position is to be returned.
+   * @return The position of the first one with given rank.
+   */
+  [[nodiscard]] inline Word select1(std::size_t rank) const {
+    // Step 1: Find the superblock by descending the Fenwick tree.
+    std::size_t num_superblock = 0;
+    for (std::size_t step = std::bit_floor(_num_superblocks); step > 0;
+         step /= 2) {
+      const std::size_t node = num_superblock + step;
+
+      if (node <= _num_superblocks && _tree[node] < rank) {
+        num_superblock = node;
+        rank -= _tree[node];
+      }
+    }
+
+    // Step 2: Find the block within the superblock using a binary search.
+    const Word* data = _data.data();
+    const auto block_rank = [&data](const std::size_t num_block) {
+      const Word header_word = data[num_block * kNumWordsPerBlock];
+      return header_word & math::setbits<Word>(kBlockHeaderWidth);
+    };
+
+    Word num_block = num_superblock * kNumBlocksPerSuperblock;
+    Word length = kNumBlocksPerSuperblock;
+    while (length > 1) {
+      const Word half = length / 2;
+      length -= half;
+      num_block += (block_rank(num_block + half) < rank) * half;
+    }
+
+    rank -= block_rank(num_block);
+    data += num_block * kNumWordsPerBlock;
+
+    // Step 3: Find the word within the block using a linear search.
+    Word num_word = 0;
+    Word word = *data & ~math::setbits<Word>(kBlockHeaderWidth);
+    Word word_rank;
+    while ((word_rank = std::popcount(word)) < rank) {
+      num_word += 1;
+      word = data[num_word];
+      rank -= word_rank;
+    }
+
+    return num_block * kBlockDataWidth + num_word * kWordWidth +
+           word_select1(word, rank) - kBlockHeaderWidth;
+  }
+
+  /**
+   * Returns the number of ones within the data of a block.
+   *
+   * @param data A pointer to the start of block for which the popcount is to be
+   * returned.
+   * @return The popcount of the block.
+   */
+  [[nodiscard]] inline static Word block_popcount(const Word* const data) {
+    Word popcount = std::popcount(*data >> kBlockHeaderWidth);
+
+    for (std::size_t i = 1; i < kNumWordsPerBlock; ++i) {
+      popcount += std::popcount(data[i]);
+    }
+
+    return popcount;
+  }
+
+  /**
+   * Returns the number of bits that this bit vector contains.
+   *
+   * @return The number of bits that this bit vector contains.
+   */
+  [[nodiscard]] inline std::size_t length() const {
+    return _length;
+  }
+
+  /**
+   * Returns the number of bits set to one.
+   *
+   * @return The number of bits set to one.
+   */
+  [[nodiscard]] inline std::size_t num_ones() const {
+    return _num_ones;
+  }
+
+  /**
+   * Returns a pointer to the underlying memory at which the bits are stored.
+   *
+   * @return A pointer to the underlying memory at which the bits are stored.
+   */
+  [[nodiscard]] inline const Word* data() const {
+    return _data.data();
+  }
+
+  /**
+   * Returns the used memory space of this data structure in bits.
+   *
+   * Note that it only accounts for the memory that is stored on the heap,
+   * i.e., the memory that depends on the length of the bit vector.
+   *
+   * @return The used memory space of this data structure in bits.
+   */
+  [[nodiscard]] inline std::size_t memory_space() const {
+    return _data.size() * kWordWidth + _tree.size() * kWordWidth;
+  }
+
+ private:
+  [[nodiscard]] inline static Word mask(const std::size_t pos) {
+    const std::size_t block_pos = pos % kBlockDataWidth + kBlockHeaderWidth;
+    return static_cast<Word>(1) << (block_pos % kWordWidth);
+  }
+
+  [[nodiscard]] inline Word& word(const std::size_t pos) {
+    const std::size_t num_block = pos / kBlockDataWidth;
+    const std::size_t block_pos = pos % kBlockDataWidth + kBlockHeaderWidth;
+    return _data[num_block * kNumWordsPerBlock + block_pos / kWordWidth];
+  }
+
+  [[nodiscard]] inline const Word& word(const std::size_t pos) const {
+    const std::size_t num_block = pos / kBlockDataWidth;
+    const std::size_t block_pos = pos % kBlockDataWidth + kBlockHeaderWidth;
+    return _data[num_block * kNumWordsPerBlock + block_pos / kWordWidth];
+  }
+
+  /**
+   * Returns the number of ones up to the start of a superblock, which is the
+   * prefix sum over the Fenwick tree.
+   *
+   * @param num_superblock The superblock whose rank is to be returned.
+   * @return The number of ones up to the start of the superblock.
+   */
+  [[nodiscard]] inline Word superblock_rank(std::size_t num_superblock) const {
+    Word rank = 0;
+
+    while (num_superblock > 0) {
+      rank += _tree[num_superblock];
+      num_superblock &= num_superblock - 1;
+    }
+
+    return rank;
+  }
+
+  /**
+   * Adds a (possibly negative) delta to the rank information after the bit at
+   * a position has changed.
+   *
+   * @param pos The position of the bit that has changed.
+   * @param delta The change of the number of ones in two's complement.
+   */
+  inline void add(const std::size_t pos, const Word delta) {
+    _num_ones += delta;
+
+    // Adjust the headers of the following blocks within the superblock, which
+    // includes the virtual blocks that pad the last superblock. As a header is
+    // stored in the least significant bits of its word and never overflows, we
+    // can add the delta to the whole word.
+    const std::size_t num_block = pos / kBlockDataWidth;
+    const std::size_t last_block =
+        std::min((num_block / kNumBlocksPerSuperblock + 1) *
+                     kNumBlocksPerSuperblock,
+                 _data.size() / kNumWordsPerBlock);
+    for (std::size_t cur_block = num_block + 1; cur_block < last_block;
+         ++cur_block) {
+      _data[cur_block * kNumWordsPerBlock] += delta;
+    }
+
+    // Adjust the nodes of the Fenwick tree that cover the superblock.
+    for (std::size_t node = pos / kSuperblockDataWidth + 1;
+         node <= _num_superblocks; node += node & -node) {
+      _tree[node] += delta;
+    }
+  }
+
+  std::size_t _length;
+  std::size_t _num_blocks;
+  StaticVector<Word> _data;
+
+  std::size_t _num_superblocks;
+  StaticVector<Word> _tree;
+
+  std::size_t _num_ones;
+};
+
+}  // namespace bitsy
@@ -0,0 +1,380 @@
+/// A vector of small symbols with rank support which groups the symbols into
+/// superblocks and blocks and stores the per-symbol counters for blocks
+/// interleaved with the symbols.
+/// @file symbol_rank_vector.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "bitsy/util/math.hpp"
+#include "bitsy/util/static_vector.hpp"
+
+namespace bitsy {
+
+// clang-format off
+/**
+ * A vector of small symbols (e.g., DNA) with rank support which groups the
+ * symbols into superblocks and blocks and stores the per-symbol counters for
+ * blocks interleaved with the symbols.
+ *
+ * Each symbol is stored in \a SymbolWidth bits, whereby the first symbol within
+ * a word is stored at the least significant position. The symbols are grouped
+ * into blocks of size \a BlockWidth bits. For each block, we store the number
+ * of occurences of each symbol up to the start of the block relative to its
+ * superblock in a 16-bit counter, whereby the counters are stored in the first
+ * words of the block:
+ *
+ * -----------------------....---------------------------....------...
+ * | Counters |      Symbols     | Counters |      Symbols     |...
+ * -----------------------....---------------------------....------...
+ *  ^^^^^^^^^^ 16 * 2^SymbolWidth bits wide
+ *
+ * For each superblock, we store the number of occurences of each symbol up to
+ * the start of the superblock in a 64-bit integer separately from the blocks.
+ * Thus, a rank query for one or all symbols accesses one block (i.e., one
+ * cache line for 2-bit symbols and two adjacent cache lines for 4-bit symbols
+ * with the default block width) and the superblock counters. The occurences of
+ * a symbol within a word are counted bit-parallel by comparing all symbols of
+ * the word at once. For 2-bit symbols, we get a space overhead of ~14.3% and,
+ * for 4-bit symbols, of ~33.3% on top of the symbols.
+ *
+ * @tparam SymbolWidth The size of each symbol in bits, which is two or four.
+ * @tparam BlockWidth The size of each block in bits.
+ */
+// clang-format on
+template <std::size_t SymbolWidth = 2,
+          std::size_t BlockWidth = (SymbolWidth == 2) ? 512 : 1024>
+class SymbolRankVector {
+  static_assert(SymbolWidth == 2 || SymbolWidth == 4,
+                "Symbol width has to be two or four bits.");
+  static_assert(BlockWidth % 64 == 0,
+                "Block width has to be a multiple of the word width.");
+
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordWidth = sizeof(Word) * 8;
+
+  using Counter = std::uint16_t;
+  static constexpr std::size_t kCounterWidth = sizeof(Counter) * 8;
+
+ public:
+  //! The type of integer that represents a symbol.
+  using Symbol = std::uint8_t;
+
+  //! The width in bits of a symbol.
+  static constexpr std::size_t kSymbolWidth = SymbolWidth;
+  //! The number of distinct symbols.
+  static constexpr std::size_t kNumSymbols = math::pow2(kSymbolWidth);
+  //! The number of symbols per word.
+  static constexpr std::size_t kNumSymbolsPerWord = kWordWidth / kSymbolWidth;
+
+  //! The width in bits of a block.
+  static constexpr std::size_t kBlockWidth = BlockWidth;
+  //! The number of words per block.
+  static constexpr std::size_t kNumWordsPerBlock = kBlockWidth / kWordWidth;
+  //! The number of words of a block at which the counters are stored.
+  static constexpr std::size_t kNumHeaderWords =
+      kNumSymbols * kCounterWidth / kWordWidth;
+  //! The number of words of a block at which the symbols are stored.
+  static constexpr std::size_t kNumDataWords =
+      kNumWordsPerBlock - kNumHeaderWords;
+  //! The number of symbols per block.
+  static constexpr std::size_t kNumSymbolsPerBlock =
+      kNumDataWords * kNumSymbolsPerWord;
+
+  static_assert(kNumWordsPerBlock > kNumHeaderWords,
+                "Block has to be wider than the counters.");
+
+  //! The number of blocks per superblock, which is chosen such that the
+  //! counters of a block do not overflow.
+  static constexpr std::size_t kNumBlocksPerSuperblock = std::bit_floor(
+      static_cast<std::size_t>(std::numeric_limits<Counter>::max()) /
+      kNumSymbolsPerBlock);
+  //! The number of symbols per superblock.
+  static constexpr std::size_t kNumSymbolsPerSuperblock =
+      kNumBlocksPerSuperblock * kNumSymbolsPerBlock;
+
+  /**
+   * Constructs a vector whose symbols are all set to zero.
+   *
+   * Note that the counters are only valid after a call to update().
+   *
+   * @param length The number of symbols that this vector contains.
+   */
+  explicit SymbolRankVector(const std::size_t length)
+      : _length(length),
+        _num_blocks(math::div_ceil(length, kNumSymbolsPerBlock)),
+        // Store one more block and superblock each such that the rank of the
+        // last position can be answered without considering a special case.
+        _data((_num_blocks + 1) * kNumWordsPerBlock),
+        _num_superblocks(math::div_ceil(length, kNumSymbolsPerSuperblock)),
+        _superblock_data((_num_superblocks + 1) * kNumSymbols),
+        _counts{} {
+    std::fill_n(_data.data(), _data.size(), 0);
+    std::fill_n(_superblock_data.data(), _superblock_data.size(), 0);
+  }
+
+  // Create the default destructor.
+  ~SymbolRankVector() = default;
+
+  // Create the default move constructor/move assignment operator.
+  SymbolRankVector(SymbolRankVector&&) noexcept = default;
+  SymbolRankVector& operator=(SymbolRankVector&&) noexcept = default;
+
+  // Delete the copy constructor/copy assignment operator as we do not intend
+  // to copy the vector.
+  SymbolRankVector(SymbolRankVector const&) = delete;
+  SymbolRankVector& operator=(SymbolRankVector const&) = delete;
+
+  /**
+   * Sets a symbol within this vector.
+   *
+   * @param pos The position of the symbol that is to be set.
+   * @param symbol The symbol to set, which is less than the number of symbols.
+   */
+  inline void set(const std::size_t pos, const Symbol symbol) {
+    const std::size_t num_word = word_index(pos);
+    const std::size_t word_pos = (pos % kNumSymbolsPerWord) * kSymbolWidth;
+
+    const Word mask = math::setbits<Word>(kSymbolWidth, word_pos);
+    _data[num_word] =
+        (_data[num_word] & ~mask) | (static_cast<Word>(symbol) << word_pos);
+  }
+
+  /**
+   * Returns a symbol within this vector.
+   *
+   * @param pos The position of the symbol that is to be returned.
+   * @return The symbol.
+   */
+  [[nodiscard]] inline Symbol get(const std::size_t pos) const {
+    const Word word = _data[word_index(pos)];
+    const std::size_t word_pos = (pos % kNumSymbolsPerWord) * kSymbolWidth;
+    return static_cast<Symbol>((word >> word_pos) &
+                               math::setbits<Word>(kSymbolWidth));
+  }
+
+  /**
+   * Updates the counters such that updates to the symbols since the
+   * initialization or the last update are reflected.
+   */
+  void update() {
+    std::array<Word, kNumSymbols> cur_count{};
+    std::array<Word, kNumSymbols> cur_block_count{};
+
+    // Also write the counters of the padding block, whose symbols are not
+    // counted.
+    for (std::size_t num_block = 0; num_block <= _num_blocks; ++num_block) {
+      if (num_block % kNumBlocksPerSuperblock == 0) [[unlikely]] {
+        Word* const superblock =
+            _superblock_data.data() +
+            (num_block / kNumBlocksPerSuperblock) * kNumSymbols;
+
+        for (std::size_t c = 0; c < kNumSymbols; ++c) {
+          cur_count[c] += cur_block_count[c];
+          superblock[c] = cur_count[c];
+          cur_block_count[c] = 0;
+        }
+      }
+
+      Word* const block = _data.data() + num_block * kNumWordsPerBlock;
+      std::fill_n(block, kNumHeaderWords, 0);
+      for (std::size_t c = 0; c < kNumSymbols; ++c) {
+        block[c / kNumCountersPerWord] |= cur_block_count[c]
+                                          << ((c % kNumCountersPerWord) *
+                                              kCounterWidth);
+      }
+
+      if (num_block == _num_blocks) [[unlikely]] {
+        break;
+      }
+
+      for (std::size_t i = kNumHeaderWords; i < kNumWordsPerBlock; ++i) {
+        for (std::size_t c = 0; c < kNumSymbols; ++c) {
+          cur_block_count[c] += std::popcount(matches(block[i], c));
+        }
+      }
+    }
+
+    // The padding of the last block consists of zero symbols, which must not
+    // be counted.
+    const std::size_t num_padding = _num_blocks * kNumSymbolsPerBlock - _length;
+    for (std::size_t c = 0; c < kNumSymbols; ++c) {
+      _counts[c] = cur_count[c] + cur_block_count[c];
+    }
+    _counts[0] -= num_padding;
+  }
+
+  /**
+   * Returns the number of occurences of a symbol up to a position.
+   *
+   * @param symbol The symbol whose occurences are to be counted.
+   * @param pos The position up to which symbols are to be taken into account.
+   * @return The number of occurences of the symbol up to the position.
+   */
+  [[nodiscard]] inline Word rank(const Symbol symbol,
+                                 const std::size_t pos) const {
+    const std::size_t num_block = pos / kNumSymbolsPerBlock;
+    const std::size_t num_superblock = num_block / kNumBlocksPerSuperblock;
+    const Word* const block = _data.data() + num_block * kNumWordsPerBlock;
+
+    return _superblock_data[num_superblock * kNumSymbols + symbol] +
+           block_rank(block, symbol, pos % kNumSymbolsPerBlock);
+  }
+
+  /**
+   * Returns the number of occurences of each symbol up to a position.
+   *
+   * As the counters are stored with the symbols, this accesses one block and
+   * the counters of one superblock.
+   *
+   * @param pos The position up to which symbols are to be taken into account.
+   * @return The number of occurences of each symbol up to the position.
+   */
+  [[nodiscard]] inline std::array<Word, kNumSymbols> rank_all(
+      const std::size_t pos) const {
+    const std::size_t num_block = pos / kNumSymbolsPerBlock;
+    const std::size_t num_superblock = num_block / kNumBlocksPerSuperblock;
+    const Word* const block = _data.data() + num_block * kNumWordsPerBlock;
+    const Word* const superblock =
+        _superblock_data.data() + num_superblock * kNumSymbols;
+
+    const std::size_t block_pos = pos % kNumSymbolsPerBlock;
+    std::array<Word, kNumSymbols> ranks;
+    for (std::size_t c = 0; c < kNumSymbols; ++c) {
+      ranks[c] =
+          superblock[c] + block_rank(block, static_cast<Symbol>(c), block_pos);
+    }
+
+    return ranks;
+  }
+
+  /**
+   * Returns the number of symbols that this vector contains.
+   *
+   * @return The number of symbols that this vector contains.
+   */
+  [[nodiscard]] inline std::size_t length() const {
+    return _length;
+  }
+
+  /**
+   * Returns the number of occurences of a symbol as of the last update.
+   *
+   * @param symbol The symbol whose occurences are to be returned.
+   * @return The number of occurences of the symbol as of the last update.
+   */
+  [[nodiscard]] inline std::size_t count(const Symbol symbol) const {
+    return _counts[symbol];
+  }
+
+  /**
+   * Returns the used memory space of this data structure in bits.
+   *
+   * Note that it only accounts for the memory that is stored on the heap,
+   * i.e., the memory that depends on the length of this vector.
+   *
+   * @return The used memory space of this data structure in bits.
+   */
+  [[nodiscard]] inline std::size_t memory_space() const {
+    return _data.size() * kWordWidth + _superblock_data.size() * kWordWidth;
+  }
+
+ private:
+  static constexpr std::size_t kNumCountersPerWord = kWordWidth / kCounterWidth;
+
+  //! A mask whose bits are set at the least significant position of each
+  //! symbol within a word.
+  static constexpr Word kLowBits = [] {
+    Word mask = 0;
+    for (std::size_t i = 0; i < kWordWidth; i += kSymbolWidth) {
+      mask |= static_cast<Word>(1) << i;
+    }
+    return mask;
+  }();
+
+  /**
+   * Returns the index of the word at which a symbol is stored.
+   *
+   * @param pos The position of the symbol.
+   * @return The index of the word.
+   */
+  [[nodiscard]] inline static std::size_t word_index(const std::size_t pos) {
+    const std::size_t num_block = pos / kNumSymbolsPerBlock;
+    const std::size_t block_pos = pos % kNumSymbolsPerBlock;
+    return num_block * kNumWordsPerBlock + kNumHeaderWords +
+           block_pos / kNumSymbolsPerWord;
+  }
+
+  /**
+   * Returns a word whose bit at the least significant position of each symbol
+   * is set iff the symbol is equal to a given symbol, i.e., its popcount is the
+   * number of occurences of the symbol within the word.
+   *
+   * @param word The word to match.
+   * @param symbol The symbol to match against.
+   * @return The word of matches.
+   */
+  [[nodiscard]] inline static Word matches(const Word word,
+                                           const std::size_t symbol) {
+    // Symbols that are equal to the given symbol become zero, which we detect
+    // by folding the bits of each symbol into its least significant bit.
+    Word x = word ^ (kLowBits * static_cast<Word>(symbol));
+    for (std::size_t shift = 1; shift < kSymbolWidth; shift *= 2) {
+      x |= x >> shift;
+    }
+
+    return ~x & kLowBits;
+  }
+
+  /**
+   * Returns the number of occurences of a symbol up to the start of a block
+   * relative to its superblock, plus the number of occurences within the block
+   * up to a position.
+   *
+   * @param block A pointer to the start of the block.
+   * @param symbol The symbol whose occurences are to be counted.
+   * @param block_pos The position within the block.
+   * @return The number of occurences relative to the superblock.
+   */
+  [[nodiscard]] inline static Word block_rank(const Word* const block,
+                                              const Symbol symbol,
+                                              const std::size_t block_pos) {
+    const Word header = block[symbol / kNumCountersPerWord];
+    Word rank = (header >> ((symbol % kNumCountersPerWord) * kCounterWidth)) &
+                math::setbits<Word>(kCounterWidth);
+
+    const Word* const data = block + kNumHeaderWords;
+    const std::size_t num_word = block_pos / kNumSymbolsPerWord;
+    for (std::size_t i = 0; i < num_word; ++i) {
+      rank += std::popcount(matches(data[i], symbol));
+    }
+
+    // Avoid reading the word past the block if the position is at the start
+    // of a word.
+    const std::size_t word_pos =
+        (block_pos % kNumSymbolsPerWord) * kSymbolWidth;
+    if (word_pos != 0) {
+      rank += std::popcount(matches(data[num_word], symbol) &
+                            math::setbits<Word>(word_pos));
+    }
+
+    return rank;
+  }
+
+  std::size_t _length;
+  std::size_t _num_blocks;
+  StaticVector<Word> _data;
+
+  std::size_t _num_superblocks;
+  StaticVector<Word> _superblock_data;
+
+  std::array<std::size_t, kNumSymbols> _counts;
+};
+
+}  // namespace bitsy
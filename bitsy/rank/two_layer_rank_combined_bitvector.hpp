@@ -5,11 +5,16 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <bit>
 #include <cstddef>
 #include <cstdint>
+#include <utility>
 
+#include "bitsy/bitvector.hpp"
 #include "bitsy/util/math.hpp"
+#include "bitsy/util/numa.hpp"
+#include "bitsy/util/parallel.hpp"
 #include "bitsy/util/static_vector.hpp"
 
 namespace bitsy {
@@ -91,17 +96,21 @@ class TwoLayerRankCombinedBitVector {
    * Constructs an uninitialized bit vector.
    *
    * @param length The number of bits that this bit vector contains.
+   * @param policy The NUMA policy according to which the memory is placed.
    */
-  explicit TwoLayerRankCombinedBitVector(const std::size_t length)
+  explicit TwoLayerRankCombinedBitVector(const std::size_t length,
+                                         const NumaPolicy policy = {})
       : _length(length),
         _num_blocks(math::div_ceil(length, kBlockDataWidth)),
         // We have to pad the data with (virtual) blocks, which allow us to do
         // an binary search (for select) without segfaulting or having to
         // consider an edge case.
         _data(_num_blocks * kNumWordsPerBlock +
-              (kNumBlocksPerSuperblock / 2) * kNumWordsPerBlock),
+                  (kNumBlocksPerSuperblock / 2) * kNumWordsPerBlock,
+              policy),
         _num_superblocks(math::div_ceil(length, kSuperblockDataWidth)),
-        _superblock_data(_num_superblocks) {
+        _superblock_data(_num_superblocks, policy),
+        _num_ones(0) {
     if (_num_blocks > 0) {
       // Fill the last bits with zeros such that the behaivour is predictable,
       // since this bits are nether set explicitly when the length is not a
@@ -109,6 +118,12 @@ class TwoLayerRankCombinedBitVector {
       Word* last_block = _data.data() + (_num_blocks - 1) * kNumWordsPerBlock;
       std::fill_n(last_block, kNumWordsPerBlock, 0);
     }
+
+    // Also fill the padding blocks with zeros, whose headers are written by an
+    // update, such that the data of a bit vector is fully determined by its
+    // bits (e.g., when it is serialized).
+    Word* padding = _data.data() + _num_blocks * kNumWordsPerBlock;
+    std::fill_n(padding, _data.size() - _num_blocks * kNumWordsPerBlock, 0);
   }
 
   /**
@@ -128,6 +143,49 @@ class TwoLayerRankCombinedBitVector {
     update();
   }
 
+  /**
+   * Constructs a copy of another bit vector including its rank information,
+   * whose memory is placed according to a NUMA policy. This can be used to
+   * replicate a bit vector onto each NUMA node for read-only queries.
+   *
+   * @param other The bit vector to copy.
+   * @param policy The NUMA policy according to which the memory is placed.
+   */
+  explicit TwoLayerRankCombinedBitVector(const BitVector& other,
+                                         const NumaPolicy policy)
+      : _length(other._length),
+        _num_blocks(other._num_blocks),
+        _data(other._data.size(), policy),
+        _num_superblocks(other._num_superblocks),
+        _superblock_data(other._superblock_data.size(), policy),
+        _num_ones(other._num_ones) {
+    std::copy_n(other._data.data(), _data.size(), _data.data());
+    std::copy_n(other._superblock_data.data(), _superblock_data.size(),
+                _superblock_data.data());
+  }
+
+  /**
+   * Constructs a bit vector from its bits and rank information, which have been
+   * computed beforehand, e.g., when loading a serialized bit vector.
+   *
+   * @param length The number of bits that this bit vector contains.
+   * @param num_ones The number of bits set to one.
+   * @param data The bits interleaved with the block headers, including the
+   * padding blocks.
+   * @param superblock_data The ranks of the superblocks.
+   */
+  explicit TwoLayerRankCombinedBitVector(const std::size_t length,
+                                         const std::size_t num_ones,
+                                         StaticVector<Word>&& data,
+                                         StaticVector<Word>&& superblock_data)
+      : _length(length),
+        _num_blocks(math::div_ceil(length, kBlockDataWidth)),
+        _data(std::move(data)),
+        _num_superblocks(math::div_ceil(length, kSuperblockDataWidth)),
+        _superblock_data(std::move(superblock_data)),
+        _num_ones(num_ones) {
+  }
+
   // Create the default destructor.
   ~TwoLayerRankCombinedBitVector() = default;
 
@@ -189,6 +247,58 @@ class TwoLayerRankCombinedBitVector {
     _data[num_word] = (_data[num_word] & ~mask) | (-value & mask);
   }
 
+  /**
+   * Atomically sets a bit within this bit vector to zero, such that it can be
+   * called concurrently with other atomic writes to this bit vector.
+   *
+   * @param pos The position of the bit that is to be set to zero.
+   */
+  inline void atomic_unset(const std::size_t pos) {
+    const std::size_t num_block = pos / kBlockDataWidth;
+    const std::size_t block_pos = pos % kBlockDataWidth + kBlockHeaderWidth;
+
+    const std::size_t num_local_word = block_pos / kWordWidth;
+    const std::size_t num_word = num_block * kNumWordsPerBlock + num_local_word;
+
+    const Word mask = static_cast<Word>(1) << (block_pos % kWordWidth);
+    std::atomic_ref<Word>(_data[num_word])
+        .fetch_and(~mask, std::memory_order_relaxed);
+  }
+
+  /**
+   * Atomically sets a bit within this bit vector to one, such that it can be
+   * called concurrently with other atomic writes to this bit vector.
+   *
+   * @param pos The position of the bit that is to be set to one.
+   */
+  inline void atomic_set(const std::size_t pos) {
+    const std::size_t num_block = pos / kBlockDataWidth;
+    const std::size_t block_pos = pos % kBlockDataWidth + kBlockHeaderWidth;
+
+    const std::size_t num_local_word = block_pos / kWordWidth;
+    const std::size_t num_word = num_block * kNumWordsPerBlock + num_local_word;
+
+    const Word mask = static_cast<Word>(1) << (block_pos % kWordWidth);
+    std::atomic_ref<Word>(_data[num_word])
+        .fetch_or(mask, std::memory_order_relaxed);
+  }
+
+  /**
+   * Atomically sets a bit within this bit vector depending on a boolean value,
+   * such that it can be called concurrently with other atomic writes to this
+   * bit vector.
+   *
+   * @param pos The position of the bit that is to be set to one.
+   * @param value Whether to set the bit.
+   */
+  inline void atomic_set(const std::size_t pos, const bool value) {
+    if (value) {
+      atomic_set(pos);
+    } else {
+      atomic_unset(pos);
+    }
+  }
+
   /**
    * Returns whether a bit within this bit vector is set.
    *
@@ -209,9 +319,222 @@ class TwoLayerRankCombinedBitVector {
     return is_set;
   }
 
+  /**
+   * Returns the bits within a range of at most 64 bits, whereby the first bit
+   * of the range is stored at the least significant position.
+   *
+   * As the data of a block is longer than a word, a range spans at most two
+   * blocks, such that the bits are stitched together from at most four words
+   * and the block header in between is skipped.
+   *
+   * @param pos The position of the first bit of the range.
+   * @param len The number of bits within the range, which is at most 64.
+   * @return The bits within the range.
+   */
+  [[nodiscard]] inline Word get_bits(const std::size_t pos,
+                                     const std::size_t len) const {
+    const std::size_t block_pos = pos % kBlockDataWidth;
+    const std::size_t first_len = std::min(len, kBlockDataWidth - block_pos);
+
+    Word bits = block_bits(physical_pos(pos), first_len);
+    if (first_len < len) [[unlikely]] {
+      bits |= block_bits(physical_pos(pos + first_len), len - first_len)
+              << first_len;
+    }
+
+    return bits;
+  }
+
+  /**
+   * Sets the bits within a range of at most 64 bits, whereby the first bit of
+   * the range is taken from the least significant position. Note that the rank
+   * information is not updated.
+   *
+   * @param pos The position of the first bit of the range.
+   * @param len The number of bits within the range, which is at most 64.
+   * @param bits The bits to set the range to.
+   */
+  inline void set_bits(const std::size_t pos,
+                       const std::size_t len,
+                       const Word bits) {
+    const std::size_t block_pos = pos % kBlockDataWidth;
+    const std::size_t first_len = std::min(len, kBlockDataWidth - block_pos);
+
+    set_block_bits(physical_pos(pos), first_len, bits);
+    if (first_len < len) [[unlikely]] {
+      set_block_bits(physical_pos(pos + first_len), len - first_len,
+                     bits >> first_len);
+    }
+  }
+
+  /**
+   * Copies the bits within a range contiguously to a buffer, whereby the first
+   * bit of the range is stored at the least significant position of the first
+   * word. The bits of the last word past the range are set to zero.
+   *
+   * Instead of querying the bits one by one, the data of each block is copied
+   * word by word using shifts, which skip the block headers.
+   *
+   * @param first The position of the first bit of the range.
+   * @param last The position past the last bit of the range.
+   * @param out A pointer to the buffer, which has to hold at least
+   * ceil((last - first) / 64) words.
+   */
+  void copy_bits(const std::size_t first,
+                 const std::size_t last,
+                 Word* const out) const {
+    std::fill_n(out, math::div_ceil(last - first, kWordWidth), 0);
+
+    std::size_t pos = first;
+    std::size_t out_pos = 0;
+    while (pos < last) {
+      // Copy the part of the range that lies within the block of the position.
+      const std::size_t block_len =
+          std::min(last - pos, kBlockDataWidth - pos % kBlockDataWidth);
+      std::size_t src_pos = physical_pos(pos);
+      pos += block_len;
+
+      std::size_t remaining = block_len;
+      while (remaining > 0) {
+        const std::size_t len = std::min(remaining, kWordWidth);
+        const Word bits = block_bits(src_pos, len);
+
+        const std::size_t num_word = out_pos / kWordWidth;
+        const std::size_t word_pos = out_pos % kWordWidth;
+        out[num_word] |= bits << word_pos;
+        if (word_pos + len > kWordWidth) {
+          out[num_word + 1] = bits >> (kWordWidth - word_pos);
+        }
+
+        src_pos += len;
+        out_pos += len;
+        remaining -= len;
+      }
+    }
+  }
+
+  /**
+   * Returns a copy of the bits of this bit vector without the rank
+   * information, whose bits are stored contiguously.
+   *
+   * @return A copy of the bits of this bit vector.
+   */
+  [[nodiscard]] bitsy::BitVector to_bitvector() const {
+    StaticVector<Word> data(math::div_ceil(_length, kWordWidth));
+    copy_bits(0, _length, data.data());
+    return bitsy::BitVector(_length, std::move(data));
+  }
+
+  /**
+   * Returns the concatenation of two bit vectors, whose rank information has to
+   * be up-to-date, including the rank information.
+   *
+   * The full blocks of the first bit vector are copied word by word together
+   * with their headers. If the length of the first bit vector is a multiple of
+   * the block-data width, the blocks of the second bit vector are copied in the
+   * same way, and their headers and the superblock ranks are offset using the
+   * existing rank information instead of counting the ones again. Otherwise,
+   * the remaining bits are copied using word shifts, and only the blocks from
+   * the last block of the first bit vector onward are updated.
+   *
+   * @param first The bit vector whose bits come first.
+   * @param second The bit vector whose bits come second.
+   * @return The concatenation of the two bit vectors.
+   */
+  [[nodiscard]] static BitVector concat(const BitVector& first,
+                                        const BitVector& second) {
+    BitVector result(first._length + second._length);
+
+    const std::size_t num_full_blocks = first._length / kBlockDataWidth;
+    result.assign_blocks(0, first, 0, num_full_blocks, 0);
+
+    if (first._length % kBlockDataWidth == 0) {
+      result.assign_blocks(num_full_blocks, second, 0, second._num_blocks,
+                           first._num_ones);
+      result.finish_update(first._num_ones + second._num_ones);
+    } else {
+      result.copy_bits_from(first, num_full_blocks * kBlockDataWidth,
+                            first._length, num_full_blocks * kBlockDataWidth);
+      result.copy_bits_from(second, 0, second._length, first._length);
+      result.update_from(num_full_blocks, first.block_rank(num_full_blocks));
+    }
+
+    return result;
+  }
+
+  /**
+   * Splits a bit vector, whose rank information has to be up-to-date, into two
+   * bit vectors including the rank information.
+   *
+   * The blocks of the first part are copied word by word together with their
+   * headers, such that its rank information is complete without counting any
+   * ones. If the position is a multiple of the block-data width, the blocks of
+   * the second part are copied in the same way, and their headers and the
+   * superblock ranks are offset using the existing rank information.
+   * Otherwise, the bits of the second part are copied using word shifts and
+   * its rank information is computed from scratch.
+   *
+   * @param bitvector The bit vector to split.
+   * @param pos The position at which to split, which is the length of the
+   * first part and has to be at most the length of the bit vector.
+   * @return The bits before the position and the bits from the position on.
+   */
+  [[nodiscard]] static std::pair<BitVector, BitVector> split(
+      const BitVector& bitvector, const std::size_t pos) {
+    BitVector first(pos);
+    first.assign_blocks(0, bitvector, 0, first._num_blocks, 0);
+
+    // The last block of the first part also contains bits from the second
+    // part, which have to be cleared.
+    if (pos % kBlockDataWidth != 0) {
+      const std::size_t last_pos = first._num_blocks * kBlockDataWidth;
+      for (std::size_t cur_pos = pos; cur_pos < last_pos;
+           cur_pos += kWordWidth) {
+        first.set_bits(cur_pos, std::min(kWordWidth, last_pos - cur_pos), 0);
+      }
+    }
+
+    // A rank query at the end of the bit vector would access the rank of a
+    // superblock past the last one if the length is a multiple of the
+    // superblock-data width.
+    const std::size_t num_first_ones = (pos == bitvector._length)
+                                           ? bitvector._num_ones
+                                           : bitvector.rank1(pos);
+    first.finish_update(num_first_ones);
+
+    BitVector second(bitvector._length - pos);
+    if (pos % kBlockDataWidth == 0) {
+      second.assign_blocks(0, bitvector, pos / kBlockDataWidth,
+                           second._num_blocks, 0);
+      second.finish_update(bitvector._num_ones - num_first_ones);
+    } else {
+      second.copy_bits_from(bitvector, pos, bitvector._length, 0);
+      second.update();
+    }
+
+    return {std::move(first), std::move(second)};
+  }
+
+  /**
+   * Pre-faults the memory of this bit vector in parallel, such that the first
+   * pass over the bits (e.g., when setting them or during an update) does not
+   * have to wait for page faults.
+   *
+   * @param num_threads The number of threads to use.
+   */
+  void prefault(const std::size_t num_threads = 1) {
+    _data.prefault(num_threads);
+    _superblock_data.prefault(num_threads);
+  }
+
   /**
    * Updates this rank data structure such that updates to the bit vector since
    * the initialization or the last update are reflected.
+   *
+   * Besides the block headers and superblock ranks, this also computes the
+   * total number of ones in the same pass over the bits. As a select structure
+   * can derive its samples from the superblock ranks alone, the bits only have
+   * to be streamed from memory once to build both rank and select support.
    */
   void update() {
     const Word* const data = _data.data();
@@ -239,18 +562,68 @@ class TwoLayerRankCombinedBitVector {
                  cur_block_rank;
       cur_block_rank += block_popcount(data + i);
     }
+    _num_ones = cur_rank + cur_block_rank;
 
-    // Also fill the virtual blocks (which is just padding) so that a binary
-    // search for a select query works correctly.
-    for (std::size_t i = num_words; i < _data.size(); i += kNumWordsPerBlock) {
-      const bool is_superblock_word = (i % kNumWordsPerSuperblock) == 0;
+    update_padding(cur_block_rank);
+  }
 
-      if (is_superblock_word) {
-        cur_block_rank = 0;
-      }
+  /**
+   * Updates this rank data structure in parallel such that updates to the bit
+   * vector since the initialization or the last update are reflected.
+   *
+   * Each thread computes the block headers for a consecutive range of
+   * superblocks and the number of ones within each of them. Afterwards, the
+   * superblock ranks are obtained by a prefix sum over these numbers, which
+   * only touches the (small) superblock data.
+   *
+   * @param num_threads The number of threads to use.
+   */
+  void update(const std::size_t num_threads) {
+    if (num_threads <= 1 || _num_superblocks <= 1) {
+      update();
+      return;
+    }
 
-      _data[i] = cur_block_rank;
+    Word* const data = _data.data();
+    parallel::for_each_range(
+        0, _num_superblocks, num_threads,
+        [&](const std::size_t first_superblock,
+            const std::size_t last_superblock) {
+          for (std::size_t num_superblock = first_superblock;
+               num_superblock < last_superblock; ++num_superblock) {
+            const std::size_t first_block =
+                num_superblock * kNumBlocksPerSuperblock;
+            const std::size_t last_block = std::min(
+                _num_blocks, first_block + kNumBlocksPerSuperblock);
+
+            Word cur_block_rank = 0;
+            for (std::size_t num_block = first_block; num_block < last_block;
+                 ++num_block) {
+              Word* const block = data + num_block * kNumWordsPerBlock;
+              *block = (*block & math::setbits<Word>(kHeaderDataWidth,
+                                                     kBlockHeaderWidth)) |
+                       cur_block_rank;
+              cur_block_rank += block_popcount(block);
+            }
+
+            // Temporarily store the number of ones within the superblock,
+            // which is turned into the rank by the prefix sum below.
+            _superblock_data[num_superblock] = cur_block_rank;
+          }
+        });
+
+    Word cur_rank = 0;
+    for (std::size_t num_superblock = 0; num_superblock < _num_superblocks;
+         ++num_superblock) {
+      const Word num_ones = _superblock_data[num_superblock];
+      _superblock_data[num_superblock] = cur_rank;
+      cur_rank += num_ones;
     }
+    _num_ones = cur_rank;
+
+    const Word last_superblock_ones =
+        cur_rank - _superblock_data[_num_superblocks - 1];
+    update_padding(last_superblock_ones);
   }
 
   /**
@@ -361,6 +734,15 @@ class TwoLayerRankCombinedBitVector {
     return _length;
   }
 
+  /**
+   * Returns the number of bits set to one as of the last update.
+   *
+   * @return The number of bits set to one as of the last update.
+   */
+  [[nodiscard]] inline std::size_t num_ones() const {
+    return _num_ones;
+  }
+
   /**
    * Returns the number of superblocks.
    *
@@ -388,6 +770,27 @@ class TwoLayerRankCombinedBitVector {
     return _data.data();
   }
 
+  /**
+   * Returns a pointer to the underlying memory at which the bits are stored,
+   * through which the words including the block headers can be overwritten.
+   * Note that the rank-data has to be updated afterwards.
+   *
+   * @return A pointer to the underlying memory at which the bits are stored.
+   */
+  [[nodiscard]] inline Word* mutable_data() {
+    return _data.data();
+  }
+
+  /**
+   * Returns the number of words at which the bits are stored, including the
+   * words of the padding blocks.
+   *
+   * @return The number of words at which the bits are stored.
+   */
+  [[nodiscard]] inline std::size_t num_words() const {
+    return _data.size();
+  }
+
   /**
    * Returns a pointer to the underlying memory at which the ranks for the
    * superblocks are stored.
@@ -412,12 +815,216 @@ class TwoLayerRankCombinedBitVector {
   }
 
  private:
+  /**
+   * Fills the headers of the virtual blocks (which are just padding) so that a
+   * binary search for a select query works correctly.
+   *
+   * @param cur_block_rank The number of ones within the last superblock.
+   */
+  void update_padding(Word cur_block_rank) {
+    const std::size_t num_words = _num_blocks * kNumWordsPerBlock;
+
+    for (std::size_t i = num_words; i < _data.size(); i += kNumWordsPerBlock) {
+      const bool is_superblock_word = (i % kNumWordsPerSuperblock) == 0;
+
+      if (is_superblock_word) {
+        cur_block_rank = 0;
+      }
+
+      _data[i] = cur_block_rank;
+    }
+  }
+
+  /**
+   * Returns the number of ones up to the start of a block, which is taken from
+   * the superblock rank and the block header.
+   *
+   * @param num_block The block whose rank is to be returned.
+   * @return The number of ones up to the start of the block.
+   */
+  [[nodiscard]] inline Word block_rank(const std::size_t num_block) const {
+    const Word header = _data[num_block * kNumWordsPerBlock];
+    return _superblock_data[num_block / kNumBlocksPerSuperblock] +
+           (header & math::setbits<Word>(kBlockHeaderWidth));
+  }
+
+  /**
+   * Copies consecutive blocks of another bit vector, whose rank information has
+   * to be up-to-date, word by word into this bit vector and rewrites their
+   * headers and the superblock ranks by offsetting the existing ranks.
+   *
+   * If the first block does not start a superblock, the rank of its superblock
+   * has to be set already.
+   *
+   * @param first_block The block of this bit vector to copy to.
+   * @param other The bit vector to copy from.
+   * @param other_first_block The first block of the other bit vector to copy.
+   * @param num_blocks The number of blocks to copy.
+   * @param first_rank The number of ones of this bit vector up to the start of
+   * the first block.
+   */
+  void assign_blocks(const std::size_t first_block,
+                     const BitVector& other,
+                     const std::size_t other_first_block,
+                     const std::size_t num_blocks,
+                     const Word first_rank) {
+    if (num_blocks == 0) {
+      return;
+    }
+
+    std::copy_n(other._data.data() + other_first_block * kNumWordsPerBlock,
+                num_blocks * kNumWordsPerBlock,
+                _data.data() + first_block * kNumWordsPerBlock);
+
+    const Word other_first_rank = other.block_rank(other_first_block);
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+      const std::size_t num_block = first_block + i;
+      const Word rank =
+          first_rank + (other.block_rank(other_first_block + i) -
+                        other_first_rank);
+
+      const std::size_t num_superblock = num_block / kNumBlocksPerSuperblock;
+      if (num_block % kNumBlocksPerSuperblock == 0) {
+        _superblock_data[num_superblock] = rank;
+      }
+
+      Word& header = _data[num_block * kNumWordsPerBlock];
+      header = (header &
+                math::setbits<Word>(kHeaderDataWidth, kBlockHeaderWidth)) |
+               (rank - _superblock_data[num_superblock]);
+    }
+  }
+
+  /**
+   * Copies the bits within a range of another bit vector into this bit vector
+   * using word shifts. Note that the rank information is not updated.
+   *
+   * @param other The bit vector to copy from.
+   * @param first The position of the first bit of the range.
+   * @param last The position past the last bit of the range.
+   * @param pos The position of this bit vector to copy the range to.
+   */
+  void copy_bits_from(const BitVector& other,
+                      std::size_t first,
+                      const std::size_t last,
+                      std::size_t pos) {
+    while (first < last) {
+      const std::size_t len = std::min(kWordWidth, last - first);
+      set_bits(pos, len, other.get_bits(first, len));
+
+      first += len;
+      pos += len;
+    }
+  }
+
+  /**
+   * Updates the rank information from a block onward, whereby the rank
+   * information before the block has to be up-to-date.
+   *
+   * @param first_block The first block to update.
+   * @param cur_rank The number of ones up to the start of the block.
+   */
+  void update_from(const std::size_t first_block, Word cur_rank) {
+    for (std::size_t num_block = first_block; num_block < _num_blocks;
+         ++num_block) {
+      const std::size_t num_superblock = num_block / kNumBlocksPerSuperblock;
+      if (num_block % kNumBlocksPerSuperblock == 0) {
+        _superblock_data[num_superblock] = cur_rank;
+      }
+
+      Word* const block = _data.data() + num_block * kNumWordsPerBlock;
+      *block =
+          (*block & math::setbits<Word>(kHeaderDataWidth, kBlockHeaderWidth)) |
+          (cur_rank - _superblock_data[num_superblock]);
+      cur_rank += block_popcount(block);
+    }
+
+    finish_update(cur_rank);
+  }
+
+  /**
+   * Sets the number of ones and fills the headers of the padding blocks, once
+   * the rank information of all blocks is up-to-date.
+   *
+   * @param num_ones The number of bits set to one.
+   */
+  void finish_update(const std::size_t num_ones) {
+    _num_ones = num_ones;
+
+    const Word last_superblock_ones =
+        (_num_superblocks == 0)
+            ? 0
+            : num_ones - _superblock_data[_num_superblocks - 1];
+    update_padding(last_superblock_ones);
+  }
+
+  /**
+   * Returns the position at which a bit is stored within the underlying memory,
+   * i.e., taking the block headers into account.
+   *
+   * @param pos The position of the bit.
+   * @return The position at which the bit is stored.
+   */
+  [[nodiscard]] inline static std::size_t physical_pos(const std::size_t pos) {
+    const std::size_t num_block = pos / kBlockDataWidth;
+    return num_block * kBlockWidth + pos % kBlockDataWidth + kBlockHeaderWidth;
+  }
+
+  /**
+   * Returns at most 64 bits that are stored consecutively within the data of a
+   * block, i.e., that do not cross a block header.
+   *
+   * @param physical_pos The position at which the first bit is stored.
+   * @param len The number of bits, which is at most 64.
+   * @return The bits.
+   */
+  [[nodiscard]] inline Word block_bits(const std::size_t physical_pos,
+                                       const std::size_t len) const {
+    const std::size_t num_word = physical_pos / kWordWidth;
+    const std::size_t word_pos = physical_pos % kWordWidth;
+
+    Word bits = _data[num_word] >> word_pos;
+    if (word_pos + len > kWordWidth) {
+      bits |= _data[num_word + 1] << (kWordWidth - word_pos);
+    }
+
+    return bits & math::setbits<Word>(len);
+  }
+
+  /**
+   * Sets at most 64 bits that are stored consecutively within the data of a
+   * block, i.e., that do not cross a block header.
+   *
+   * @param physical_pos The position at which the first bit is stored.
+   * @param len The number of bits, which is at most 64.
+   * @param bits The bits to set.
+   */
+  inline void set_block_bits(const std::size_t physical_pos,
+                             const std::size_t len,
+                             Word bits) {
+    const std::size_t num_word = physical_pos / kWordWidth;
+    const std::size_t word_pos = physical_pos % kWordWidth;
+
+    const Word mask = math::setbits<Word>(len);
+    bits &= mask;
+
+    _data[num_word] = (_data[num_word] & ~(mask << word_pos)) |
+                      (bits << word_pos);
+    if (word_pos + len > kWordWidth) {
+      const std::size_t shift = kWordWidth - word_pos;
+      _data[num_word + 1] =
+          (_data[num_word + 1] & ~(mask >> shift)) | (bits >> shift);
+    }
+  }
+
   std::size_t _length;
   std::size_t _num_blocks;
   StaticVector<Word> _data;
 
   std::size_t _num_superblocks;
   StaticVector<Word> _superblock_data;
+
+  std::size_t _num_ones;
 };
 
 }  // namespace bitsy
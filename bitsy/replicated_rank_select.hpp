@@ -0,0 +1,149 @@
+/// A read-only bit vector with rank and select support that is replicated onto
+/// each NUMA node.
+/// @file replicated_rank_select.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "bitsy/rank/two_layer_rank_combined_bitvector.hpp"
+#include "bitsy/select/two_layer_select.hpp"
+#include "bitsy/util/numa.hpp"
+
+namespace bitsy {
+
+/**
+ * A read-only bit vector with rank and select support that is replicated onto
+ * each NUMA node.
+ *
+ * On systems with multiple NUMA nodes, queries to memory that is located on a
+ * remote node take about twice as long. Thus, we store a copy of the bit vector
+ * and the select data structure on each node, such that the query threads can
+ * use the copy that is located on their own node.
+ *
+ * @tparam BitVector The type of rank-combined bit vector to replicate.
+ * @tparam Select The type of select data structure to replicate.
+ */
+template <typename BitVector = TwoLayerRankCombinedBitVector<>,
+          typename Select = TwoLayerSelect<BitVector>>
+class ReplicatedRankSelect {
+ public:
+  /**
+   * A copy of the bit vector and select data structure on a NUMA node.
+   */
+  struct Replica {
+    //! The copy of the bit vector with rank support.
+    BitVector bitvector;
+    //! The copy of the select data structure.
+    Select select;
+
+    /**
+     * Copies a bit vector and its select data structure onto a NUMA node.
+     *
+     * @param other_bitvector The bit vector to copy.
+     * @param other_select The select data structure to copy.
+     * @param node The node onto which to copy.
+     */
+    Replica(const BitVector& other_bitvector,
+            const Select& other_select,
+            const std::size_t node)
+        : bitvector(other_bitvector, NumaPolicy::bind(node)),
+          select(other_select, bitvector, NumaPolicy::bind(node)) {
+    }
+  };
+
+  /**
+   * Constructs a copy of a bit vector and its select data structure on each
+   * NUMA node of the system.
+   *
+   * @param bitvector The bit vector to replicate, whose rank information has to
+   * be up-to-date.
+   * @param select The select data structure of the bit vector to replicate.
+   */
+  explicit ReplicatedRankSelect(const BitVector& bitvector,
+                                const Select& select)
+      : ReplicatedRankSelect(bitvector, select, numa::num_nodes()) {
+  }
+
+  /**
+   * Constructs a copy of a bit vector and its select data structure on each of
+   * the first NUMA nodes of the system.
+   *
+   * @param bitvector The bit vector to replicate, whose rank information has to
+   * be up-to-date.
+   * @param select The select data structure of the bit vector to replicate.
+   * @param num_nodes The number of nodes to replicate onto, which has to be at
+   * least one.
+   * @throws std::invalid_argument If the number of nodes is zero.
+   */
+  explicit ReplicatedRankSelect(const BitVector& bitvector,
+                                const Select& select,
+                                const std::size_t num_nodes) {
+    if (num_nodes == 0) {
+      throw std::invalid_argument("The number of nodes has to be positive.");
+    }
+
+    // The replicas are stored indirectly, since the select data structure
+    // refers to the bit vector and thus a replica must not be moved.
+    _replicas.reserve(num_nodes);
+    for (std::size_t node = 0; node < num_nodes; ++node) {
+      _replicas.push_back(std::make_unique<Replica>(bitvector, select, node));
+    }
+  }
+
+  /**
+   * Returns the replica on the NUMA node of the calling thread.
+   *
+   * Note that determining the node of the calling thread is not free, thus a
+   * query thread that is pinned to a node should fetch its replica once and
+   * reuse it for all its queries.
+   *
+   * @return The replica on the NUMA node of the calling thread.
+   */
+  [[nodiscard]] const Replica& local() const {
+    return replica(numa::current_node());
+  }
+
+  /**
+   * Returns the replica on a NUMA node.
+   *
+   * @param node The node whose replica is to be returned.
+   * @return The replica on the NUMA node.
+   */
+  [[nodiscard]] const Replica& replica(const std::size_t node) const {
+    return *_replicas[node % _replicas.size()];
+  }
+
+  /**
+   * Returns the number of replicas.
+   *
+   * @return The number of replicas.
+   */
+  [[nodiscard]] std::size_t num_replicas() const {
+    return _replicas.size();
+  }
+
+  /**
+   * Returns the used memory space of all replicas in bits.
+   *
+   * @return The used memory space of all replicas in bits.
+   */
+  [[nodiscard]] std::size_t memory_space() const {
+    std::size_t memory_space = 0;
+
+    for (const auto& replica : _replicas) {
+      memory_space += replica->bitvector.memory_space();
+      memory_space += replica->select.memory_space();
+    }
+
+    return memory_space;
+  }
+
+ private:
+  std::vector<std::unique_ptr<Replica>> _replicas;
+};
+
+}  // namespace bitsy
@@ -0,0 +1,306 @@
+/// A select data structure which samples the number of superblock every k-th
+/// one and zero is located in, for a rank data structure that stores the ranks
+/// of superblocks and blocks separately from the bits.
+/// @file sampled_select.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "bitsy/select/word_select.hpp"
+#include "bitsy/util/math.hpp"
+#include "bitsy/util/static_vector.hpp"
+
+namespace bitsy {
+
+/**
+ * A select data structure which samples the number of superblock every k-th one
+ * and zero is located in and requires the two-layer rank data structure to
+ * work.
+ *
+ * A query finds the superblock using the samples and a binary search over the
+ * superblock ranks, then the block using a binary search over the block ranks
+ * of the superblock, which are stored consecutively, and finally the word by a
+ * linear scan over the bits of the block. As neither the samples nor the rank
+ * data structure are stored with the bits, the bits can be stored in memory
+ * that is owned by the caller. For a stride of 32768, we get a space overhead
+ * of ~0.20% on top of the bit vector.
+ *
+ * @tparam Rank The two-layer rank data structure to support.
+ * @tparam Stride The stride with which is sampled.
+ */
+template <typename Rank, std::size_t Stride = 32768>
+class SampledSelect {
+  static_assert(Stride % 2 == 0, "Stride has to be a power of two.");
+
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordWidth = sizeof(Word) * 8;
+
+  static constexpr std::size_t kBlockWidth = Rank::kBlockWidth;
+  static constexpr std::size_t kNumWordsPerBlock = Rank::kNumWordsPerBlock;
+  static constexpr std::size_t kSuperblockWidth = Rank::kSuperblockWidth;
+  static constexpr std::size_t kNumBlocksPerSuperblock =
+      Rank::kNumBlocksPerSuperblock;
+
+ public:
+  //! The stride with which is sampled.
+  static constexpr std::size_t kStride = Stride;
+
+  /**
+   * Constructs and initializes a new select data structure, which supports
+   * select queries for the bit vector of a rank data structure.
+   *
+   * Note that updates to the bit vector are only visible after a call to
+   * update() of the rank data structure and then of this data structure.
+   *
+   * @param rank The rank data structure whose bit vector to support.
+   */
+  explicit SampledSelect(const Rank& rank)
+      : _rank(rank), _zero_samples(0), _one_samples(0) {
+    update();
+  }
+
+  // Create the default destructor.
+  ~SampledSelect() = default;
+
+  // Create the default move constructor/move assignment operator.
+  SampledSelect(SampledSelect&&) noexcept = default;
+  SampledSelect& operator=(SampledSelect&&) noexcept = default;
+
+  // Delete the copy constructor/copy assignment operator as we do not intend
+  // to copy the data structure.
+  SampledSelect(SampledSelect const&) = delete;
+  SampledSelect& operator=(SampledSelect const&) = delete;
+
+  /**
+   * Updates this select data structure such that updates to the associated
+   * rank data structure since the initialization or the last update are
+   * reflected here.
+   */
+  void update() {
+    const std::size_t num_ones = _rank.num_ones();
+    const std::size_t num_zeros = _rank.bitvector().length() - num_ones;
+
+    sample(_one_samples, num_ones, [&](const std::size_t num_superblock) {
+      return one_superblock_rank(num_superblock);
+    });
+    sample(_zero_samples, num_zeros, [&](const std::size_t num_superblock) {
+      return zero_superblock_rank(num_superblock);
+    });
+  }
+
+  /**
+   * Returns the position of the rank-th occurence of zero.
+   *
+   * @param rank The rank of the zero whose position is to be returned.
+   * @return The position of the zero with given rank.
+   */
+  [[nodiscard]] inline Word select0(std::size_t rank) const {
+    const std::size_t num_superblock =
+        find_superblock(_zero_samples, rank, [&](const std::size_t num) {
+          return zero_superblock_rank(num);
+        });
+    rank -= zero_superblock_rank(num_superblock);
+
+    const auto zero_block_rank = [&](const std::size_t num) {
+      return (num % kNumBlocksPerSuperblock) * kBlockWidth -
+             _rank.block_data()[num];
+    };
+    const std::size_t num_block =
+        find_block(num_superblock, rank, zero_block_rank);
+    rank -= zero_block_rank(num_block);
+
+    const Word* data =
+        _rank.bitvector().data() + num_block * kNumWordsPerBlock;
+    std::size_t num_word = 0;
+
+    Word word_rank;
+    while ((word_rank = static_cast<Word>(std::popcount(~*data))) < rank) {
+      num_word += 1;
+      data += 1;
+      rank -= word_rank;
+    }
+
+    return num_block * kBlockWidth + num_word * kWordWidth +
+           word_select1(~*data, rank);
+  }
+
+  /**
+   * Returns the position of the rank-th occurence of one.
+   *
+   * @param rank The rank of the one whose position is to be returned.
+   * @return The position of the one with given rank.
+   */
+  [[nodiscard]] inline Word select1(std::size_t rank) const {
+    const std::size_t num_superblock =
+        find_superblock(_one_samples, rank, [&](const std::size_t num) {
+          return one_superblock_rank(num);
+        });
+    rank -= one_superblock_rank(num_superblock);
+
+    const auto one_block_rank = [&](const std::size_t num) {
+      return static_cast<Word>(_rank.block_data()[num]);
+    };
+    const std::size_t num_block =
+        find_block(num_superblock, rank, one_block_rank);
+    rank -= one_block_rank(num_block);
+
+    const Word* data =
+        _rank.bitvector().data() + num_block * kNumWordsPerBlock;
+    std::size_t num_word = 0;
+
+    Word word_rank;
+    while ((word_rank = static_cast<Word>(std::popcount(*data))) < rank) {
+      num_word += 1;
+      data += 1;
+      rank -= word_rank;
+    }
+
+    return num_block * kBlockWidth + num_word * kWordWidth +
+           word_select1(*data, rank);
+  }
+
+  /**
+   * Returns the used memory space of this data structure in bits.
+   *
+   * Note that it only accounts for the memory that is stored on the heap, i.e.,
+   * the memory that depends on the length of the associated bit vector.
+   *
+   * @return The used memory space of this data structure in bits.
+   */
+  [[nodiscard]] inline std::size_t memory_space() const {
+    return _zero_samples.size() * kWordWidth + _one_samples.size() * kWordWidth;
+  }
+
+ private:
+  [[nodiscard]] inline Word one_superblock_rank(
+      const std::size_t num_superblock) const {
+    return _rank.superblock_data()[num_superblock];
+  }
+
+  [[nodiscard]] inline Word zero_superblock_rank(
+      const std::size_t num_superblock) const {
+    // The zero-rank of the superblock past the last one is the total number
+    // of zeros, whereas the number of bits up to it may exceed the length.
+    if (num_superblock == _rank.num_superblocks()) [[unlikely]] {
+      return _rank.bitvector().length() - _rank.num_ones();
+    }
+
+    return num_superblock * kSuperblockWidth -
+           _rank.superblock_data()[num_superblock];
+  }
+
+  /**
+   * Stores for every k-th occurence of a bit the number of the superblock it is
+   * located in, whereby the occurences are counted using the superblock ranks.
+   *
+   * @tparam SuperblockRank The type of function that returns the rank.
+   * @param samples The samples to fill.
+   * @param num_occurences The total number of occurences of the bit.
+   * @param superblock_rank A function that returns the number of occurences up
+   * to the start of a given superblock.
+   */
+  template <typename SuperblockRank>
+  void sample(StaticVector<Word>& samples,
+              const std::size_t num_occurences,
+              SuperblockRank&& superblock_rank) {
+    // The number of occurences may have changed since the last update.
+    const std::size_t num_samples = num_occurences / kStride + 2;
+    if (samples.size() != num_samples) {
+      samples = StaticVector<Word>(num_samples);
+    }
+
+    const std::size_t num_superblocks = _rank.num_superblocks();
+    if (num_superblocks == 0) {
+      samples[0] = 0;
+      samples[1] = 0;
+      return;
+    }
+
+    // The first occurence is always located in the first superblock.
+    samples[0] = 0;
+
+    std::size_t cur_sample = 1;
+    std::size_t threshold = kStride;
+    for (std::size_t num_superblock = 0; num_superblock < num_superblocks;
+         ++num_superblock) {
+      const Word end_rank = superblock_rank(num_superblock + 1);
+
+      while (threshold <= end_rank) {
+        samples[cur_sample++] = num_superblock;
+        threshold += kStride;
+      }
+    }
+
+    // Store one more sample so that the "next superblock" can be retrieved for
+    // a bit in the last superblock without considering a special case.
+    samples[num_samples - 1] = num_superblocks - 1;
+  }
+
+  /**
+   * Finds the superblock that contains the rank-th occurence of a bit, using
+   * the samples to narrow down the superblocks and a binary search over the
+   * ranks of the superblocks.
+   *
+   * @tparam SuperblockRank The type of function that returns the rank.
+   * @param samples The samples of the bit.
+   * @param rank The rank of the occurence.
+   * @param superblock_rank A function that returns the number of occurences up
+   * to the start of a superblock.
+   * @return The number of the superblock.
+   */
+  template <typename SuperblockRank>
+  [[nodiscard]] static std::size_t find_superblock(
+      const StaticVector<Word>& samples,
+      const std::size_t rank,
+      SuperblockRank&& superblock_rank) {
+    const std::size_t nearest_prev_sample = (rank - 1) / kStride;
+
+    std::size_t num_superblock = samples[nearest_prev_sample];
+    std::size_t length = samples[nearest_prev_sample + 1] - num_superblock + 1;
+    while (length > 1) {
+      const std::size_t half = length / 2;
+      length -= half;
+      num_superblock += (superblock_rank(num_superblock + half) < rank) * half;
+    }
+
+    return num_superblock;
+  }
+
+  /**
+   * Finds the block within a superblock that contains the rank-th occurence of
+   * a bit within the superblock using a binary search over the block ranks.
+   *
+   * @tparam BlockRank The type of function that returns the rank.
+   * @param num_superblock The number of the superblock.
+   * @param rank The rank of the occurence within the superblock.
+   * @param block_rank A function that returns the number of occurences up to
+   * the start of a block within its superblock.
+   * @return The number of the block.
+   */
+  template <typename BlockRank>
+  [[nodiscard]] inline std::size_t find_block(const std::size_t num_superblock,
+                                              const std::size_t rank,
+                                              BlockRank&& block_rank) const {
+    std::size_t num_block = num_superblock * kNumBlocksPerSuperblock;
+    std::size_t length =
+        std::min(_rank.num_blocks(), num_block + kNumBlocksPerSuperblock) -
+        num_block;
+    while (length > 1) {
+      const std::size_t half = length / 2;
+      length -= half;
+      num_block += (block_rank(num_block + half) < rank) * half;
+    }
+
+    return num_block;
+  }
+
+  const Rank& _rank;
+  StaticVector<Word> _zero_samples;
+  StaticVector<Word> _one_samples;
+};
+
+}  // namespace bitsy
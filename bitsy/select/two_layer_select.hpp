@@ -8,9 +8,13 @@
 #include <bit>
 #include <cstddef>
 #include <cstdint>
+#include <span>
+#include <utility>
 
 #include "bitsy/select/word_select.hpp"
 #include "bitsy/type_traits.hpp"
+#include "bitsy/util/numa.hpp"
+#include "bitsy/util/parallel.hpp"
 #include "bitsy/util/static_vector.hpp"
 
 namespace bitsy {
@@ -26,17 +30,29 @@ namespace bitsy {
  * (i.e., we sample every 32768-th one and zero), we get a space overhead of
  * ~0.20% on top of the bit vector.
  *
+ * If only one kind of select query is needed, the samples for the other kind
+ * can be disabled. In that case, they are neither computed nor stored, which
+ * halves the space overhead and saves the corresponding work during an update.
+ * Note that such a data structure does not fulfill the select type trait, as
+ * it only provides one of the two select queries.
+ *
  * @tparam TwoLayerRankCombinedBitVector The rank-combined bit vector to
  * support.
  * @tparam UseBinarySearch Whether to use a binary search to find the
  * superblocks and blocks.
  * @tparam Stride The stride with which is sampled.
+ * @tparam SupportSelect0 Whether to support select queries for zeros.
+ * @tparam SupportSelect1 Whether to support select queries for ones.
  */
 template <type_traits::RankCombinedBitVector TwoLayerRankCombinedBitVector,
           bool UseBinarySearch = true,
-          std::size_t Stride = 32768>
+          std::size_t Stride = 32768,
+          bool SupportSelect0 = true,
+          bool SupportSelect1 = true>
 class TwoLayerSelect {
   static_assert(Stride % 2 == 0, "Stride has to be a power of two.");
+  static_assert(SupportSelect0 || SupportSelect1,
+                "At least one kind of select query has to be supported.");
 
   using BitVector = TwoLayerRankCombinedBitVector;
 
@@ -58,28 +74,120 @@ class TwoLayerSelect {
   static constexpr std::size_t kSuperblockDataWidth =
       BitVector::kSuperblockDataWidth;
 
-  static constexpr std::size_t kStride = Stride;
   static constexpr bool kUseBinarySearch = UseBinarySearch;
 
  public:
+  //! The stride with which is sampled.
+  static constexpr std::size_t kStride = Stride;
+  //! Whether select queries for zeros are supported.
+  static constexpr bool kSupportSelect0 = SupportSelect0;
+  //! Whether select queries for ones are supported.
+  static constexpr bool kSupportSelect1 = SupportSelect1;
+
   /**
    * Constructs and initializes a new select data structure, which supports
-   * select queries for a specified bit vector.
+   * select queries for a specified bit vector, whose rank information has to be
+   * up-to-date.
    *
-   * Note that updates to the bit vector are only visible after a call to
-   * update().
+   * As the number of ones is taken from the last update of the bit vector, a
+   * separate pass over the bits to count them is not necessary.
    *
    * @param bitvector The bit vector to support.
-   * @param num_ones The number of bits set to one in the bit vector.
    */
-  explicit TwoLayerSelect(const BitVector& bitvector,
-                          const std::size_t num_ones)
+  explicit TwoLayerSelect(const BitVector& bitvector)
       : _bitvector(bitvector),
-        _zero_samples((bitvector.length() - num_ones) / kStride + 2),
-        _one_samples(num_ones / kStride + 2) {
+        _zero_samples(num_zero_samples(bitvector)),
+        _one_samples(num_one_samples(bitvector)) {
     update();
   }
 
+  /**
+   * Constructs a copy of another select data structure for a copy of its
+   * associated bit vector, whose memory is placed according to a NUMA policy.
+   * This can be used to replicate a select data structure onto each NUMA node
+   * for read-only queries.
+   *
+   * @param other The select data structure to copy.
+   * @param bitvector The copy of the bit vector that the other select data
+   * structure supports.
+   * @param policy The NUMA policy according to which the memory is placed.
+   */
+  explicit TwoLayerSelect(const TwoLayerSelect& other,
+                          const BitVector& bitvector,
+                          const NumaPolicy policy)
+      : _bitvector(bitvector),
+        _zero_samples(other._zero_samples.size(), policy),
+        _one_samples(other._one_samples.size(), policy) {
+    std::copy_n(other._zero_samples.data(), _zero_samples.size(),
+                _zero_samples.data());
+    std::copy_n(other._one_samples.data(), _one_samples.size(),
+                _one_samples.data());
+  }
+
+  /**
+   * Constructs a select data structure for a bit vector from samples, which
+   * have been computed beforehand, e.g., when loading a serialized select data
+   * structure.
+   *
+   * @param bitvector The bit vector to support.
+   * @param zero_samples The samples for select queries for zeros.
+   * @param one_samples The samples for select queries for ones.
+   */
+  explicit TwoLayerSelect(const BitVector& bitvector,
+                          StaticVector<Word>&& zero_samples,
+                          StaticVector<Word>&& one_samples)
+      : _bitvector(bitvector),
+        _zero_samples(std::move(zero_samples)),
+        _one_samples(std::move(one_samples)) {
+  }
+
+  /**
+   * Constructs a select data structure for a bit vector, whose rank information
+   * has to be up-to-date and whose first bits equal the first bits of the bit
+   * vector that another select data structure supports, e.g., the result of a
+   * concatenation or the first part of a split.
+   *
+   * The samples that are located in superblocks which lie completely within the
+   * common prefix are copied from the other select data structure, and only the
+   * remaining samples are computed from the superblock ranks.
+   *
+   * @param bitvector The bit vector to support.
+   * @param other The select data structure whose samples are reused.
+   * @param prefix_length The number of first bits that both bit vectors have in
+   * common, which has to be at most the length of either bit vector.
+   * @param num_threads The number of threads to use.
+   */
+  explicit TwoLayerSelect(const BitVector& bitvector,
+                          const TwoLayerSelect& other,
+                          const std::size_t prefix_length,
+                          const std::size_t num_threads = 1)
+      : _bitvector(bitvector),
+        _zero_samples(num_zero_samples(bitvector)),
+        _one_samples(num_one_samples(bitvector)) {
+    // The samples up to the rank at the start of the first superblock that is
+    // not completely shared only depend on the shared superblock ranks.
+    const std::size_t num_shared_superblocks =
+        prefix_length / kSuperblockDataWidth;
+    const bool is_last = num_shared_superblocks == bitvector.num_superblocks();
+    const Word shared_rank =
+        is_last ? bitvector.num_ones()
+                : bitvector.superblock_data()[num_shared_superblocks];
+
+    if constexpr (kSupportSelect1) {
+      std::copy_n(other._one_samples.data(), shared_rank / kStride + 1,
+                  _one_samples.data());
+    }
+
+    if constexpr (kSupportSelect0) {
+      const Word shared_zero_rank =
+          num_shared_superblocks * kSuperblockDataWidth - shared_rank;
+      std::copy_n(other._zero_samples.data(), shared_zero_rank / kStride + 1,
+                  _zero_samples.data());
+    }
+
+    update_from(num_shared_superblocks, num_threads);
+  }
+
   // Create the default destructor.
   ~TwoLayerSelect() = default;
 
@@ -95,65 +203,29 @@ class TwoLayerSelect {
   /**
    * Updates this select data structure such that updates to the associated bit
    * vector since the initialization or the last update are reflected here.
+   *
+   * The samples are derived from the superblock ranks of the bit vector alone,
+   * i.e., the rank information of the bit vector has to be updated beforehand,
+   * but the bits themselves are not accessed.
    */
   void update() {
-    if (_bitvector.length() == 0) {
-      return;
-    }
-
-    std::size_t cur_one = 0;
-    std::size_t cur_zero = 0;
-
-    std::size_t total_ones = 0;
-    std::size_t total_zeros = 0;
-
-    std::size_t threshold_one = 0;
-    std::size_t threshold_zero = 0;
-    const auto handle_block = [&](const std::size_t num_block,
-                                  const std::size_t num_ones,
-                                  const std::size_t num_zeros) {
-      total_ones += num_ones;
-      total_zeros += num_zeros;
-
-      if (total_ones >= threshold_one) [[unlikely]] {
-        const std::size_t num_superblock =
-            (num_block * kBlockDataWidth) / kSuperblockDataWidth;
-        _one_samples[cur_one] = num_superblock;
-
-        cur_one += 1;
-        threshold_one += kStride;
-      }
-
-      if (total_zeros >= threshold_zero) [[unlikely]] {
-        const std::size_t num_superblock =
-            (num_block * kBlockDataWidth) / kSuperblockDataWidth;
-        _zero_samples[cur_zero] = num_superblock;
-
-        cur_zero += 1;
-        threshold_zero += kStride;
-      }
-    };
-
-    for (std::size_t num_block = 0; num_block < _bitvector.num_blocks() - 1;
-         ++num_block) {
-      const std::size_t num_ones = _bitvector.block_popcount(num_block);
-      const std::size_t num_zeros = kBlockDataWidth - num_ones;
-      handle_block(num_block, num_ones, num_zeros);
-    }
-
-    // Treat the last block specially, as the number of zeros cannot be computed
-    // in the same way as for the other blocks due to padding.
-    const std::size_t num_last_block = _bitvector.num_blocks() - 1;
-    const std::size_t wrong_zeros =
-        _bitvector.num_blocks() * kBlockDataWidth - _bitvector.length();
-    const std::size_t num_ones = _bitvector.block_popcount(num_last_block);
-    const std::size_t num_zeros = kBlockDataWidth - num_ones - wrong_zeros;
-    handle_block(num_last_block, num_ones, num_zeros);
+    update(1);
+  }
 
-    // Store one more sample so that the "next superblock" can be retrieved for
-    // a bit in the last superblock without considering a special case.
-    _one_samples[cur_one] = _bitvector.num_superblocks() - 1;
-    _zero_samples[cur_zero] = _bitvector.num_superblocks() - 1;
+  /**
+   * Updates this select data structure in parallel such that updates to the
+   * associated bit vector since the initialization or the last update are
+   * reflected here.
+   *
+   * The superblocks are split into consecutive ranges, one per thread. As the
+   * superblock ranks already form a prefix sum over the number of ones, each
+   * thread can compute the first sample within its range directly and then
+   * fill the samples of its range independently of the other threads.
+   *
+   * @param num_threads The number of threads to use.
+   */
+  void update(const std::size_t num_threads) {
+    update_from(0, num_threads);
   }
 
   /**
@@ -162,7 +234,9 @@ class TwoLayerSelect {
    * @param rank The rank of the first zero whose position is to be returned.
    * @return The position of the first zero with given rank.
    */
-  [[nodiscard]] inline Word select0(std::size_t rank) const {
+  [[nodiscard]] inline Word select0(std::size_t rank) const
+    requires kSupportSelect0
+  {
     // Step 1: Fetch the range of superblocks containing the position we are
     // looking for using the explicitly stored samples.
     const std::size_t nearest_prev_sample = (rank - 1) / kStride;
@@ -287,7 +361,9 @@ class TwoLayerSelect {
    * @param rank The rank of the first one whose position is to be returned.
    * @return The position of the first one with given rank.
    */
-  [[nodiscard]] inline Word select1(std::size_t rank) const {
+  [[nodiscard]] inline Word select1(std::size_t rank) const
+    requires kSupportSelect1
+  {
     // Step 1: Fetch the range of superblocks containing the position we are
     // looking for using the explicitly stored samples.
     const std::size_t nearest_prev_sample = (rank - 1) / kStride;
@@ -399,6 +475,26 @@ class TwoLayerSelect {
            word_select1(word, rank) - kBlockHeaderWidth;
   }
 
+  /**
+   * Returns the samples for select queries for zeros, i.e., the number of the
+   * superblock in which every k-th zero is located.
+   *
+   * @return The samples for select queries for zeros.
+   */
+  [[nodiscard]] inline std::span<const Word> zero_samples() const {
+    return {_zero_samples.data(), _zero_samples.size()};
+  }
+
+  /**
+   * Returns the samples for select queries for ones, i.e., the number of the
+   * superblock in which every k-th one is located.
+   *
+   * @return The samples for select queries for ones.
+   */
+  [[nodiscard]] inline std::span<const Word> one_samples() const {
+    return {_one_samples.data(), _one_samples.size()};
+  }
+
   /**
    * Returns the used memory space of this data structure in bits.
    *
@@ -412,6 +508,146 @@ class TwoLayerSelect {
   }
 
  private:
+  /**
+   * Returns the number of samples for select queries for zeros, which is zero
+   * if they are not supported.
+   *
+   * @param bitvector The bit vector to support.
+   * @return The number of samples for select queries for zeros.
+   */
+  [[nodiscard]] static std::size_t num_zero_samples(
+      const BitVector& bitvector) {
+    // Only allocate the samples for the kinds of select queries that are
+    // supported, since the other samples are never computed.
+    if constexpr (kSupportSelect0) {
+      return (bitvector.length() - bitvector.num_ones()) / kStride + 2;
+    } else {
+      return 0;
+    }
+  }
+
+  /**
+   * Returns the number of samples for select queries for ones, which is zero if
+   * they are not supported.
+   *
+   * @param bitvector The bit vector to support.
+   * @return The number of samples for select queries for ones.
+   */
+  [[nodiscard]] static std::size_t num_one_samples(const BitVector& bitvector) {
+    if constexpr (kSupportSelect1) {
+      return bitvector.num_ones() / kStride + 2;
+    } else {
+      return 0;
+    }
+  }
+
+  /**
+   * Computes the samples that are located in a superblock from a given one
+   * onward, whereby the samples located in the superblocks before have to be
+   * up-to-date.
+   *
+   * @param first_superblock The first superblock whose samples are computed.
+   * @param num_threads The number of threads to use.
+   */
+  void update_from(const std::size_t first_superblock,
+                   const std::size_t num_threads) {
+    // The number of ones of the bit vector might have changed since the
+    // samples have been allocated, in which case they have to be reallocated.
+    if (_zero_samples.size() != num_zero_samples(_bitvector)) {
+      _zero_samples = StaticVector<Word>(num_zero_samples(_bitvector));
+    }
+    if (_one_samples.size() != num_one_samples(_bitvector)) {
+      _one_samples = StaticVector<Word>(num_one_samples(_bitvector));
+    }
+
+    // An empty bit vector has no superblocks, such that both samples refer to
+    // the first superblock as for a bit vector with a single superblock.
+    if (_bitvector.length() == 0) {
+      std::fill_n(_zero_samples.data(), _zero_samples.size(), 0);
+      std::fill_n(_one_samples.data(), _one_samples.size(), 0);
+      return;
+    }
+
+    const std::size_t num_superblocks = _bitvector.num_superblocks();
+    const Word* superblock_data = _bitvector.superblock_data();
+
+    if constexpr (kSupportSelect1) {
+      const std::size_t num_ones = _bitvector.num_ones();
+
+      sample(_one_samples, first_superblock, num_threads,
+             [&](const std::size_t num_superblock) -> Word {
+               if (num_superblock == num_superblocks) [[unlikely]] {
+                 return num_ones;
+               }
+
+               return superblock_data[num_superblock];
+             });
+    }
+
+    if constexpr (kSupportSelect0) {
+      const std::size_t num_zeros =
+          _bitvector.length() - _bitvector.num_ones();
+
+      sample(_zero_samples, first_superblock, num_threads,
+             [&](const std::size_t num_superblock) -> Word {
+               if (num_superblock == num_superblocks) [[unlikely]] {
+                 return num_zeros;
+               }
+
+               return num_superblock * kSuperblockDataWidth -
+                      superblock_data[num_superblock];
+             });
+    }
+  }
+
+  /**
+   * Stores for every k-th occurence of a bit the number of the superblock it is
+   * located in, whereby the occurences are counted using the superblock ranks.
+   *
+   * @tparam SuperblockRank The type of function that returns the rank.
+   * @param samples The samples to fill.
+   * @param first_superblock The first superblock whose samples are stored.
+   * @param num_threads The number of threads to use.
+   * @param superblock_rank A function that returns the number of occurences up
+   * to the start of a given superblock, or the total number of occurences when
+   * given the number of superblocks.
+   */
+  template <typename SuperblockRank>
+  void sample(StaticVector<Word>& samples,
+              const std::size_t first_superblock,
+              const std::size_t num_threads,
+              SuperblockRank&& superblock_rank) {
+    const std::size_t num_superblocks = _bitvector.num_superblocks();
+
+    // The first occurence is always located in the first superblock.
+    samples[0] = 0;
+
+    parallel::for_each_range(
+        first_superblock, num_superblocks, num_threads,
+        [&](const std::size_t first, const std::size_t last_superblock) {
+          // The number of samples before the range follows directly from the
+          // rank at the start of the range.
+          const Word start_rank = superblock_rank(first);
+          std::size_t cur_sample = start_rank / kStride + 1;
+          std::size_t threshold = cur_sample * kStride;
+
+          for (std::size_t num_superblock = first;
+               num_superblock < last_superblock; ++num_superblock) {
+            const Word end_rank = superblock_rank(num_superblock + 1);
+
+            while (threshold <= end_rank) {
+              samples[cur_sample++] = num_superblock;
+              threshold += kStride;
+            }
+          }
+        });
+
+    // Store one more sample so that the "next superblock" can be retrieved for
+    // a bit in the last superblock without considering a special case.
+    samples[superblock_rank(num_superblocks) / kStride + 1] =
+        num_superblocks - 1;
+  }
+
   const BitVector& _bitvector;
   StaticVector<Word> _zero_samples;
   StaticVector<Word> _one_samples;
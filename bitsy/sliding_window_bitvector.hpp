@@ -0,0 +1,501 @@
+/// A bit vector over a sliding window of the last appended bits with rank and
+/// select support, which recycles the memory of expired superblocks.
+/// @file sliding_window_bitvector.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "bitsy/select/word_select.hpp"
+#include "bitsy/util/math.hpp"
+#include "bitsy/util/static_vector.hpp"
+
+namespace bitsy {
+
+/**
+ * A bit vector to which bits are appended like a stream and that supports rank
+ * and select queries over a sliding window of the last appended bits.
+ *
+ * The bits and block headers use the same interleaved layout as the growable
+ * bit vector. However, the superblocks are stored in a ring buffer that holds
+ * just enough superblocks to cover the window and the superblock that is
+ * currently appended to. When the first block of a superblock is started, the
+ * superblock that occupied its slot in the ring has expired and is recycled,
+ * i.e., its words are zeroed and its rank is set to the number of ones that
+ * have been appended so far. Since the ranks of the superblocks count all ones
+ * that have ever been appended, a query within the window is answered as the
+ * difference of two ranks in constant time, and the expiry takes amortized
+ * constant time per appended bit.
+ *
+ * The positions of the queries are relative to the start of the window, i.e.,
+ * position zero refers to the oldest bit of the window.
+ *
+ * @tparam BlockWidth The size of each block in bits.
+ * @tparam BlockHeaderWidth The size of the block header in bits.
+ */
+template <std::size_t BlockWidth = 512, std::size_t BlockHeaderWidth = 14>
+class SlidingWindowBitVector {
+  static_assert(BlockWidth % 2 == 0, "Block width has to be a power of two.");
+  static_assert(BlockWidth > 64, "Block width has to greater than 64 bits.");
+  static_assert(BlockHeaderWidth <= 64,
+                "Block header has to be a at most 64 bits wide.");
+  static_assert(math::pow2(BlockHeaderWidth) > BlockWidth,
+                "Superblock width has to be greater than the block width.");
+
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordWidth = sizeof(Word) * 8;
+
+ public:
+  //! The width in bits of a block.
+  static constexpr std::size_t kBlockWidth = BlockWidth;
+  //! The width in bits of the header that is stored in the first word of a
+  //! block.
+  static constexpr std::size_t kBlockHeaderWidth = BlockHeaderWidth;
+  //! The width in bits of the data that is stored in a block.
+  static constexpr std::size_t kBlockDataWidth =
+      kBlockWidth - kBlockHeaderWidth;
+  //! The number of words per block.
+  static constexpr std::size_t kNumWordsPerBlock = kBlockWidth / kWordWidth;
+
+  //! The width in bits of a superblock.
+  static constexpr std::size_t kSuperblockWidth = math::pow2(BlockHeaderWidth);
+  //! The number of blocks per superblock.
+  static constexpr std::size_t kNumBlocksPerSuperblock =
+      kSuperblockWidth / kBlockWidth;
+  //! The number of words per superblock.
+  static constexpr std::size_t kNumWordsPerSuperblock =
+      kSuperblockWidth / kWordWidth;
+  //! The width in bits of the data that is stored in a superblock.
+  static constexpr std::size_t kSuperblockDataWidth =
+      kSuperblockWidth - kNumBlocksPerSuperblock * kBlockHeaderWidth;
+
+  /**
+   * Constructs an empty bit vector.
+   *
+   * @param window_length The maximum number of last appended bits that can be
+   * queried.
+   */
+  explicit SlidingWindowBitVector(const std::size_t window_length)
+      : _window_length(window_length),
+        // The window overlaps with at most this many superblocks, plus the
+        // superblock that is currently appended to.
+        _num_superblocks(math::div_ceil(window_length, kSuperblockDataWidth) +
+                         1),
+        _data(_num_superblocks * kNumWordsPerSuperblock),
+        _superblock_ranks(_num_superblocks),
+        _length(0),
+        _num_ones(0),
+        _cur_superblock_ones(0) {
+    start_block();
+  }
+
+  // Create the default destructor.
+  ~SlidingWindowBitVector() = default;
+
+  // Create the default move constructor/move assignment operator.
+  SlidingWindowBitVector(SlidingWindowBitVector&&) noexcept = default;
+  SlidingWindowBitVector& operator=(SlidingWindowBitVector&&) noexcept =
+      default;
+
+  // Delete the copy constructor/copy assignment operator as we do not intend
+  // to copy the bit vector.
+  SlidingWindowBitVector(SlidingWindowBitVector const&) = delete;
+  SlidingWindowBitVector& operator=(SlidingWindowBitVector const&) = delete;
+
+  /**
+   * Appends a bit to the end of this bit vector, which moves the window by one
+   * bit if it is full.
+   *
+   * @param value Whether the bit is set.
+   */
+  inline void push_back(const bool value) {
+    append_word(static_cast<Word>(value), 1);
+  }
+
+  /**
+   * Appends the least significant bits of a word to the end of this bit vector,
+   * whereby the least significant bit is appended first.
+   *
+   * @param word The word whose bits are to be appended.
+   * @param num_bits The number of bits to append, which has to be at most 64.
+   */
+  void append_word(Word word, std::size_t num_bits) {
+    if (num_bits < kWordWidth) {
+      word &= math::setbits<Word>(num_bits);
+    }
+
+    while (num_bits > 0) {
+      // Append as many bits as fit into the current block, which are spread
+      // over at most two words.
+      const std::size_t block_pos = _length % kBlockDataWidth;
+      const std::size_t num_appended =
+          std::min(num_bits, kBlockDataWidth - block_pos);
+      const Word bits = (num_appended < kWordWidth)
+                            ? (word & math::setbits<Word>(num_appended))
+                            : word;
+
+      Word* const data = block_data(_length / kBlockDataWidth);
+      const std::size_t data_pos = block_pos + kBlockHeaderWidth;
+      const std::size_t num_word = data_pos / kWordWidth;
+      const std::size_t word_pos = data_pos % kWordWidth;
+
+      data[num_word] |= bits << word_pos;
+      if (word_pos + num_appended > kWordWidth) {
+        data[num_word + 1] |= bits >> (kWordWidth - word_pos);
+      }
+
+      const std::size_t num_ones = std::popcount(bits);
+      _length += num_appended;
+      _num_ones += num_ones;
+      _cur_superblock_ones += num_ones;
+
+      // Start the next block as soon as the current one is full, so that the
+      // block containing the next bit always has a valid header.
+      if (_length % kBlockDataWidth == 0) {
+        start_block();
+      }
+
+      word = (num_appended < kWordWidth) ? (word >> num_appended) : 0;
+      num_bits -= num_appended;
+    }
+  }
+
+  /**
+   * Appends bits set to zero to the end of this bit vector, which takes time
+   * linear in the number of blocks rather than bits, as the bits of a recycled
+   * superblock are zero already.
+   *
+   * @param num_bits The number of bits to append.
+   */
+  void append_zeros(std::size_t num_bits) {
+    while (num_bits > 0) {
+      const std::size_t num_appended =
+          std::min(num_bits, kBlockDataWidth - _length % kBlockDataWidth);
+
+      _length += num_appended;
+      if (_length % kBlockDataWidth == 0) {
+        start_block();
+      }
+
+      num_bits -= num_appended;
+    }
+  }
+
+  /**
+   * Returns whether a bit within the window is set.
+   *
+   * @param pos The position of the bit within the window.
+   * @return Whether the bit is set.
+   */
+  [[nodiscard]] inline bool is_set(const std::size_t pos) const {
+    const std::size_t global_pos = window_start() + pos;
+    const std::size_t block_pos =
+        global_pos % kBlockDataWidth + kBlockHeaderWidth;
+    const Word word =
+        block_data(global_pos / kBlockDataWidth)[block_pos / kWordWidth];
+    return ((word >> (block_pos % kWordWidth)) & static_cast<Word>(1)) == 1;
+  }
+
+  /**
+   * Returns the number of bits equal to zero within the window up to a
+   * position.
+   *
+   * @param pos The position within the window up to which bits are to be taken
+   * into account, which has to be at most the length of the window.
+   * @return The number of bits equal to zero up to the position.
+   */
+  [[nodiscard]] inline Word rank0(const std::size_t pos) const {
+    return static_cast<Word>(pos) - rank1(pos);
+  }
+
+  /**
+   * Returns the number of bits equal to one within the window up to a
+   * position.
+   *
+   * @param pos The position within the window up to which bits are to be taken
+   * into account, which has to be at most the length of the window.
+   * @return The number of bits equal to one up to the position.
+   */
+  [[nodiscard]] inline Word rank1(const std::size_t pos) const {
+    const std::size_t start = window_start();
+    return global_rank1(start + pos) - global_rank1(start);
+  }
+
+  /**
+   * Returns the position within the window of the rank-th occurence of zero
+   * within the window.
+   *
+   * @param rank The rank of the zero whose position is to be returned, which
+   * has to be at most the number of zeros within the window.
+   * @return The position of the zero with given rank.
+   */
+  [[nodiscard]] inline Word select0(const std::size_t rank) const {
+    const auto superblock_rank = [&](const std::size_t num_superblock) {
+      return num_superblock * kSuperblockDataWidth -
+             _superblock_ranks[num_superblock % _num_superblocks];
+    };
+    const auto block_rank = [](const std::size_t num_block,
+                               const Word* const data) {
+      return (num_block % kNumBlocksPerSuperblock) * kBlockDataWidth -
+             (*data & math::setbits<Word>(kBlockHeaderWidth));
+    };
+
+    const std::size_t start = window_start();
+    std::size_t global_rank = start - global_rank1(start) + rank;
+    const auto [num_block, data] =
+        find_block(global_rank, superblock_rank, block_rank);
+
+    // Find the word within the block using a linear search.
+    Word num_word = 0;
+    Word word = *data | math::setbits<Word>(kBlockHeaderWidth);
+    Word word_rank;
+    while ((word_rank = std::popcount(~word)) < global_rank) {
+      num_word += 1;
+      word = data[num_word];
+      global_rank -= word_rank;
+    }
+
+    return num_block * kBlockDataWidth + num_word * kWordWidth +
+           word_select1(~word, global_rank) - kBlockHeaderWidth - start;
+  }
+
+  /**
+   * Returns the position within the window of the rank-th occurence of one
+   * within the window.
+   *
+   * @param rank The rank of the one whose position is to be returned, which
+   * has to be at most the number of ones within the window.
+   * @return The position of the one with given rank.
+   */
+  [[nodiscard]] inline Word select1(const std::size_t rank) const {
+    const auto superblock_rank = [&](const std::size_t num_superblock) {
+      return _superblock_ranks[num_superblock % _num_superblocks];
+    };
+    const auto block_rank = [](std::size_t, const Word* const data) {
+      return *data & math::setbits<Word>(kBlockHeaderWidth);
+    };
+
+    const std::size_t start = window_start();
+    std::size_t global_rank = global_rank1(start) + rank;
+    const auto [num_block, data] =
+        find_block(global_rank, superblock_rank, block_rank);
+
+    // Find the word within the block using a linear search.
+    Word num_word = 0;
+    Word word = *data & ~math::setbits<Word>(kBlockHeaderWidth);
+    Word word_rank;
+    while ((word_rank = std::popcount(word)) < global_rank) {
+      num_word += 1;
+      word = data[num_word];
+      global_rank -= word_rank;
+    }
+
+    return num_block * kBlockDataWidth + num_word * kWordWidth +
+           word_select1(word, global_rank) - kBlockHeaderWidth - start;
+  }
+
+  /**
+   * Returns the number of bits set to one within the window.
+   *
+   * @return The number of bits set to one within the window.
+   */
+  [[nodiscard]] inline std::size_t num_ones() const {
+    return _num_ones - global_rank1(window_start());
+  }
+
+  /**
+   * Returns the number of bits within the window, which is the window length
+   * once enough bits have been appended.
+   *
+   * @return The number of bits within the window.
+   */
+  [[nodiscard]] inline std::size_t window_length() const {
+    return std::min(_length, _window_length);
+  }
+
+  /**
+   * Returns the number of bits that have been appended before the window,
+   * i.e., the position of the first bit of the window among all appended bits.
+   *
+   * @return The number of bits that have been appended before the window.
+   */
+  [[nodiscard]] inline std::size_t window_start() const {
+    return _length - window_length();
+  }
+
+  /**
+   * Returns the number of bits that have been appended, including the bits
+   * that have expired.
+   *
+   * @return The number of bits that have been appended.
+   */
+  [[nodiscard]] inline std::size_t length() const {
+    return _length;
+  }
+
+  /**
+   * Returns the used memory space of this data structure in bits.
+   *
+   * Note that it only accounts for the memory that is stored on the heap,
+   * i.e., the memory that depends on the length of the window.
+   *
+   * @return The used memory space of this data structure in bits.
+   */
+  [[nodiscard]] inline std::size_t memory_space() const {
+    return _data.size() * kWordWidth + _superblock_ranks.size() * kWordWidth;
+  }
+
+ private:
+  [[nodiscard]] inline Word* block_data(const std::size_t num_block) {
+    const std::size_t num_superblock = num_block / kNumBlocksPerSuperblock;
+    return _data.data() +
+           (num_superblock % _num_superblocks) * kNumWordsPerSuperblock +
+           (num_block % kNumBlocksPerSuperblock) * kNumWordsPerBlock;
+  }
+
+  [[nodiscard]] inline const Word* block_data(
+      const std::size_t num_block) const {
+    const std::size_t num_superblock = num_block / kNumBlocksPerSuperblock;
+    return _data.data() +
+           (num_superblock % _num_superblocks) * kNumWordsPerSuperblock +
+           (num_block % kNumBlocksPerSuperblock) * kNumWordsPerBlock;
+  }
+
+  /**
+   * Returns the number of ones that have been appended before a position,
+   * whose superblock has not expired.
+   *
+   * @param pos The position among all appended bits.
+   * @return The number of ones before the position.
+   */
+  [[nodiscard]] inline Word global_rank1(const std::size_t pos) const {
+    const std::size_t block_pos = pos % kBlockDataWidth + kBlockHeaderWidth;
+    const std::size_t num_word = block_pos / kWordWidth;
+    const std::size_t word_pos = block_pos % kWordWidth;
+
+    // Fetch the rank of the superblock and the rank of the block within the
+    // superblock, which is stored in the header of the block.
+    const std::size_t num_superblock = pos / kSuperblockDataWidth;
+    Word rank = _superblock_ranks[num_superblock % _num_superblocks];
+
+    const Word* const data = block_data(pos / kBlockDataWidth);
+    const Word first_word = *data;
+    rank += first_word & math::setbits<Word>(kBlockHeaderWidth);
+
+    // Count the number of ones within the block up to the bit like the
+    // growable bit vector does.
+    if (num_word == 0) [[unlikely]] {
+      // Reduce the shift modulo the word width, as shifting by the word width
+      // is undefined, and discard the count in that case instead.
+      const std::size_t shift =
+          ((kWordWidth + kBlockHeaderWidth) - word_pos) % kWordWidth;
+      rank += std::popcount((first_word >> kBlockHeaderWidth) << shift) *
+              (word_pos != kBlockHeaderWidth);
+    } else {
+      rank += std::popcount(first_word >> kBlockHeaderWidth);
+
+      std::size_t i = 1;
+      while (i < num_word) {
+        rank += std::popcount(data[i++]);
+      }
+
+      const std::size_t shift = (kWordWidth - word_pos) % kWordWidth;
+      rank += std::popcount(data[i] << shift) * (word_pos != 0);
+    }
+
+    return rank;
+  }
+
+  /**
+   * Starts the block that contains the next bit by writing its header and, if
+   * it is the first block of a superblock, recycling the slot of the superblock
+   * that has expired.
+   */
+  void start_block() {
+    const std::size_t num_block = _length / kBlockDataWidth;
+
+    if (num_block % kNumBlocksPerSuperblock == 0) {
+      // The bits are appended by or-ing them into the words, thus they have to
+      // be zero initially.
+      const std::size_t slot =
+          (num_block / kNumBlocksPerSuperblock) % _num_superblocks;
+      std::fill_n(_data.data() + slot * kNumWordsPerSuperblock,
+                  kNumWordsPerSuperblock, 0);
+
+      _superblock_ranks[slot] = _num_ones;
+      _cur_superblock_ones = 0;
+    }
+
+    *block_data(num_block) = _cur_superblock_ones;
+  }
+
+  /**
+   * Finds the block that contains the occurence of a bit with a given rank
+   * among all appended bits, which has to be located within the window, using
+   * binary searches over the superblock ranks and block headers.
+   *
+   * @param rank The rank of the occurence, which is reduced to the rank within
+   * the block.
+   * @param superblock_rank A function that returns the number of occurences up
+   * to the start of a superblock.
+   * @param block_rank A function that returns the number of occurences up to
+   * the start of a block within its superblock.
+   * @return The number of the block and a pointer to its data.
+   */
+  template <typename SuperblockRank, typename BlockRank>
+  [[nodiscard]] inline std::pair<std::size_t, const Word*> find_block(
+      std::size_t& rank,
+      SuperblockRank&& superblock_rank,
+      BlockRank&& block_rank) const {
+    // Step 1: Find the superblock using a binary search over the superblocks
+    // that overlap with the window.
+    const std::size_t num_last_block = _length / kBlockDataWidth;
+    std::size_t num_superblock = window_start() / kSuperblockDataWidth;
+    std::size_t num_last_superblock = num_last_block / kNumBlocksPerSuperblock;
+    while (num_superblock < num_last_superblock) {
+      const std::size_t mid = (num_superblock + num_last_superblock + 1) / 2;
+
+      if (superblock_rank(mid) < rank) {
+        num_superblock = mid;
+      } else {
+        num_last_superblock = mid - 1;
+      }
+    }
+
+    rank -= superblock_rank(num_superblock);
+
+    // Step 2: Find the block within the superblock using a binary search over
+    // the blocks that have been started.
+    std::size_t num_block = num_superblock * kNumBlocksPerSuperblock;
+    std::size_t num_last_superblock_block =
+        std::min(num_last_block, num_block + kNumBlocksPerSuperblock - 1);
+    while (num_block < num_last_superblock_block) {
+      const std::size_t mid = (num_block + num_last_superblock_block + 1) / 2;
+
+      if (block_rank(mid, block_data(mid)) < rank) {
+        num_block = mid;
+      } else {
+        num_last_superblock_block = mid - 1;
+      }
+    }
+
+    const Word* const data = block_data(num_block);
+    rank -= block_rank(num_block, data);
+    return {num_block, data};
+  }
+
+  std::size_t _window_length;
+  std::size_t _num_superblocks;
+  StaticVector<Word> _data;
+  StaticVector<Word> _superblock_ranks;
+
+  std::size_t _length;
+  std::size_t _num_ones;
+  Word _cur_superblock_ones;
+};
+
+}  // namespace bitsy
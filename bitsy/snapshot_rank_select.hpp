@@ -0,0 +1,265 @@
+/// A bit vector with rank and select support that is rebuilt in the background
+/// while queries are answered using the last published snapshot.
+/// @file snapshot_rank_select.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include "bitsy/rank/two_layer_rank_combined_bitvector.hpp"
+#include "bitsy/select/two_layer_select.hpp"
+
+namespace bitsy {
+
+/**
+ * A bit vector with rank and select support that is rebuilt in the background
+ * while queries are answered using the last published snapshot.
+ *
+ * A snapshot consists of a bit vector and its select data structure, which are
+ * immutable once published. Readers enter a read-side critical section to
+ * obtain the current snapshot, which they can query without any further
+ * synchronization. A writer builds the next snapshot in a background thread
+ * and publishes it with an atomic pointer swap, so that queries never have to
+ * wait for a rebuild.
+ *
+ * The previous snapshot is reclaimed using an epoch-based scheme: each reader
+ * owns a slot in which it announces the epoch at which it entered its critical
+ * section. After publishing a new snapshot, the writer advances the epoch and
+ * waits until no reader is still in an older epoch before freeing the previous
+ * snapshot. Thus, readers never block, and at most two snapshots are alive at
+ * any time besides the one that is being built.
+ *
+ * Note that there must only be one writer, i.e., rebuild(), publish() and
+ * wait() must not be called concurrently. Furthermore, each reader has to use
+ * its own reader number.
+ *
+ * @tparam BitVector The type of rank-combined bit vector to use.
+ * @tparam Select The type of select data structure to use.
+ */
+template <typename BitVector = TwoLayerRankCombinedBitVector<>,
+          typename Select = TwoLayerSelect<BitVector>>
+class SnapshotRankSelect {
+  // The epoch that a reader announces when it is not in a critical section.
+  static constexpr std::uint64_t kQuiescent = 0;
+
+  // Place each slot into its own cache line to avoid false sharing.
+  struct alignas(64) ReaderSlot {
+    std::atomic<std::uint64_t> epoch = kQuiescent;
+  };
+
+ public:
+  /**
+   * An immutable version of the bit vector and its select data structure.
+   */
+  struct Snapshot {
+    //! The bit vector with up-to-date rank information.
+    BitVector bitvector;
+    //! The select data structure for the bit vector.
+    Select select;
+    //! The version of this snapshot, starting from zero.
+    std::uint64_t version;
+
+    /**
+     * Constructs a snapshot by updating the rank information of a bit vector
+     * and building its select data structure.
+     *
+     * @param bits The bit vector to take.
+     * @param snapshot_version The version of the snapshot.
+     */
+    Snapshot(BitVector&& bits, const std::uint64_t snapshot_version)
+        : bitvector(updated(std::move(bits))),
+          select(bitvector),
+          version(snapshot_version) {
+    }
+
+   private:
+    [[nodiscard]] static BitVector&& updated(BitVector&& bits) {
+      bits.update();
+      return std::move(bits);
+    }
+  };
+
+  /**
+   * A read-side critical section, during which the snapshot that has been
+   * obtained when entering it is not reclaimed.
+   */
+  class ReadGuard {
+   public:
+    /**
+     * Leaves the critical section.
+     */
+    ~ReadGuard() {
+      _slot.epoch.store(kQuiescent, std::memory_order_release);
+    }
+
+    // Delete the move and copy constructor/assignment operator, as a critical
+    // section is bound to the scope in which it has been entered.
+    ReadGuard(ReadGuard&&) = delete;
+    ReadGuard& operator=(ReadGuard&&) = delete;
+    ReadGuard(ReadGuard const&) = delete;
+    ReadGuard& operator=(ReadGuard const&) = delete;
+
+    /**
+     * Returns the snapshot that has been obtained when entering.
+     *
+     * @return The snapshot.
+     */
+    [[nodiscard]] const Snapshot& operator*() const {
+      return *_snapshot;
+    }
+
+    /**
+     * Returns the snapshot that has been obtained when entering.
+     *
+     * @return The snapshot.
+     */
+    [[nodiscard]] const Snapshot* operator->() const {
+      return _snapshot;
+    }
+
+   private:
+    friend class SnapshotRankSelect;
+
+    ReadGuard(ReaderSlot& slot, const Snapshot* snapshot)
+        : _slot(slot), _snapshot(snapshot) {
+    }
+
+    ReaderSlot& _slot;
+    const Snapshot* _snapshot;
+  };
+
+  /**
+   * Constructs and publishes the first snapshot.
+   *
+   * @param bits The bit vector of the first snapshot.
+   * @param max_num_readers The maximum number of concurrent readers.
+   */
+  explicit SnapshotRankSelect(BitVector&& bits,
+                              const std::size_t max_num_readers)
+      : _num_readers(max_num_readers),
+        _slots(std::make_unique<ReaderSlot[]>(max_num_readers)),
+        _epoch(1),
+        _snapshot(new Snapshot(std::move(bits), 0)) {
+  }
+
+  /**
+   * Waits for a pending rebuild and frees the current snapshot. There must not
+   * be any reader left.
+   */
+  ~SnapshotRankSelect() {
+    wait();
+    delete _snapshot.load(std::memory_order_acquire);
+  }
+
+  // Delete the move and copy constructor/assignment operator, as readers and
+  // the background thread refer to this object.
+  SnapshotRankSelect(SnapshotRankSelect&&) = delete;
+  SnapshotRankSelect& operator=(SnapshotRankSelect&&) = delete;
+  SnapshotRankSelect(SnapshotRankSelect const&) = delete;
+  SnapshotRankSelect& operator=(SnapshotRankSelect const&) = delete;
+
+  /**
+   * Enters a read-side critical section and obtains the current snapshot.
+   *
+   * @param reader The number of the reader, which must be smaller than the
+   * maximum number of readers.
+   * @return The critical section, which is left when it is destructed.
+   */
+  [[nodiscard]] ReadGuard read(const std::size_t reader) const {
+    ReaderSlot& slot = _slots[reader];
+
+    // Announce the epoch before loading the snapshot. Both operations have to
+    // be sequentially consistent, as otherwise the load might be reordered
+    // before the store and the writer might miss this reader.
+    slot.epoch.store(_epoch.load(std::memory_order_seq_cst),
+                     std::memory_order_seq_cst);
+    const Snapshot* snapshot = _snapshot.load(std::memory_order_seq_cst);
+
+    return ReadGuard(slot, snapshot);
+  }
+
+  /**
+   * Builds the next snapshot in a background thread and publishes it once it
+   * is complete. If there is a pending rebuild, it is waited for first.
+   *
+   * @tparam Build The type of function that builds the bits.
+   * @param build A function that is given the current snapshot and returns the
+   * bits of the next snapshot, whose rank and select information are built
+   * afterwards.
+   */
+  template <std::invocable<const Snapshot&> Build>
+  void rebuild(Build&& build) {
+    wait();
+
+    _builder = std::thread([this, build = std::forward<Build>(build)] {
+      // The current snapshot is only ever reclaimed by the writer, i.e., it can
+      // be used here without entering a critical section.
+      const Snapshot& current = *_snapshot.load(std::memory_order_acquire);
+      publish(build(current));
+    });
+  }
+
+  /**
+   * Waits until a pending rebuild has been published.
+   */
+  void wait() {
+    if (_builder.joinable()) {
+      _builder.join();
+    }
+  }
+
+  /**
+   * Builds and publishes the next snapshot in the calling thread, and frees the
+   * previous snapshot once no reader uses it anymore.
+   *
+   * @param bits The bits of the next snapshot.
+   */
+  void publish(BitVector&& bits) {
+    const Snapshot* previous = _snapshot.load(std::memory_order_acquire);
+    const Snapshot* next = new Snapshot(std::move(bits), previous->version + 1);
+
+    _snapshot.store(next, std::memory_order_seq_cst);
+    const std::uint64_t epoch =
+        _epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+
+    // A reader that might still use the previous snapshot has announced an
+    // epoch before the new one, since it has loaded the snapshot before the
+    // epoch was advanced.
+    for (std::size_t reader = 0; reader < _num_readers; ++reader) {
+      std::uint64_t reader_epoch;
+      while ((reader_epoch = _slots[reader].epoch.load(
+                  std::memory_order_seq_cst)) != kQuiescent &&
+             reader_epoch < epoch) {
+        std::this_thread::yield();
+      }
+    }
+
+    delete previous;
+  }
+
+  /**
+   * Returns the version of the current snapshot.
+   *
+   * @return The version of the current snapshot.
+   */
+  [[nodiscard]] std::uint64_t version() const {
+    return _snapshot.load(std::memory_order_acquire)->version;
+  }
+
+ private:
+  std::size_t _num_readers;
+  std::unique_ptr<ReaderSlot[]> _slots;
+
+  std::atomic<std::uint64_t> _epoch;
+  std::atomic<const Snapshot*> _snapshot;
+
+  std::thread _builder;
+};
+
+}  // namespace bitsy
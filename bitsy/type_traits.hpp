@@ -35,6 +35,17 @@ concept BitVector = requires(T a,
   { a.memory_space() } -> std::convertible_to<std::size_t>;
 };
 
+//! Type trait that a read-only bit vector (e.g., a view) fulfills.
+template <typename T>
+concept ReadOnlyBitVector = requires(const T a, const std::size_t pos) {
+  //! Returns whether a bit is set.
+  { a.is_set(pos) } -> std::same_as<bool>;
+  //! Returns the length of the bit vector in bits.
+  { a.length() } -> std::convertible_to<std::size_t>;
+  //! Returns a pointer to the underlying memory.
+  { a.data() } -> std::same_as<const std::uint64_t*>;
+};
+
 //! Type trait that a rank data structure fulfills.
 template <typename T>
 concept Rank = requires(T a, const std::size_t pos) {
@@ -5,6 +5,7 @@
 
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 
 namespace bitsy::math {
@@ -69,4 +70,33 @@ template <std::integral Int>
   return (kOnes >> static_cast<Int>(kWidth - num_set_bits)) << start;
 }
 
+/**
+ * Computes the upper 64 bits of the 128-bit product of two 64-bit integers.
+ *
+ * @param x The first factor.
+ * @param y The second factor.
+ * @return The upper 64 bits of the product.
+ */
+[[nodiscard]] constexpr std::uint64_t mul_high(const std::uint64_t x,
+                                               const std::uint64_t y) {
+#ifdef __SIZEOF_INT128__
+  // The 128-bit integer type is an extension that -pedantic warns about.
+  __extension__ typedef unsigned __int128 UInt128;
+  return static_cast<std::uint64_t>((static_cast<UInt128>(x) * y) >> 64);
+#else
+  const std::uint64_t x_low = x & 0xFFFFFFFF;
+  const std::uint64_t x_high = x >> 32;
+  const std::uint64_t y_low = y & 0xFFFFFFFF;
+  const std::uint64_t y_high = y >> 32;
+
+  const std::uint64_t low_low = x_low * y_low;
+  const std::uint64_t low_high = x_low * y_high;
+  const std::uint64_t high_low = x_high * y_low;
+  const std::uint64_t middle =
+      (low_low >> 32) + (low_high & 0xFFFFFFFF) + (high_low & 0xFFFFFFFF);
+  return x_high * y_high + (low_high >> 32) + (high_low >> 32) +
+         (middle >> 32);
+#endif
+}
+
 }  // namespace bitsy::math
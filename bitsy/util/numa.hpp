@@ -0,0 +1,187 @@
+/// Utility functions to place memory on NUMA nodes.
+/// @file numa.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bitsy {
+
+/**
+ * The policy according to which the pages of an allocation are placed on the
+ * NUMA nodes of a system.
+ */
+struct NumaPolicy {
+  /*!
+   * The kind of placement.
+   */
+  enum class Mode {
+    //! Use the default policy of the calling thread (usually first touch).
+    DEFAULT,
+    //! Place the pages on the node of the thread that touches them first.
+    LOCAL,
+    //! Place the pages round-robin on all nodes.
+    INTERLEAVE,
+    //! Place the pages on a specific node.
+    BIND,
+  };
+
+  //! The kind of placement.
+  Mode mode = Mode::DEFAULT;
+  //! The node on which the pages are placed if bound to a specific node.
+  std::size_t node = 0;
+
+  /**
+   * Returns a policy that places the pages on the node of the thread that
+   * touches them first.
+   *
+   * @return The policy.
+   */
+  [[nodiscard]] static constexpr NumaPolicy local() {
+    return {Mode::LOCAL, 0};
+  }
+
+  /**
+   * Returns a policy that places the pages round-robin on all nodes.
+   *
+   * @return The policy.
+   */
+  [[nodiscard]] static constexpr NumaPolicy interleave() {
+    return {Mode::INTERLEAVE, 0};
+  }
+
+  /**
+   * Returns a policy that places the pages on a specific node.
+   *
+   * @param node The node on which the pages are placed.
+   * @return The policy.
+   */
+  [[nodiscard]] static constexpr NumaPolicy bind(const std::size_t node) {
+    return {Mode::BIND, node};
+  }
+};
+
+namespace numa {
+
+// We support systems with up to 1024 nodes, which is the default maximum
+// number of nodes of the Linux kernel.
+constexpr std::size_t kMaxNumNodes = 1024;
+
+/**
+ * Returns the number of NUMA nodes of the system, which is one if the system
+ * does not support NUMA or the number cannot be determined.
+ *
+ * @return The number of NUMA nodes.
+ */
+[[nodiscard]] inline std::size_t num_nodes() {
+#ifdef __linux__
+  // The file contains a list of ranges of the online nodes, e.g. "0-1,3".
+  std::ifstream in("/sys/devices/system/node/online");
+
+  std::string ranges;
+  if (!(in >> ranges)) {
+    return 1;
+  }
+
+  std::size_t max_node = 0;
+  std::size_t cur_node = 0;
+  for (const char c : ranges) {
+    if (c >= '0' && c <= '9') {
+      cur_node = cur_node * 10 + static_cast<std::size_t>(c - '0');
+    } else {
+      max_node = std::max(max_node, cur_node);
+      cur_node = 0;
+    }
+  }
+  max_node = std::max(max_node, cur_node);
+
+  return std::min(max_node + 1, kMaxNumNodes);
+#else
+  return 1;
+#endif
+}
+
+/**
+ * Returns the NUMA node of the CPU the calling thread is currently running on.
+ *
+ * @return The NUMA node of the calling thread.
+ */
+[[nodiscard]] inline std::size_t current_node() {
+#ifdef __linux__
+  unsigned int cpu;
+  unsigned int node;
+  if (getcpu(&cpu, &node) == 0) {
+    return node;
+  }
+#endif
+
+  return 0;
+}
+
+/**
+ * Applies a NUMA policy to a memory region, such that pages that are touched
+ * afterwards are placed according to the policy.
+ *
+ * The memory region has to be page-aligned, e.g., allocated with mmap. This is
+ * done with the mbind system call directly, so that libnuma is not required.
+ *
+ * @param ptr A pointer to the start of the memory region.
+ * @param length The length of the memory region in bytes.
+ * @param policy The policy to apply.
+ * @return Whether the policy has been applied successfully.
+ */
+inline bool apply(void* ptr,
+                  const std::size_t length,
+                  const NumaPolicy policy) {
+#ifdef __linux__
+  constexpr std::size_t kNumMaskBits = sizeof(unsigned long) * 8;
+  unsigned long mask[kMaxNumNodes / kNumMaskBits] = {};
+
+  int mode;
+  switch (policy.mode) {
+    case NumaPolicy::Mode::DEFAULT:
+      return true;
+    case NumaPolicy::Mode::LOCAL:
+      mode = MPOL_LOCAL;
+      break;
+    case NumaPolicy::Mode::INTERLEAVE:
+      mode = MPOL_INTERLEAVE;
+      for (std::size_t node = 0, n = num_nodes(); node < n; ++node) {
+        mask[node / kNumMaskBits] |= 1UL << (node % kNumMaskBits);
+      }
+      break;
+    case NumaPolicy::Mode::BIND:
+      mode = MPOL_BIND;
+      if (policy.node >= kMaxNumNodes) {
+        return false;
+      }
+      mask[policy.node / kNumMaskBits] |= 1UL << (policy.node % kNumMaskBits);
+      break;
+    default:
+      return false;
+  }
+
+  // The kernel expects the number of bits in the mask plus one.
+  const unsigned long max_node =
+      (policy.mode == NumaPolicy::Mode::LOCAL) ? 0 : kMaxNumNodes + 1;
+  const unsigned long* node_mask =
+      (policy.mode == NumaPolicy::Mode::LOCAL) ? nullptr : mask;
+  return syscall(SYS_mbind, ptr, length, mode, node_mask, max_node, 0) == 0;
+#else
+  return policy.mode == NumaPolicy::Mode::DEFAULT;
+#endif
+}
+
+}  // namespace numa
+
+}  // namespace bitsy
@@ -0,0 +1,74 @@
+/// Utility functions to run work in parallel.
+/// @file parallel.hpp
+/// @author Daniel Salwasser
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace bitsy::parallel {
+
+/**
+ * Returns the number of threads to use by default, which is the number of
+ * hardware threads.
+ *
+ * @return The number of threads to use by default.
+ */
+[[nodiscard]] inline std::size_t default_num_threads() {
+  return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+/**
+ * Invokes a function once per thread, whereby the calling thread participates
+ * as the first thread, and waits until all invocations have finished.
+ *
+ * @tparam Function The type of function to invoke.
+ * @param num_threads The number of threads to use.
+ * @param function The function to invoke with the number of the thread.
+ */
+template <std::invocable<std::size_t> Function>
+void for_each_thread(const std::size_t num_threads, Function&& function) {
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads > 0 ? num_threads - 1 : 0);
+
+  for (std::size_t thread = 1; thread < num_threads; ++thread) {
+    threads.emplace_back([&function, thread] { function(thread); });
+  }
+
+  function(static_cast<std::size_t>(0));
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+/**
+ * Splits a range into (at most) as many consecutive chunks of equal size as
+ * there are threads and invokes a function for each chunk in parallel.
+ *
+ * @tparam Function The type of function to invoke.
+ * @param begin The start of the range.
+ * @param end The (exclusive) end of the range.
+ * @param num_threads The number of threads to use.
+ * @param function The function to invoke with the start and (exclusive) end
+ * of a chunk.
+ */
+template <std::invocable<std::size_t, std::size_t> Function>
+void for_each_range(const std::size_t begin,
+                    const std::size_t end,
+                    std::size_t num_threads,
+                    Function&& function) {
+  // Do not start more threads than there are elements in the range.
+  const std::size_t length = end - begin;
+  num_threads = std::max<std::size_t>(1, std::min(num_threads, length));
+
+  for_each_thread(num_threads, [&](const std::size_t thread) {
+    const std::size_t chunk_begin = begin + (length * thread) / num_threads;
+    const std::size_t chunk_end = begin + (length * (thread + 1)) / num_threads;
+    function(chunk_begin, chunk_end);
+  });
+}
+
+}  // namespace bitsy::parallel
@@ -3,15 +3,21 @@
 /// @author Daniel Salwasser
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <new>
+#include <stdexcept>
+#include <utility>
 
 #ifdef __linux__
 #include <sys/mman.h>
 #endif
 
 #include "bitsy/util/math.hpp"
+#include "bitsy/util/numa.hpp"
+#include "bitsy/util/parallel.hpp"
 
 namespace bitsy {
 
@@ -21,6 +27,19 @@ namespace bitsy {
  * When Bitsy is compiled with the huge pages option enabled, we try to allocate
  * memory using huge pages and switch to normal pages if this fails.
  *
+ * Furthermore, a NUMA policy can be specified according to which the pages are
+ * placed on the NUMA nodes. In that case, the memory is always mapped directly
+ * (instead of using malloc), as the policy can only be applied to whole pages.
+ * Note that the policy is applied on a best-effort basis, i.e., the vector is
+ * still allocated if the policy cannot be applied.
+ *
+ * As the memory is only backed by physical pages when it is first touched, the
+ * first pass over a large vector is dominated by (serial) page faults. Thus,
+ * the pages can be pre-faulted in parallel before the vector is used.
+ *
+ * Finally, a vector can also be backed by a region of a file that is mapped
+ * into memory, such that its elements are only read from disk on demand.
+ *
  * @tparam T The type of element to store.
  */
 template <typename T>
@@ -35,6 +54,10 @@ class StaticVector {
   // We use 2 MiB-sized huge pages.
   static constexpr std::size_t kHugePageSize = 1 << 21;
 
+  // We assume 4 KiB-sized normal pages, which is used to round the length of
+  // mappings and is correct for larger pages as well.
+  static constexpr std::size_t kPageSize = 1 << 12;
+
  public:
   //! The type of the value that is stored.
   using value_type = T;
@@ -53,41 +76,96 @@ class StaticVector {
    * Constructs an unitialized static vector.
    *
    * @param size The number of elements that this vector contains.
+   * @param policy The NUMA policy according to which the pages are placed.
    */
-  explicit StaticVector(const size_type size) : _size(size) {
+  explicit StaticVector(const size_type size, const NumaPolicy policy = {})
+      : _size(size) {
     const std::size_t num_bytes = size * sizeof(T);
 
+    // Do not allocate any memory for an empty vector, as neither mmap nor
+    // malloc are guaranteed to succeed for a zero-sized allocation.
+    if (num_bytes == 0) {
+      _mapped_length = 0;
+      _ptr = nullptr;
+      return;
+    }
+
     if constexpr (kUseHugePages) {
       const std::size_t length = math::round_to(num_bytes, kHugePageSize);
       _ptr = static_cast<pointer>(mmap(
           nullptr, length, PROT_READ | PROT_WRITE,
           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0));
       if (_ptr != MAP_FAILED) {
-        _huge_pages = true;
+        _mapped_length = length;
+        numa::apply(_ptr, length, policy);
         return;
       }
     }
 
+#ifdef __linux__
+    if (policy.mode != NumaPolicy::Mode::DEFAULT) {
+      const std::size_t length = math::round_to(num_bytes, kPageSize);
+      _ptr = static_cast<pointer>(mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+      if (_ptr != MAP_FAILED) {
+        _mapped_length = length;
+        numa::apply(_ptr, length, policy);
+        return;
+      }
+    }
+#endif
+
     _ptr = static_cast<pointer>(std::malloc(num_bytes));
-    _huge_pages = false;
+    _mapped_length = 0;
     if (_ptr == nullptr) {
       throw std::bad_alloc();
     }
   }
 
+  /**
+   * Constructs a vector whose elements are stored in a region of a file that is
+   * mapped into memory. The pages are read on demand and the mapping is
+   * private, i.e., writes to the vector are not written back to the file.
+   *
+   * @param fd The file descriptor of the file, which can be closed afterwards.
+   * @param offset The offset in bytes of the region, which has to be a
+   * multiple of the page size.
+   * @param size The number of elements stored in the region.
+   * @return The vector that is backed by the region.
+   */
+  [[nodiscard]] static StaticVector map(const int fd,
+                                        const std::size_t offset,
+                                        const size_type size) {
+    const std::size_t num_bytes = size * sizeof(T);
+    if (num_bytes == 0) {
+      return StaticVector(nullptr, 0, 0);
+    }
+
+#ifdef __linux__
+    const std::size_t length = math::round_to(num_bytes, kPageSize);
+    void* const ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                           fd, static_cast<off_t>(offset));
+    if (ptr == MAP_FAILED) {
+      throw std::runtime_error("Cannot map file into memory.");
+    }
+
+    return StaticVector(static_cast<pointer>(ptr), size, length);
+#else
+    throw std::runtime_error("Mapping files into memory is not supported.");
+#endif
+  }
+
   /**
    * Destructs this vector and thereby releases the underlying memory that is
    * allocated on the heap.
    */
   ~StaticVector() {
-    if constexpr (kUseHugePages) {
-      if (_huge_pages) {
-        const std::size_t num_bytes = _size * sizeof(T);
-        const std::size_t length = math::round_to(num_bytes, kHugePageSize);
-        munmap(_ptr, length);
-        return;
-      }
+#ifdef __linux__
+    if (_mapped_length > 0) {
+      munmap(_ptr, _mapped_length);
+      return;
     }
+#endif
 
     std::free(_ptr);
   }
@@ -99,8 +177,10 @@ class StaticVector {
    * @param other The other static vectors whose data to take.
    */
   StaticVector(StaticVector&& other) noexcept
-      : _huge_pages(other._huge_pages), _size(other._size), _ptr(other._ptr) {
-    other._huge_pages = false;
+      : _mapped_length(other._mapped_length),
+        _size(other._size),
+        _ptr(other._ptr) {
+    other._mapped_length = 0;
     other._size = 0;
     other._ptr = nullptr;
   }
@@ -111,14 +191,12 @@ class StaticVector {
    * @param other The other static vectors whose data to take.
    */
   StaticVector& operator=(StaticVector&& other) noexcept {
+    // Swap the data such that the data previously owned by this vector is
+    // released when the other vector is destructed.
     if (this != &other) {
-      _huge_pages = other._huge_pages;
-      _size = other._size;
-      _ptr = other._ptr;
-
-      other._huge_pages = false;
-      other._size = 0;
-      other._ptr = nullptr;
+      std::swap(_mapped_length, other._mapped_length);
+      std::swap(_size, other._size);
+      std::swap(_ptr, other._ptr);
     }
 
     return *this;
@@ -129,6 +207,82 @@ class StaticVector {
   StaticVector(StaticVector const&) = delete;
   StaticVector& operator=(StaticVector const&) = delete;
 
+  /**
+   * Pre-faults the pages of this vector in parallel, such that the first pass
+   * over this vector does not have to wait for page faults.
+   *
+   * Each thread populates a consecutive range of the pages, either with a
+   * single madvise call (Linux 5.14+) or, if that is not supported, by touching
+   * each page. In both cases, the elements stored in this vector are preserved.
+   * Furthermore, when the vector is not backed by huge pages, the kernel is
+   * advised to use transparent huge pages for it.
+   *
+   * @param num_threads The number of threads to use.
+   */
+  void prefault(const std::size_t num_threads = 1) {
+    const std::size_t num_bytes = _size * sizeof(T);
+    if (num_bytes == 0) {
+      return;
+    }
+
+    char* const bytes = reinterpret_cast<char*>(_ptr);
+    const std::size_t num_pages = math::div_ceil(num_bytes, kPageSize);
+
+#ifdef __linux__
+    // Restrict the hint to the whole huge pages within the vector, as the
+    // memory might not be aligned when it has been allocated with malloc.
+    const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(bytes);
+    const std::uintptr_t end = begin + num_bytes;
+    const std::uintptr_t aligned_begin =
+        math::round_to<std::uintptr_t>(begin, kHugePageSize);
+    const std::uintptr_t aligned_end = (end / kHugePageSize) * kHugePageSize;
+    if (aligned_begin < aligned_end) {
+      madvise(reinterpret_cast<void*>(aligned_begin),
+              aligned_end - aligned_begin, MADV_HUGEPAGE);
+    }
+#endif
+
+    parallel::for_each_range(
+        0, num_pages, num_threads,
+        [&](const std::size_t first_page, const std::size_t last_page) {
+          char* const first = bytes + first_page * kPageSize;
+          char* const last = bytes + std::min(last_page * kPageSize, num_bytes);
+
+#if defined(__linux__) && defined(MADV_POPULATE_WRITE)
+          if (_mapped_length > 0 &&
+              madvise(first, static_cast<std::size_t>(last - first),
+                      MADV_POPULATE_WRITE) == 0) {
+            return;
+          }
+#endif
+
+          // Touch each page by writing back the value of a byte, which
+          // allocates the page but preserves its content. As the memory might
+          // not be page-aligned, we also touch the last byte of the range.
+          for (volatile char* byte = first; byte < last; byte += kPageSize) {
+            *byte = *byte;
+          }
+
+          volatile char* const last_byte = last - 1;
+          *last_byte = *last_byte;
+        });
+  }
+
+  /**
+   * Advises the kernel how the pages of this vector are going to be accessed,
+   * which controls the readahead if the vector is backed by a file. This has
+   * no effect if the vector is not mapped directly.
+   *
+   * @param advice The advice as for madvise, e.g., MADV_RANDOM.
+   */
+  void advise([[maybe_unused]] const int advice) {
+#ifdef __linux__
+    if (_mapped_length > 0) {
+      madvise(_ptr, _mapped_length, advice);
+    }
+#endif
+  }
+
   /**
    * Returns a reference to an element stored in this vector.
    *
@@ -179,7 +333,13 @@ class StaticVector {
   }
 
  private:
-  bool _huge_pages;
+  StaticVector(const pointer ptr,
+               const size_type size,
+               const std::size_t mapped_length)
+      : _mapped_length(mapped_length), _size(size), _ptr(ptr) {
+  }
+
+  std::size_t _mapped_length;
   size_type _size;
   pointer _ptr;
 };
@@ -1,10 +1,16 @@
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <random>
 #include <ranges>
+#include <stdexcept>
+#include <vector>
 
 #include <bitsy/bitvector.hpp>
+#include <bitsy/partitioned_writer.hpp>
 #include <bitsy/rank/two_layer_rank_combined_bitvector.hpp>
 #include <bitsy/type_traits.hpp>
+#include <bitsy/util/parallel.hpp>
 
 #include "bitvector_util.hpp"
 
@@ -62,6 +68,140 @@ void test_access_random() {
   }
 }
 
+template <type_traits::BitVector BitVector>
+void test_access_atomic() {
+  constexpr std::size_t kNumThreads = 4;
+
+  for (const std::size_t length : kLengths) {
+    BitVector bitvector(length, false);
+
+    // Let the threads write to the same words by interleaving the positions.
+    parallel::for_each_thread(kNumThreads, [&](const std::size_t thread) {
+      for (std::size_t pos = thread; pos < length; pos += kNumThreads) {
+        bitvector.atomic_set(pos, (pos % 3) != 0);
+      }
+    });
+
+    parallel::for_each_thread(kNumThreads, [&](const std::size_t thread) {
+      for (std::size_t pos = thread; pos < length; pos += kNumThreads) {
+        if ((pos % 5) == 0) {
+          bitvector.atomic_unset(pos);
+        }
+      }
+    });
+
+    for (std::size_t i = 0; i < length; ++i) {
+      EXPECT_EQ(bitvector.is_set(i), (i % 3) != 0 && (i % 5) != 0);
+    }
+  }
+}
+
+template <type_traits::BitVector BitVector>
+void test_access_partitioned_writer() {
+  for (const std::size_t length : kLengths) {
+    if (length == 0) {
+      continue;
+    }
+
+    std::mt19937 gen(length);
+    std::uniform_int_distribution<std::size_t> dist(0, length - 1);
+
+    std::vector<std::size_t> positions(length / 2 + 1);
+    for (std::size_t& pos : positions) {
+      pos = dist(gen);
+    }
+
+    BitVector reference(length, false);
+    for (const std::size_t pos : positions) {
+      reference.set(pos);
+    }
+
+    for (const std::size_t num_threads : {1, 3, 8}) {
+      BitVector bitvector(length, false);
+      parallel_set(bitvector, std::span<const std::size_t>(positions),
+                   num_threads);
+
+      for (std::size_t i = 0; i < length; ++i) {
+        EXPECT_EQ(reference.is_set(i), bitvector.is_set(i));
+      }
+    }
+  }
+
+  BitVector bitvector(64, false);
+  EXPECT_THROW(PartitionedWriter<BitVector>(bitvector, 0),
+               std::invalid_argument);
+}
+
+template <type_traits::BitVector BitVector>
+void test_access_prefault() {
+  for (const std::size_t length : kLengths) {
+    for (const std::size_t num_threads : {1, 3}) {
+      // Pre-fault before and after setting the bits, whereby the latter must
+      // preserve the bits.
+      BitVector bitvector(length);
+      bitvector.prefault(num_threads);
+
+      for (std::size_t i = 0; i < length; ++i) {
+        bitvector.set(i, (i % 7) == 0);
+      }
+      bitvector.prefault(num_threads);
+
+      for (std::size_t i = 0; i < length; ++i) {
+        EXPECT_EQ(bitvector.is_set(i), (i % 7) == 0);
+      }
+    }
+  }
+}
+
+template <type_traits::BitVector BitVector>
+void test_access_bulk() {
+  for (const std::size_t length : kLengths) {
+    const auto bitvector = create_random_bitvec<BitVector>(length, 0.5, 1);
+
+    // Only query a subset of the positions of long bit vectors.
+    const std::size_t step = (length > math::pow2(16)) ? 997 : 1;
+    for (std::size_t pos = 0; pos < length; pos += step) {
+      for (const std::size_t len : {0, 1, 13, 63, 64}) {
+        if (pos + len > length) {
+          continue;
+        }
+
+        const std::uint64_t bits = bitvector.get_bits(pos, len);
+        for (std::size_t i = 0; i < len; ++i) {
+          EXPECT_EQ(bitvector.is_set(pos + i), ((bits >> i) & 1) == 1);
+        }
+        EXPECT_EQ(len == 64 ? 0 : bits >> len, 0);
+      }
+    }
+
+    for (const std::size_t first : {std::size_t{0}, length / 3}) {
+      for (const std::size_t last : {length - length / 5, length}) {
+        if (first > last) {
+          continue;
+        }
+
+        std::vector<std::uint64_t> words(math::div_ceil(last - first, 64) + 1,
+                                         ~static_cast<std::uint64_t>(0));
+        bitvector.copy_bits(first, last, words.data());
+
+        for (std::size_t i = 0; i < words.size() * 64 - 64; ++i) {
+          const bool is_set = ((words[i / 64] >> (i % 64)) & 1) == 1;
+          EXPECT_EQ(first + i < last && bitvector.is_set(first + i), is_set);
+        }
+
+        // The word past the buffer must not be written.
+        EXPECT_EQ(words.back(), ~static_cast<std::uint64_t>(0));
+      }
+    }
+
+    const auto exported = bitvector.to_bitvector();
+    EXPECT_EQ(exported.length(), length);
+    for (std::size_t i = 0; i < length; ++i) {
+      EXPECT_EQ(bitvector.is_set(i), exported.is_set(i));
+    }
+  }
+}
+
 TEST(BitVectorAccessTest, Uniform) {
   test_access_uniform<BitVector>();
 }
@@ -70,6 +210,18 @@ TEST(BitVectorAccessTest, Alternating) {
   test_access_alternating<BitVector>();
 }
 
+TEST(BitVectorAccessTest, Atomic) {
+  test_access_atomic<BitVector>();
+}
+
+TEST(BitVectorAccessTest, PartitionedWriter) {
+  test_access_partitioned_writer<BitVector>();
+}
+
+TEST(BitVectorAccessTest, Prefault) {
+  test_access_prefault<BitVector>();
+}
+
 TEST(TwoLayerRankCombinedBitVectorAccessTest, Uniform) {
   test_access_uniform<TwoLayerRankCombinedBitVector<>>();
   test_access_uniform<TwoLayerRankCombinedBitVector<1024, 15>>();
@@ -85,4 +237,24 @@ TEST(TwoLayerRankCombinedBitVectorAccessTest, Random) {
   test_access_random<BitVector, TwoLayerRankCombinedBitVector<1024, 15>>();
 }
 
+TEST(TwoLayerRankCombinedBitVectorAccessTest, Atomic) {
+  test_access_atomic<TwoLayerRankCombinedBitVector<>>();
+  test_access_atomic<TwoLayerRankCombinedBitVector<1024, 15>>();
+}
+
+TEST(TwoLayerRankCombinedBitVectorAccessTest, PartitionedWriter) {
+  test_access_partitioned_writer<TwoLayerRankCombinedBitVector<>>();
+  test_access_partitioned_writer<TwoLayerRankCombinedBitVector<1024, 15>>();
+}
+
+TEST(TwoLayerRankCombinedBitVectorAccessTest, Bulk) {
+  test_access_bulk<TwoLayerRankCombinedBitVector<>>();
+  test_access_bulk<TwoLayerRankCombinedBitVector<1024, 15>>();
+}
+
+TEST(TwoLayerRankCombinedBitVectorAccessTest, Prefault) {
+  test_access_prefault<TwoLayerRankCombinedBitVector<>>();
+  test_access_prefault<TwoLayerRankCombinedBitVector<1024, 15>>();
+}
+
 }  // namespace
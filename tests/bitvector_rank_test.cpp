@@ -1,9 +1,17 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <random>
 #include <ranges>
+#include <vector>
 
 #include <bitsy/bitvector.hpp>
+#include <bitsy/bitvector_view.hpp>
+#include <bitsy/rank/multi_rank_combined_bitvector.hpp>
+#include <bitsy/rank/mutable_two_layer_rank_combined_bitvector.hpp>
 #include <bitsy/rank/naive_rank.hpp>
+#include <bitsy/rank/two_layer_rank.hpp>
 #include <bitsy/rank/two_layer_rank_combined_bitvector.hpp>
 
 #include "bitvector_util.hpp"
@@ -39,6 +47,10 @@ void test_combined_rank(const RankBitVector& bitvector) {
 
     cur_rank += static_cast<std::size_t>(bitvector.is_set(pos) ? 1 : 0);
   }
+
+  if constexpr (requires { bitvector.num_ones(); }) {
+    EXPECT_EQ(cur_rank, bitvector.num_ones());
+  }
 }
 
 template <type_traits::BitVector BitVector, type_traits::Rank Rank>
@@ -128,6 +140,121 @@ void test_rank_combined_random() {
   }
 }
 
+template <type_traits::RankCombinedBitVector RankBitVector>
+void test_rank_combined_parallel() {
+  for (const std::size_t length : kLengths) {
+    for (const std::size_t num_threads : {2, 3, 8}) {
+      auto bitvector = create_random_bitvec<RankBitVector>(length, 0.5, 1);
+      bitvector.update(num_threads);
+      test_combined_rank(bitvector);
+    }
+  }
+}
+
+template <type_traits::RankCombinedBitVector RankBitVector>
+void test_rank_combined_point_updates() {
+  for (const std::size_t length : kLengths) {
+    if (length == 0) {
+      continue;
+    }
+
+    auto bitvector = create_random_bitvec<RankBitVector>(length, 0.5, 1);
+
+    // The rank information has to be correct after each round of writes
+    // without calling update().
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<std::size_t> dist(0, length - 1);
+    for (const float fillratio : {0.1, 0.9, 0.5}) {
+      std::bernoulli_distribution value_dist(fillratio);
+
+      for (std::size_t i = 0; i < 1000; ++i) {
+        bitvector.set(dist(gen), value_dist(gen));
+      }
+
+      test_combined_rank(bitvector);
+    }
+  }
+}
+
+template <std::size_t BlockWidth>
+void test_rank_view() {
+  for (const std::size_t length : kLengths) {
+    for (const float fillratio : {0.0, 0.1, 0.5, 0.9, 1.0}) {
+      const auto bitvector =
+          create_random_bitvec<BitVector>(length, fillratio, 1);
+
+      const BitVectorView view(bitvector);
+      const TwoLayerRank<BitVectorView, BlockWidth> rank(view);
+      test_rank(bitvector, rank);
+
+      EXPECT_EQ(rank.num_ones(), count_ones(bitvector));
+      EXPECT_EQ(rank.rank1(length), count_ones(bitvector));
+    }
+  }
+}
+
+template <std::size_t BlockWidth>
+void test_rank_view_external() {
+  for (const std::size_t length : kLengths) {
+    // The bits of the last word past the length must be ignored.
+    std::mt19937_64 gen(1);
+    std::vector<std::uint64_t> words(math::div_ceil(length, 64));
+    std::generate(words.begin(), words.end(), gen);
+
+    const BitVectorView view(words.data(), length);
+    const TwoLayerRank<BitVectorView, BlockWidth> rank(view);
+
+    std::size_t cur_rank = 0;
+    for (std::size_t pos = 0; pos < length; ++pos) {
+      EXPECT_EQ(cur_rank, rank.rank1(pos));
+      cur_rank += static_cast<std::size_t>(view.is_set(pos) ? 1 : 0);
+    }
+    EXPECT_EQ(cur_rank, rank.rank1(length));
+    EXPECT_EQ(cur_rank, rank.num_ones());
+  }
+}
+
+template <typename MultiBitVector>
+void test_rank_multi() {
+  constexpr std::size_t kNumVectors = MultiBitVector::kNumVectors;
+
+  for (const std::size_t length : kLengths) {
+    std::vector<BitVector> bitvectors;
+    MultiBitVector multi_bitvector(length);
+    for (std::size_t k = 0; k < kNumVectors; ++k) {
+      const float fillratio = static_cast<float>(k + 1) / (kNumVectors + 1);
+      bitvectors.push_back(
+          create_random_bitvec<BitVector>(length, fillratio, k));
+
+      for (std::size_t pos = 0; pos < length; ++pos) {
+        multi_bitvector.set(k, pos, bitvectors[k].is_set(pos));
+      }
+    }
+    multi_bitvector.update();
+
+    std::vector<std::size_t> cur_ranks(kNumVectors, 0);
+    for (std::size_t pos = 0; pos <= length; ++pos) {
+      const auto ranks0 = multi_bitvector.rank0_all(pos);
+      const auto ranks1 = multi_bitvector.rank1_all(pos);
+
+      for (std::size_t k = 0; k < kNumVectors; ++k) {
+        EXPECT_EQ(cur_ranks[k], ranks1[k]);
+        EXPECT_EQ(pos - cur_ranks[k], ranks0[k]);
+        EXPECT_EQ(cur_ranks[k], multi_bitvector.rank1(k, pos));
+
+        if (pos < length) {
+          EXPECT_EQ(bitvectors[k].is_set(pos), multi_bitvector.is_set(k, pos));
+          cur_ranks[k] += bitvectors[k].is_set(pos) ? 1 : 0;
+        }
+      }
+    }
+
+    for (std::size_t k = 0; k < kNumVectors; ++k) {
+      EXPECT_EQ(cur_ranks[k], multi_bitvector.num_ones(k));
+    }
+  }
+}
+
 TEST(NaiveRankTest, Uniform) {
   test_rank_uniform<BitVector, NaiveRank<BitVector>>();
 }
@@ -136,6 +263,16 @@ TEST(NaiveRankTest, Alternating) {
   test_rank_alternating<BitVector, NaiveRank<BitVector>>();
 }
 
+TEST(TwoLayerRankTest, View) {
+  test_rank_view<512>();
+  test_rank_view<1024>();
+}
+
+TEST(TwoLayerRankTest, ExternalWords) {
+  test_rank_view_external<512>();
+  test_rank_view_external<1024>();
+}
+
 TEST(TwoLayerRankCombinedBitVectorTest, Uniform) {
   test_rank_combined_uniform<TwoLayerRankCombinedBitVector<>>();
   test_rank_combined_uniform<TwoLayerRankCombinedBitVector<1024, 15>>();
@@ -151,4 +288,31 @@ TEST(TwoLayerRankCombinedBitVectorTest, Random) {
   test_rank_combined_random<TwoLayerRankCombinedBitVector<1024, 15>>();
 }
 
+TEST(TwoLayerRankCombinedBitVectorTest, Parallel) {
+  test_rank_combined_parallel<TwoLayerRankCombinedBitVector<>>();
+  test_rank_combined_parallel<TwoLayerRankCombinedBitVector<1024, 15>>();
+}
+
+TEST(MultiRankCombinedBitVectorTest, Random) {
+  test_rank_multi<MultiRankCombinedBitVector<1>>();
+  test_rank_multi<MultiRankCombinedBitVector<4>>();
+  test_rank_multi<MultiRankCombinedBitVector<3, 1024, 15>>();
+}
+
+TEST(MutableTwoLayerRankCombinedBitVectorTest, Uniform) {
+  test_rank_combined_uniform<MutableTwoLayerRankCombinedBitVector<>>();
+  test_rank_combined_uniform<MutableTwoLayerRankCombinedBitVector<1024, 15>>();
+}
+
+TEST(MutableTwoLayerRankCombinedBitVectorTest, Random) {
+  test_rank_combined_random<MutableTwoLayerRankCombinedBitVector<>>();
+  test_rank_combined_random<MutableTwoLayerRankCombinedBitVector<1024, 15>>();
+}
+
+TEST(MutableTwoLayerRankCombinedBitVectorTest, PointUpdates) {
+  test_rank_combined_point_updates<MutableTwoLayerRankCombinedBitVector<>>();
+  test_rank_combined_point_updates<
+      MutableTwoLayerRankCombinedBitVector<1024, 15>>();
+}
+
 }  // namespace
@@ -1,11 +1,17 @@
 #include <gtest/gtest.h>
 
+#include <concepts>
+#include <random>
 #include <ranges>
 
 #include <bitsy/bitvector.hpp>
+#include <bitsy/bitvector_view.hpp>
+#include <bitsy/rank/mutable_two_layer_rank_combined_bitvector.hpp>
 #include <bitsy/rank/naive_rank.hpp>
+#include <bitsy/rank/two_layer_rank.hpp>
 #include <bitsy/rank/two_layer_rank_combined_bitvector.hpp>
 #include <bitsy/select/naive_select.hpp>
+#include <bitsy/select/sampled_select.hpp>
 #include <bitsy/select/two_layer_select.hpp>
 #include <bitsy/type_traits.hpp>
 
@@ -20,6 +26,18 @@ constexpr std::size_t kLength = math::pow2(22) + 7;
 constexpr auto kLengths = {0,   1,   63,    64,    65,    511,
                            512, 513, 16383, 16384, 16385, math::pow2(22) + 7};
 
+// Constructs a select data structure, whereby the number of ones is only passed
+// to the ones that do not take it from the rank information of the bit vector.
+template <type_traits::Select Select, type_traits::BitVector BitVector>
+Select make_select(const BitVector& bitvector, const std::size_t num_ones) {
+  if constexpr (std::constructible_from<Select, const BitVector&,
+                                        std::size_t>) {
+    return Select(bitvector, num_ones);
+  } else {
+    return Select(bitvector);
+  }
+}
+
 template <type_traits::BitVector BitVector, type_traits::Select Select>
 void test_select(const BitVector& bitvector, const Select& select) {
   const std::size_t length = bitvector.length();
@@ -35,14 +53,38 @@ void test_select(const BitVector& bitvector, const Select& select) {
   }
 }
 
+template <type_traits::BitVector BitVector, typename Select>
+void test_select0(const BitVector& bitvector, const Select& select) {
+  const std::size_t length = bitvector.length();
+
+  std::size_t cur_zero = 0;
+  for (std::size_t pos = 0; pos < length; ++pos) {
+    if (!bitvector.is_set(pos)) {
+      EXPECT_EQ(pos, select.select0(++cur_zero));
+    }
+  }
+}
+
+template <type_traits::BitVector BitVector, typename Select>
+void test_select1(const BitVector& bitvector, const Select& select) {
+  const std::size_t length = bitvector.length();
+
+  std::size_t cur_one = 0;
+  for (std::size_t pos = 0; pos < length; ++pos) {
+    if (bitvector.is_set(pos)) {
+      EXPECT_EQ(pos, select.select1(++cur_one));
+    }
+  }
+}
+
 template <type_traits::BitVector BitVector, type_traits::Select Select>
 void test_select_uniform() {
   for (const std::size_t length : kLengths) {
     const BitVector bitvector_u0(length, false);
     const BitVector bitvector_u1(length, true);
 
-    const Select select_u0(bitvector_u0, 0);
-    const Select select_u1(bitvector_u1, length);
+    const auto select_u0 = make_select<Select>(bitvector_u0, 0);
+    const auto select_u1 = make_select<Select>(bitvector_u1, length);
 
     test_select(bitvector_u0, select_u0);
     test_select(bitvector_u1, select_u1);
@@ -64,9 +106,12 @@ void test_select_alternating() {
       bitvector_p19.update();
     }
 
-    const Select select_p2(bitvector_p2, count_ones(bitvector_p2));
-    const Select select_p5(bitvector_p5, count_ones(bitvector_p5));
-    const Select select_p19(bitvector_p19, count_ones(bitvector_p19));
+    const auto select_p2 =
+        make_select<Select>(bitvector_p2, count_ones(bitvector_p2));
+    const auto select_p5 =
+        make_select<Select>(bitvector_p5, count_ones(bitvector_p5));
+    const auto select_p19 =
+        make_select<Select>(bitvector_p19, count_ones(bitvector_p19));
 
     test_select(bitvector_p2, select_p2);
     test_select(bitvector_p5, select_p5);
@@ -88,13 +133,31 @@ void test_select_random() {
           bitvector.update();
         }
 
-        const Select select(bitvector, count_ones(bitvector));
+        const auto select =
+            make_select<Select>(bitvector, count_ones(bitvector));
         test_select(bitvector, select);
       }
     }
   }
 }
 
+template <std::size_t BlockWidth, std::size_t Stride>
+void test_select_view() {
+  using Rank = TwoLayerRank<BitVectorView, BlockWidth>;
+
+  for (const std::size_t length : kLengths) {
+    for (const float fillratio : {0.0, 0.001, 0.1, 0.5, 0.9, 1.0}) {
+      const auto bitvector =
+          create_random_bitvec<BitVector>(length, fillratio, 1);
+
+      const BitVectorView view(bitvector);
+      const Rank rank(view);
+      const SampledSelect<Rank, Stride> select(rank);
+      test_select(bitvector, select);
+    }
+  }
+}
+
 TEST(NaiveSelectTest, Uniform) {
   test_select_uniform<BitVector, NaiveSelect<BitVector>>();
 }
@@ -107,6 +170,12 @@ TEST(NaiveSelectTest, Random) {
   test_select_random<BitVector, NaiveSelect<BitVector>>();
 }
 
+TEST(SampledSelectTest, View) {
+  test_select_view<512, 32768>();
+  test_select_view<512, 512>();
+  test_select_view<1024, 32768>();
+}
+
 TEST(TwoLayerSelectTestLinearSearch, Uniform) {
   using BitVector = TwoLayerRankCombinedBitVector<>;
   using BitVector1024 = TwoLayerRankCombinedBitVector<1024, 15>;
@@ -157,4 +226,124 @@ TEST(TwoLayerSelectTestBinarySearch, Random) {
                      true>();
 }
 
+TEST(TwoLayerSelectTestFusedBuild, Random) {
+  using BitVector = TwoLayerRankCombinedBitVector<>;
+  using BitVector1024 = TwoLayerRankCombinedBitVector<1024, 15>;
+
+  for (const std::size_t length : kLengths) {
+    for (const float fillratio : {0.1, 0.5, 0.9}) {
+      auto bitvector = create_random_bitvec<BitVector>(length, fillratio, 1);
+      bitvector.update();
+      test_select(bitvector, TwoLayerSelect(bitvector));
+
+      auto bitvector1024 =
+          create_random_bitvec<BitVector1024>(length, fillratio, 1);
+      bitvector1024.update();
+      test_select(bitvector1024, TwoLayerSelect(bitvector1024));
+    }
+  }
+}
+
+TEST(TwoLayerSelectTestParallel, Random) {
+  using BitVector = TwoLayerRankCombinedBitVector<>;
+  using BitVector1024 = TwoLayerRankCombinedBitVector<1024, 15>;
+
+  for (const std::size_t length : kLengths) {
+    for (const std::size_t num_threads : {2, 3, 8}) {
+      auto bitvector = create_random_bitvec<BitVector>(length, 0.5, 1);
+      bitvector.update(num_threads);
+      TwoLayerSelect<BitVector, true, 512> select(bitvector);
+      select.update(num_threads);
+      test_select(bitvector, select);
+
+      auto bitvector1024 = create_random_bitvec<BitVector1024>(length, 0.5, 1);
+      bitvector1024.update(num_threads);
+      TwoLayerSelect<BitVector1024, true, 512> select1024(bitvector1024);
+      select1024.update(num_threads);
+      test_select(bitvector1024, select1024);
+    }
+  }
+}
+
+TEST(TwoLayerSelectTestUpdate, MoreOnes) {
+  using BitVector = TwoLayerRankCombinedBitVector<>;
+
+  for (const std::size_t length : kLengths) {
+    auto bitvector = create_random_bitvec<BitVector>(length, 0.1, 1);
+    bitvector.update();
+    TwoLayerSelect<BitVector, true, 512> select(bitvector);
+
+    // The samples have to grow with the number of ones of the bit vector.
+    for (std::size_t pos = 0; pos < length; pos += 2) {
+      bitvector.set(pos);
+    }
+    bitvector.update();
+    select.update();
+    test_select(bitvector, select);
+  }
+}
+
+TEST(TwoLayerSelectTestSingleKind, Random) {
+  using BitVector = TwoLayerRankCombinedBitVector<>;
+  using Select = TwoLayerSelect<BitVector>;
+  using Select0 = TwoLayerSelect<BitVector, true, 32768, true, false>;
+  using Select1 = TwoLayerSelect<BitVector, true, 32768, false, true>;
+
+  for (const std::size_t length : kLengths) {
+    for (const float fillratio : {0.1, 0.5, 0.9}) {
+      auto bitvector = create_random_bitvec<BitVector>(length, fillratio, 1);
+      bitvector.update();
+
+      const Select select(bitvector);
+      const Select0 select0(bitvector);
+      const Select1 select1(bitvector);
+
+      test_select0(bitvector, select0);
+      test_select1(bitvector, select1);
+
+      EXPECT_EQ(select0.memory_space() + select1.memory_space(),
+                select.memory_space());
+    }
+  }
+}
+
+TEST(MutableTwoLayerRankCombinedBitVectorTest, Random) {
+  using BitVector = MutableTwoLayerRankCombinedBitVector<>;
+  using BitVector1024 = MutableTwoLayerRankCombinedBitVector<1024, 15>;
+
+  for (const std::size_t length : kLengths) {
+    for (const float fillratio : {0.1, 0.5, 0.9}) {
+      const auto bitvector =
+          create_random_bitvec<BitVector>(length, fillratio, 1);
+      test_select(bitvector, bitvector);
+
+      const auto bitvector1024 =
+          create_random_bitvec<BitVector1024>(length, fillratio, 1);
+      test_select(bitvector1024, bitvector1024);
+    }
+  }
+}
+
+TEST(MutableTwoLayerRankCombinedBitVectorTest, PointUpdates) {
+  using BitVector = MutableTwoLayerRankCombinedBitVector<>;
+
+  for (const std::size_t length : kLengths) {
+    if (length == 0) {
+      continue;
+    }
+
+    BitVector bitvector(length, true);
+
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<std::size_t> dist(0, length - 1);
+    for (const bool value : {false, true, false}) {
+      for (std::size_t i = 0; i < 1000; ++i) {
+        bitvector.set(dist(gen), value);
+      }
+
+      test_select(bitvector, bitvector);
+    }
+  }
+}
+
 }  // namespace
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <bitsy/rank/two_layer_rank_combined_bitvector.hpp>
+#include <bitsy/select/two_layer_select.hpp>
+
+namespace {
+using namespace bitsy;
+
+// Use small superblocks and a small stride, such that many superblocks and
+// samples are created.
+using BitVector = TwoLayerRankCombinedBitVector<512, 12>;
+using Select = TwoLayerSelect<BitVector, true, 64>;
+
+constexpr std::size_t kBlockDataWidth = BitVector::kBlockDataWidth;
+constexpr std::size_t kSuperblockDataWidth = BitVector::kSuperblockDataWidth;
+
+BitVector create_bitvector(const std::vector<bool>& bits) {
+  BitVector bitvector(bits.size());
+  for (std::size_t pos = 0; pos < bits.size(); ++pos) {
+    bitvector.set(pos, bits[pos]);
+  }
+
+  bitvector.update();
+  return bitvector;
+}
+
+std::vector<bool> random_bits(const std::size_t length, const int seed) {
+  std::mt19937 gen(seed);
+  std::bernoulli_distribution dist(0.3);
+
+  std::vector<bool> bits(length);
+  for (std::size_t pos = 0; pos < length; ++pos) {
+    bits[pos] = dist(gen);
+  }
+
+  return bits;
+}
+
+// Checks that the bit vector and select data structure are identical to the
+// ones that are built from scratch.
+void test_equal(const BitVector& bitvector,
+                const Select& select,
+                const std::vector<bool>& bits) {
+  const BitVector expected = create_bitvector(bits);
+  const Select expected_select(expected);
+
+  ASSERT_EQ(bitvector.length(), expected.length());
+  EXPECT_EQ(bitvector.num_ones(), expected.num_ones());
+
+  ASSERT_EQ(bitvector.num_words(), expected.num_words());
+  for (std::size_t i = 0; i < expected.num_words(); ++i) {
+    EXPECT_EQ(bitvector.data()[i], expected.data()[i]);
+  }
+
+  ASSERT_EQ(bitvector.num_superblocks(), expected.num_superblocks());
+  for (std::size_t i = 0; i < expected.num_superblocks(); ++i) {
+    EXPECT_EQ(bitvector.superblock_data()[i], expected.superblock_data()[i]);
+  }
+
+  const auto zero_samples = select.zero_samples();
+  const auto expected_zero_samples = expected_select.zero_samples();
+  ASSERT_EQ(zero_samples.size(), expected_zero_samples.size());
+  for (std::size_t i = 0; i < zero_samples.size(); ++i) {
+    EXPECT_EQ(zero_samples[i], expected_zero_samples[i]);
+  }
+
+  const auto one_samples = select.one_samples();
+  const auto expected_one_samples = expected_select.one_samples();
+  ASSERT_EQ(one_samples.size(), expected_one_samples.size());
+  for (std::size_t i = 0; i < one_samples.size(); ++i) {
+    EXPECT_EQ(one_samples[i], expected_one_samples[i]);
+  }
+
+  std::size_t num_zeros = 0;
+  std::size_t num_ones = 0;
+  for (std::size_t pos = 0; pos < bits.size(); ++pos) {
+    EXPECT_EQ(bitvector.rank1(pos), num_ones);
+
+    if (bits[pos]) {
+      EXPECT_EQ(select.select1(++num_ones), pos);
+    } else {
+      EXPECT_EQ(select.select0(++num_zeros), pos);
+    }
+  }
+}
+
+constexpr auto kLengths = {std::size_t{0},
+                           std::size_t{1},
+                           kBlockDataWidth - 1,
+                           kBlockDataWidth,
+                           3 * kBlockDataWidth + 17,
+                           kSuperblockDataWidth,
+                           2 * kSuperblockDataWidth + 5 * kBlockDataWidth,
+                           3 * kSuperblockDataWidth + 100};
+
+TEST(ConcatSplitTest, Concat) {
+  for (const std::size_t first_length : kLengths) {
+    for (const std::size_t second_length : kLengths) {
+      const std::vector<bool> first_bits = random_bits(first_length, 1);
+      const std::vector<bool> second_bits = random_bits(second_length, 2);
+
+      const BitVector first = create_bitvector(first_bits);
+      const BitVector second = create_bitvector(second_bits);
+      const Select first_select(first);
+
+      const BitVector result = BitVector::concat(first, second);
+      const Select select(result, first_select, first_length);
+
+      std::vector<bool> bits = first_bits;
+      bits.insert(bits.end(), second_bits.begin(), second_bits.end());
+      test_equal(result, select, bits);
+    }
+  }
+}
+
+TEST(ConcatSplitTest, Split) {
+  for (const std::size_t length : kLengths) {
+    const std::vector<bool> bits = random_bits(length, 1);
+    const BitVector bitvector = create_bitvector(bits);
+    const Select select(bitvector);
+
+    for (const std::size_t pos : kLengths) {
+      if (pos > length) {
+        continue;
+      }
+
+      const auto [first, second] = BitVector::split(bitvector, pos);
+      const Select first_select(first, select, pos);
+      const Select second_select(second);
+
+      test_equal(first, first_select,
+                 std::vector<bool>(bits.begin(), bits.begin() + pos));
+      test_equal(second, second_select,
+                 std::vector<bool>(bits.begin() + pos, bits.end()));
+    }
+  }
+}
+
+}  // namespace
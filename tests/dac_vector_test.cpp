@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <bitsy/dac_vector.hpp>
+
+namespace {
+using namespace bitsy;
+
+constexpr auto kLengths = {0, 1, 63, 64, 65, 1000, 100000};
+
+std::vector<std::uint64_t> create_skewed_ints(const std::size_t length) {
+  std::mt19937_64 gen(length);
+  std::geometric_distribution<std::size_t> width_dist(0.2);
+
+  // Most integers are small, but some use all 64 bits.
+  std::vector<std::uint64_t> ints(length);
+  for (std::uint64_t& value : ints) {
+    const std::size_t width = std::min<std::size_t>(width_dist(gen), 64);
+    value = (width == 64) ? gen() : gen() & ((std::uint64_t{1} << width) - 1);
+  }
+
+  if (length > 0) {
+    ints[length / 2] = std::numeric_limits<std::uint64_t>::max();
+  }
+
+  return ints;
+}
+
+template <typename DacVector>
+void test_dac_vector(const std::vector<std::uint64_t>& ints) {
+  const DacVector vector{std::span<const std::uint64_t>(ints)};
+  ASSERT_EQ(vector.length(), ints.size());
+
+  for (std::size_t pos = 0; pos < ints.size(); ++pos) {
+    EXPECT_EQ(ints[pos], vector.access(pos));
+  }
+
+  for (const std::size_t first : {std::size_t{0}, ints.size() / 3}) {
+    std::vector<std::uint64_t> decoded(ints.size() - first);
+    vector.decode(first, decoded.size(), decoded.data());
+    for (std::size_t i = 0; i < decoded.size(); ++i) {
+      EXPECT_EQ(ints[first + i], decoded[i]);
+    }
+  }
+}
+
+TEST(DacVectorTest, Skewed) {
+  for (const std::size_t length : kLengths) {
+    const auto ints = create_skewed_ints(length);
+    test_dac_vector<DacVector<>>(ints);
+    test_dac_vector<DacVector<4>>(ints);
+    test_dac_vector<DacVector<7>>(ints);
+  }
+}
+
+TEST(DacVectorTest, Small) {
+  for (const std::size_t length : kLengths) {
+    const std::vector<std::uint64_t> ints(length, 5);
+    const DacVector<> vector{std::span<const std::uint64_t>(ints)};
+    EXPECT_EQ(vector.num_levels(), 1);
+    test_dac_vector<DacVector<>>(ints);
+  }
+}
+
+}  // namespace
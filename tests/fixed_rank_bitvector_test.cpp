@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <bitsy/rank/fixed_rank_bitvector.hpp>
+
+namespace {
+using namespace bitsy;
+
+constexpr auto kDigits = [] {
+  FixedRankBitVector<256> bitvector;
+  for (char c = '0'; c <= '9'; ++c) {
+    bitvector.set(static_cast<unsigned char>(c));
+  }
+  bitvector.update();
+  return bitvector;
+}();
+
+static_assert(kDigits.is_set('5'));
+static_assert(!kDigits.is_set('a'));
+static_assert(kDigits.num_ones() == 10);
+static_assert(kDigits.rank1('3') == 3);
+static_assert(kDigits.rank0('0') == '0');
+static_assert(kDigits.select1(1) == '0');
+static_assert(kDigits.select1(10) == '9');
+static_assert(kDigits.select0('0' + 1) == ':');
+
+template <std::size_t Length, std::size_t BlockWidth>
+void test_random(const double fillratio) {
+  FixedRankBitVector<Length, BlockWidth> bitvector;
+  std::vector<bool> bits(Length);
+
+  std::mt19937 gen(1);
+  std::bernoulli_distribution dist(fillratio);
+  for (std::size_t pos = 0; pos < Length; ++pos) {
+    bits[pos] = dist(gen);
+    bitvector.set(pos, bits[pos]);
+  }
+  bitvector.update();
+
+  std::size_t num_zeros = 0;
+  std::size_t num_ones = 0;
+  for (std::size_t pos = 0; pos < Length; ++pos) {
+    EXPECT_EQ(bitvector.is_set(pos), bits[pos]);
+    EXPECT_EQ(bitvector.rank0(pos), num_zeros);
+    EXPECT_EQ(bitvector.rank1(pos), num_ones);
+
+    if (bits[pos]) {
+      EXPECT_EQ(bitvector.select1(++num_ones), pos);
+    } else {
+      EXPECT_EQ(bitvector.select0(++num_zeros), pos);
+    }
+  }
+
+  EXPECT_EQ(bitvector.rank1(Length), num_ones);
+  EXPECT_EQ(bitvector.num_ones(), num_ones);
+}
+
+TEST(FixedRankBitVectorTest, Random) {
+  for (const double fillratio : {0.1, 0.5, 0.9}) {
+    test_random<1, 512>(fillratio);
+    test_random<63, 512>(fillratio);
+    test_random<512, 512>(fillratio);
+    test_random<1000, 128>(fillratio);
+    test_random<70000, 512>(fillratio);
+  }
+}
+
+TEST(FixedRankBitVectorTest, Unset) {
+  FixedRankBitVector<128> bitvector;
+  bitvector.set(3);
+  bitvector.set(100);
+  bitvector.unset(3);
+  bitvector.update();
+
+  EXPECT_FALSE(bitvector.is_set(3));
+  EXPECT_EQ(bitvector.num_ones(), 1);
+  EXPECT_EQ(bitvector.select1(1), 100);
+}
+
+}  // namespace
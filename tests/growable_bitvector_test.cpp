@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitsy/growable_bitvector.hpp>
+#include <bitsy/util/math.hpp>
+
+namespace {
+using namespace bitsy;
+
+// Use small segments and a small stride, such that many segments and samples
+// are created.
+using BitVector = GrowableBitVector<512, 14, 512, 2>;
+
+template <typename GrowableBitVector>
+void test_prefix(const GrowableBitVector& bitvector,
+                 const std::vector<bool>& bits) {
+  ASSERT_EQ(bitvector.length(), bits.size());
+
+  std::size_t num_zeros = 0;
+  std::size_t num_ones = 0;
+  for (std::size_t pos = 0; pos < bits.size(); ++pos) {
+    EXPECT_EQ(bitvector.is_set(pos), bits[pos]);
+    EXPECT_EQ(bitvector.rank0(pos), num_zeros);
+    EXPECT_EQ(bitvector.rank1(pos), num_ones);
+
+    if (bits[pos]) {
+      EXPECT_EQ(bitvector.select1(++num_ones), pos);
+    } else {
+      EXPECT_EQ(bitvector.select0(++num_zeros), pos);
+    }
+  }
+
+  EXPECT_EQ(bitvector.rank1(bits.size()), num_ones);
+  EXPECT_EQ(bitvector.num_ones(), num_ones);
+}
+
+TEST(GrowableBitVectorTest, Empty) {
+  const GrowableBitVector bitvector;
+  EXPECT_EQ(bitvector.length(), 0);
+  EXPECT_EQ(bitvector.rank1(0), 0);
+  EXPECT_EQ(bitvector.num_segments(), 1);
+}
+
+TEST(GrowableBitVectorTest, PushBack) {
+  for (const float fillratio : {0.1, 0.5, 0.9}) {
+    BitVector bitvector;
+    std::vector<bool> bits;
+
+    std::mt19937 gen(1);
+    std::bernoulli_distribution dist(fillratio);
+    for (const std::size_t length : {1, 63, 64, 65, 497, 498, 499, 15936,
+                                     15937, 2 * 15936 + 1, 100000}) {
+      while (bits.size() < length) {
+        const bool value = dist(gen);
+        bitvector.push_back(value);
+        bits.push_back(value);
+      }
+
+      test_prefix(bitvector, bits);
+    }
+
+    EXPECT_EQ(bitvector.num_segments(), math::div_ceil(100001, 2 * 15936));
+  }
+}
+
+TEST(GrowableBitVectorTest, AppendWord) {
+  BitVector bitvector;
+  std::vector<bool> bits;
+
+  std::mt19937_64 gen(1);
+  std::uniform_int_distribution<std::size_t> num_bits_dist(0, 64);
+  for (std::size_t i = 0; i < 20000; ++i) {
+    // Mix sparse, dense and random words.
+    const std::uint64_t random = gen();
+    const std::uint64_t word = (i % 3 == 0)   ? (random & gen() & gen())
+                               : (i % 3 == 1) ? (random | gen() | gen())
+                                              : random;
+    const std::size_t num_bits = num_bits_dist(gen);
+
+    bitvector.append_word(word, num_bits);
+    for (std::size_t bit = 0; bit < num_bits; ++bit) {
+      bits.push_back(((word >> bit) & 1) == 1);
+    }
+
+    if (i % 5000 == 0) {
+      test_prefix(bitvector, bits);
+    }
+  }
+
+  test_prefix(bitvector, bits);
+}
+
+TEST(GrowableBitVectorTest, DefaultSegments) {
+  GrowableBitVector bitvector;
+  std::vector<bool> bits;
+
+  // Fill more than one segment of the default size.
+  const std::size_t length =
+      GrowableBitVector<>::kNumBlocksPerSegment *
+          GrowableBitVector<>::kBlockDataWidth +
+      1000;
+
+  std::mt19937_64 gen(1);
+  while (bits.size() < length) {
+    const std::uint64_t word = gen();
+    bitvector.append_word(word, 64);
+    for (std::size_t bit = 0; bit < 64; ++bit) {
+      bits.push_back(((word >> bit) & 1) == 1);
+    }
+  }
+
+  EXPECT_EQ(bitvector.num_segments(), 2);
+  test_prefix(bitvector, bits);
+}
+
+}  // namespace
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include <bitsy/int_vector.hpp>
+#include <bitsy/util/math.hpp>
+
+namespace {
+using namespace bitsy;
+
+constexpr auto kLengths = {0, 1, 7, 8, 9, 63, 64, 65, 1000, 4099};
+
+std::vector<std::uint64_t> create_random_ints(const std::size_t length,
+                                              const std::size_t width) {
+  std::mt19937_64 gen(length * 64 + width);
+  std::vector<std::uint64_t> ints(length);
+  for (std::uint64_t& value : ints) {
+    value = gen() & math::setbits<std::uint64_t>(width);
+  }
+
+  return ints;
+}
+
+template <typename IntVector>
+void test_int_vector(const IntVector& vector,
+                     const std::vector<std::uint64_t>& ints) {
+  ASSERT_EQ(vector.length(), ints.size());
+  for (std::size_t pos = 0; pos < ints.size(); ++pos) {
+    EXPECT_EQ(ints[pos], vector.get(pos));
+  }
+
+  std::size_t pos = 0;
+  for (const std::uint64_t value : vector) {
+    EXPECT_EQ(ints[pos++], value);
+  }
+  EXPECT_EQ(pos, ints.size());
+
+  // Decode from an unaligned position such that values cross word boundaries.
+  for (const std::size_t first : {std::size_t{0}, ints.size() / 3}) {
+    std::vector<std::uint64_t> decoded(ints.size() - first);
+    vector.decode(first, decoded.size(), decoded.data());
+    for (std::size_t i = 0; i < decoded.size(); ++i) {
+      EXPECT_EQ(ints[first + i], decoded[i]);
+    }
+  }
+}
+
+template <std::size_t Width>
+void test_int_vector_width(const std::size_t width) {
+  for (const std::size_t length : kLengths) {
+    const auto ints = create_random_ints(length, width);
+
+    IntVector<Width> vector(length, width);
+    EXPECT_EQ(vector.width(), width);
+    for (std::size_t pos = 0; pos < length; ++pos) {
+      vector.set(pos, ints[pos]);
+    }
+    test_int_vector(vector, ints);
+
+    IntVector<Width> encoded(length, width);
+    encoded.encode(0, length, ints.data());
+    test_int_vector(encoded, ints);
+
+    // Overwriting must not affect the neighbouring values, whereby the bits of
+    // the new values are inverted such that every overwritten value changes.
+    std::vector<std::uint64_t> other_ints(length);
+    for (std::size_t pos = 0; pos < length; ++pos) {
+      other_ints[pos] = ~ints[pos] & math::setbits<std::uint64_t>(width);
+    }
+    encoded.encode(length / 2, length - length / 2,
+                   other_ints.data() + length / 2);
+
+    auto expected = ints;
+    std::copy(other_ints.begin() + length / 2, other_ints.end(),
+              expected.begin() + length / 2);
+    test_int_vector(encoded, expected);
+  }
+}
+
+TEST(IntVectorTest, CompileTimeWidth) {
+  test_int_vector_width<1>(1);
+  test_int_vector_width<3>(3);
+  test_int_vector_width<8>(8);
+  test_int_vector_width<13>(13);
+  test_int_vector_width<16>(16);
+  test_int_vector_width<32>(32);
+  test_int_vector_width<64>(64);
+}
+
+TEST(IntVectorTest, RuntimeWidth) {
+  for (const std::size_t width : std::views::iota(1, 65)) {
+    test_int_vector_width<0>(width);
+  }
+}
+
+}  // namespace
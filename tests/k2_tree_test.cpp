@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <bitsy/k2_tree.hpp>
+#include <bitsy/util/math.hpp>
+
+namespace {
+using namespace bitsy;
+
+using Edge = std::pair<std::uint64_t, std::uint64_t>;
+
+constexpr auto kNumNodes = {1, 2, 3, 16, 17, 1000};
+
+std::vector<Edge> create_random_edges(const std::size_t num_nodes,
+                                      const std::size_t num_edges) {
+  std::mt19937 gen(num_nodes);
+  std::uniform_int_distribution<std::uint64_t> dist(0, num_nodes - 1);
+
+  std::vector<Edge> edges(num_edges);
+  for (Edge& edge : edges) {
+    edge = {dist(gen), dist(gen)};
+  }
+
+  return edges;
+}
+
+template <typename K2Tree>
+void test_k2_tree(const std::size_t num_nodes,
+                  const std::vector<Edge>& edges,
+                  const std::size_t num_threads) {
+  const K2Tree tree(num_nodes, std::span<const Edge>(edges), num_threads);
+  const std::set<Edge> edge_set(edges.begin(), edges.end());
+  EXPECT_EQ(tree.num_edges(), edge_set.size());
+
+  for (std::uint64_t source = 0; source < num_nodes; ++source) {
+    std::vector<std::uint64_t> expected_targets;
+    std::vector<std::uint64_t> expected_sources;
+    for (std::uint64_t target = 0; target < num_nodes; ++target) {
+      const bool has_edge = edge_set.contains({source, target});
+      EXPECT_EQ(has_edge, tree.has_edge(source, target));
+
+      if (has_edge) {
+        expected_targets.push_back(target);
+      }
+      if (edge_set.contains({target, source})) {
+        expected_sources.push_back(target);
+      }
+    }
+
+    EXPECT_EQ(expected_targets, tree.neighbors(source));
+    EXPECT_EQ(expected_sources, tree.reverse_neighbors(source));
+  }
+
+  // Query a range that does not start at a submatrix boundary.
+  const std::uint64_t first = num_nodes / 3;
+  const std::uint64_t last = num_nodes - num_nodes / 4;
+  std::vector<Edge> expected_edges;
+  for (const Edge& edge : edge_set) {
+    if (edge.first >= first && edge.first < last && edge.second >= first &&
+        edge.second < last) {
+      expected_edges.push_back(edge);
+    }
+  }
+
+  std::vector<Edge> range_edges;
+  tree.for_each_edge(
+      first, last, first, last,
+      [&](const std::uint64_t source, const std::uint64_t target) {
+        range_edges.emplace_back(source, target);
+      });
+  std::sort(range_edges.begin(), range_edges.end());
+  EXPECT_EQ(expected_edges, range_edges);
+}
+
+template <typename K2Tree>
+void test_k2_tree_random() {
+  for (const std::size_t num_nodes : kNumNodes) {
+    for (const std::size_t num_edges :
+         {std::size_t{0}, num_nodes, num_nodes * 5}) {
+      const auto edges = create_random_edges(num_nodes, num_edges);
+      test_k2_tree<K2Tree>(num_nodes, edges, 1);
+      test_k2_tree<K2Tree>(num_nodes, edges, 4);
+    }
+  }
+}
+
+TEST(K2TreeTest, Random) {
+  test_k2_tree_random<K2Tree<2>>();
+  test_k2_tree_random<K2Tree<4>>();
+}
+
+TEST(K2TreeTest, TooManyNodes) {
+  const std::size_t max_num_nodes = math::pow2<std::size_t>(32);
+  const std::vector<Edge> edges = {{0, 1}, {max_num_nodes - 1, 0}};
+
+  const K2Tree<2> tree(max_num_nodes, std::span<const Edge>(edges));
+  EXPECT_TRUE(tree.has_edge(max_num_nodes - 1, 0));
+  EXPECT_THROW(K2Tree<2>(max_num_nodes + 1, std::span<const Edge>(edges)),
+               std::invalid_argument);
+  EXPECT_THROW(K2Tree<8>(max_num_nodes, std::span<const Edge>(edges)),
+               std::invalid_argument);
+}
+
+}  // namespace
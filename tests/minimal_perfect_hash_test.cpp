@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <bitsy/minimal_perfect_hash.hpp>
+
+namespace {
+using namespace bitsy;
+
+constexpr auto kNumKeys = {0, 1, 2, 100, 10000, 1000000};
+
+std::vector<std::uint64_t> create_keys(const std::size_t num_keys) {
+  std::mt19937_64 gen(num_keys);
+
+  std::vector<std::uint64_t> keys;
+  while (keys.size() < num_keys) {
+    while (keys.size() < num_keys) {
+      keys.push_back(gen());
+    }
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  }
+
+  std::shuffle(keys.begin(), keys.end(), gen);
+  return keys;
+}
+
+template <typename MinimalPerfectHash>
+void test_mphf(const std::vector<std::uint64_t>& keys,
+               const double gamma,
+               const std::size_t num_threads) {
+  const std::span<const std::uint64_t> key_span(keys);
+  const MinimalPerfectHash mphf(key_span, gamma, num_threads);
+  ASSERT_EQ(mphf.num_keys(), keys.size());
+
+  std::vector<bool> is_used(keys.size(), false);
+  for (const std::uint64_t key : keys) {
+    const std::size_t value = mphf.lookup(key);
+    ASSERT_LT(value, keys.size());
+    EXPECT_FALSE(is_used[value]);
+    is_used[value] = true;
+  }
+
+  std::vector<std::size_t> values(keys.size());
+  mphf.lookup(key_span, values.data());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(values[i], mphf.lookup(keys[i]));
+  }
+}
+
+TEST(MinimalPerfectHashTest, Random) {
+  for (const std::size_t num_keys : kNumKeys) {
+    const std::vector<std::uint64_t> keys = create_keys(num_keys);
+
+    for (const double gamma : {1.0, 2.0, 5.0}) {
+      for (const std::size_t num_threads : {1, 4}) {
+        test_mphf<MinimalPerfectHash<>>(keys, gamma, num_threads);
+      }
+    }
+  }
+}
+
+TEST(MinimalPerfectHashTest, Fallback) {
+  for (const std::size_t num_keys : kNumKeys) {
+    const std::vector<std::uint64_t> keys = create_keys(num_keys);
+
+    // With few levels, many keys remain for the fallback array.
+    test_mphf<MinimalPerfectHash<2>>(keys, 1.0, 4);
+  }
+}
+
+TEST(MinimalPerfectHashTest, Space) {
+  const std::vector<std::uint64_t> keys = create_keys(1000000);
+  const MinimalPerfectHash mphf{std::span<const std::uint64_t>(keys)};
+
+  EXPECT_EQ(mphf.num_fallback_keys(), 0);
+  EXPECT_LT(mphf.memory_space(), 4 * keys.size());
+}
+
+TEST(MinimalPerfectHashTest, InvalidNumThreads) {
+  const std::vector<std::uint64_t> keys = create_keys(100);
+  const std::span<const std::uint64_t> span(keys);
+  EXPECT_THROW(MinimalPerfectHash<>(span, 2.0, 0), std::invalid_argument);
+}
+
+}  // namespace
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <bitsy/quotient_filter.hpp>
+
+namespace {
+using namespace bitsy;
+
+std::vector<std::uint64_t> create_keys(const std::size_t num_keys,
+                                       const std::size_t seed) {
+  std::mt19937_64 gen(seed);
+
+  std::vector<std::uint64_t> keys(num_keys);
+  for (std::uint64_t& key : keys) {
+    key = gen();
+  }
+
+  return keys;
+}
+
+TEST(QuotientFilterTest, InsertContains) {
+  for (const std::size_t num_keys : {0, 1, 100, 10000, 100000}) {
+    const std::vector<std::uint64_t> keys = create_keys(num_keys, num_keys);
+
+    QuotientFilter filter(18);
+    for (const std::uint64_t key : keys) {
+      ASSERT_TRUE(filter.insert(key));
+    }
+    EXPECT_EQ(filter.num_elements(), num_keys);
+
+    for (const std::uint64_t key : keys) {
+      EXPECT_TRUE(filter.contains(key));
+      EXPECT_GE(filter.count(key), 1);
+    }
+  }
+}
+
+TEST(QuotientFilterTest, FalsePositiveRate) {
+  constexpr std::size_t kNumKeys = 100000;
+  const std::vector<std::uint64_t> keys = create_keys(kNumKeys, 1);
+  const std::vector<std::uint64_t> other_keys = create_keys(kNumKeys, 2);
+
+  // With a load factor of ~0.76, we expect a false positive rate of ~0.3%.
+  QuotientFilter filter(17);
+  filter.insert(std::span<const std::uint64_t>(keys));
+
+  std::size_t num_false_positives = 0;
+  for (const std::uint64_t key : other_keys) {
+    num_false_positives += filter.contains(key) ? 1 : 0;
+  }
+
+  EXPECT_LT(num_false_positives, kNumKeys / 100);
+}
+
+TEST(QuotientFilterTest, Bulk) {
+  const std::vector<std::uint64_t> keys = create_keys(50000, 3);
+  const std::vector<std::uint64_t> other_keys = create_keys(50000, 4);
+
+  QuotientFilter filter(16);
+  EXPECT_TRUE(filter.insert(std::span<const std::uint64_t>(keys)));
+  EXPECT_EQ(filter.num_elements(), keys.size());
+
+  const auto contained = std::make_unique<bool[]>(other_keys.size());
+  filter.contains(std::span<const std::uint64_t>(other_keys), contained.get());
+  for (std::size_t i = 0; i < other_keys.size(); ++i) {
+    EXPECT_EQ(contained[i], filter.contains(other_keys[i]));
+  }
+}
+
+TEST(QuotientFilterTest, Erase) {
+  std::mt19937_64 gen(5);
+  const std::vector<std::uint64_t> keys = create_keys(20000, 5);
+
+  // Insert and erase keys randomly, such that long clusters are created and
+  // shifted in both directions.
+  QuotientFilter<std::uint16_t> filter(15, 12);
+  std::map<std::uint64_t, std::size_t> counts;
+  for (std::size_t i = 0; i < 200000; ++i) {
+    const std::uint64_t key = keys[gen() % keys.size()];
+
+    if (gen() % 3 != 0) {
+      ASSERT_TRUE(filter.insert(key));
+      counts[key] += 1;
+    } else if (counts[key] > 0) {
+      ASSERT_TRUE(filter.erase(key));
+      counts[key] -= 1;
+    }
+  }
+
+  std::size_t num_elements = 0;
+  for (const auto& [key, count] : counts) {
+    EXPECT_GE(filter.count(key), count);
+    num_elements += count;
+  }
+  EXPECT_EQ(filter.num_elements(), num_elements);
+
+  // After erasing all keys, the filter has to be empty.
+  for (const auto& [key, count] : counts) {
+    for (std::size_t i = 0; i < count; ++i) {
+      ASSERT_TRUE(filter.erase(key));
+    }
+  }
+
+  EXPECT_EQ(filter.num_elements(), 0);
+  for (const std::uint64_t key : keys) {
+    EXPECT_FALSE(filter.contains(key));
+  }
+}
+
+TEST(QuotientFilterTest, Resize) {
+  const std::vector<std::uint64_t> keys = create_keys(100000, 6);
+
+  // The filter starts with a single block and has to be resized repeatedly.
+  QuotientFilter<std::uint16_t> filter(6);
+  for (const std::uint64_t key : keys) {
+    ASSERT_TRUE(filter.insert(key));
+  }
+
+  EXPECT_EQ(filter.quotient_width(), 17);
+  EXPECT_EQ(filter.remainder_width(), 5);
+  EXPECT_EQ(filter.num_elements(), keys.size());
+  for (const std::uint64_t key : keys) {
+    EXPECT_TRUE(filter.contains(key));
+  }
+}
+
+TEST(QuotientFilterTest, InvalidWidths) {
+  EXPECT_THROW(QuotientFilter<>(5), std::invalid_argument);
+  EXPECT_THROW(QuotientFilter<>(6, 0), std::invalid_argument);
+  EXPECT_THROW(QuotientFilter<>(6, 9), std::invalid_argument);
+  EXPECT_THROW(QuotientFilter<std::uint64_t>(6, 59), std::invalid_argument);
+  EXPECT_NO_THROW(QuotientFilter<std::uint64_t>(6, 58));
+}
+
+}  // namespace
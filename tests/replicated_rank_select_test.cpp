@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include <bitsy/rank/two_layer_rank_combined_bitvector.hpp>
+#include <bitsy/replicated_rank_select.hpp>
+#include <bitsy/select/two_layer_select.hpp>
+#include <bitsy/util/numa.hpp>
+#include <bitsy/util/static_vector.hpp>
+
+#include "bitvector_util.hpp"
+
+namespace {
+using namespace bitsy;
+using namespace bitsy::testing;
+
+constexpr auto kLengths = {0,   1,   63,    64,    65,    511,
+                           512, 513, 16383, 16384, 16385, math::pow2(22) + 7};
+
+TEST(NumaTest, Policies) {
+  EXPECT_GE(numa::num_nodes(), 1);
+  EXPECT_LT(numa::current_node(), numa::num_nodes());
+
+  for (const NumaPolicy policy :
+       {NumaPolicy{}, NumaPolicy::local(), NumaPolicy::interleave(),
+        NumaPolicy::bind(0)}) {
+    for (const std::size_t size : {0, 1, 1000, 1000000}) {
+      StaticVector<std::uint64_t> vector(size, policy);
+
+      for (std::size_t i = 0; i < size; ++i) {
+        vector[i] = i;
+      }
+
+      for (std::size_t i = 0; i < size; ++i) {
+        EXPECT_EQ(vector[i], i);
+      }
+    }
+  }
+}
+
+TEST(ReplicatedRankSelectTest, Random) {
+  using BitVector = TwoLayerRankCombinedBitVector<>;
+  using Select = TwoLayerSelect<BitVector>;
+
+  for (const std::size_t length : kLengths) {
+    auto bitvector = create_random_bitvec<BitVector>(length, 0.5, 1);
+    bitvector.update();
+    const Select select(bitvector);
+
+    // Also replicate onto more nodes than the system might have, in which case
+    // the memory is placed on a best-effort basis.
+    for (const std::size_t num_nodes : {numa::num_nodes(), std::size_t(2)}) {
+      const ReplicatedRankSelect replicated(bitvector, select, num_nodes);
+      EXPECT_EQ(replicated.num_replicas(), num_nodes);
+      EXPECT_EQ(replicated.memory_space(),
+                num_nodes * (bitvector.memory_space() + select.memory_space()));
+
+      for (std::size_t node = 0; node < num_nodes; ++node) {
+        const auto& [replica_bitvector, replica_select] =
+            replicated.replica(node);
+
+        std::size_t num_ones = 0;
+        for (std::size_t pos = 0; pos < length; ++pos) {
+          const bool is_set = bitvector.is_set(pos);
+          EXPECT_EQ(is_set, replica_bitvector.is_set(pos));
+          EXPECT_EQ(num_ones, replica_bitvector.rank1(pos));
+
+          if (is_set) {
+            EXPECT_EQ(pos, replica_select.select1(++num_ones));
+          } else {
+            EXPECT_EQ(pos, replica_select.select0(pos - num_ones + 1));
+          }
+        }
+      }
+
+      EXPECT_EQ(&replicated.local(),
+                &replicated.replica(numa::current_node()));
+    }
+  }
+}
+
+TEST(ReplicatedRankSelectTest, NoNodes) {
+  using BitVector = TwoLayerRankCombinedBitVector<>;
+  using Select = TwoLayerSelect<BitVector>;
+
+  auto bitvector = create_random_bitvec<BitVector>(1000, 0.5, 1);
+  bitvector.update();
+  const Select select(bitvector);
+
+  EXPECT_THROW(ReplicatedRankSelect(bitvector, select, 0),
+               std::invalid_argument);
+}
+
+}  // namespace
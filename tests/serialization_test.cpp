@@ -0,0 +1,404 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <bitsy/io/compressed.hpp>
+#include <bitsy/io/out_of_core.hpp>
+#include <bitsy/io/serialization.hpp>
+#include <bitsy/io/streaming_builder.hpp>
+#include <bitsy/rank/two_layer_rank_combined_bitvector.hpp>
+#include <bitsy/select/two_layer_select.hpp>
+
+#include "bitvector_util.hpp"
+
+namespace {
+using namespace bitsy;
+using namespace bitsy::testing;
+
+constexpr auto kLengths = {0,     1,     63,    64,    65,
+                           497,   498,   499,   511,   512,
+                           15935, 15936, 15937, 16384, 3 * 15936 + 500,
+                           math::pow2(22) + 7};
+
+// Prefixes the name with the name of the running test, as the tests are run as
+// separate processes that may write their files concurrently.
+std::string temporary_filename(const std::string& name) {
+  const auto* const info =
+      ::testing::UnitTest::GetInstance()->current_test_info();
+  const std::string prefix =
+      std::string(info->test_suite_name()) + "_" + info->name() + "_";
+  return (std::filesystem::temp_directory_path() / (prefix + name)).string();
+}
+
+std::vector<char> read_file(const std::string& filename) {
+  std::ifstream in(filename, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+template <typename BitVector, typename Select>
+void test_roundtrip(const std::size_t length, const float fillratio) {
+  const std::string saved_file = temporary_filename("bitsy_saved.bin");
+  const std::string built_file = temporary_filename("bitsy_built.bin");
+
+  auto bitvector = create_random_bitvec<BitVector>(length, fillratio, 1);
+  bitvector.update();
+  const Select select(bitvector);
+  serialization::save(saved_file, bitvector, select);
+
+  // Stream the same bits, alternating between single bits and words of
+  // varying width.
+  {
+    serialization::StreamingBuilder<BitVector, Select> builder(built_file);
+
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<std::size_t> num_bits_dist(0, 64);
+    std::size_t pos = 0;
+    while (pos < length) {
+      if (pos % 2 == 0) {
+        builder.push_back(bitvector.is_set(pos++));
+        continue;
+      }
+
+      const std::size_t num_bits =
+          std::min(num_bits_dist(gen), length - pos);
+      std::uint64_t word = 0;
+      for (std::size_t bit = 0; bit < num_bits; ++bit) {
+        word |= static_cast<std::uint64_t>(bitvector.is_set(pos++)) << bit;
+      }
+      builder.append_word(word, num_bits);
+    }
+
+    EXPECT_EQ(builder.length(), length);
+    builder.finish();
+  }
+
+  EXPECT_EQ(read_file(saved_file), read_file(built_file));
+
+  const auto loaded = serialization::load<BitVector, Select>(built_file);
+  EXPECT_EQ(loaded->bitvector.length(), length);
+  EXPECT_EQ(loaded->bitvector.num_ones(), bitvector.num_ones());
+
+  std::size_t num_zeros = 0;
+  std::size_t num_ones = 0;
+  for (std::size_t pos = 0; pos < length; ++pos) {
+    EXPECT_EQ(loaded->bitvector.rank1(pos), num_ones);
+
+    if (bitvector.is_set(pos)) {
+      EXPECT_TRUE(loaded->bitvector.is_set(pos));
+      EXPECT_EQ(loaded->select.select1(++num_ones), pos);
+    } else {
+      EXPECT_FALSE(loaded->bitvector.is_set(pos));
+      EXPECT_EQ(loaded->select.select0(++num_zeros), pos);
+    }
+  }
+
+  std::filesystem::remove(saved_file);
+  std::filesystem::remove(built_file);
+}
+
+TEST(SerializationTest, StreamingBuilder) {
+  using BitVector = TwoLayerRankCombinedBitVector<>;
+  using BitVector1024 = TwoLayerRankCombinedBitVector<1024, 15>;
+
+  for (const std::size_t length : kLengths) {
+    for (const float fillratio : {0.1, 0.5, 0.9}) {
+      test_roundtrip<BitVector, TwoLayerSelect<BitVector>>(length, fillratio);
+      test_roundtrip<BitVector, TwoLayerSelect<BitVector, true, 512>>(
+          length, fillratio);
+      test_roundtrip<BitVector1024, TwoLayerSelect<BitVector1024>>(length,
+                                                                   fillratio);
+    }
+  }
+}
+
+TEST(SerializationTest, OutOfCore) {
+  using BitVector = TwoLayerRankCombinedBitVector<>;
+  using Select = TwoLayerSelect<BitVector>;
+  const std::string filename = temporary_filename("bitsy_mapped.bin");
+
+  for (const std::size_t length : kLengths) {
+    for (const auto access : {serialization::Access::RANDOM,
+                              serialization::Access::SEQUENTIAL}) {
+      auto bitvector = create_random_bitvec<BitVector>(length, 0.5, 1);
+      bitvector.update();
+      const Select select(bitvector);
+      serialization::save(filename, bitvector, select);
+
+      const auto mapped =
+          serialization::map<BitVector, Select>(filename, access);
+      EXPECT_EQ(mapped->bitvector.length(), length);
+      EXPECT_EQ(mapped->bitvector.num_ones(), bitvector.num_ones());
+
+      // Query the positions in random order, such that the pages are read in
+      // random order as well.
+      std::vector<std::size_t> positions(length);
+      std::iota(positions.begin(), positions.end(), 0);
+      std::shuffle(positions.begin(), positions.end(), std::mt19937(1));
+
+      std::vector<std::size_t> ranks;
+      for (const std::size_t pos : positions) {
+        EXPECT_EQ(mapped->bitvector.is_set(pos), bitvector.is_set(pos));
+        EXPECT_EQ(mapped->bitvector.rank1(pos), bitvector.rank1(pos));
+
+        if (bitvector.is_set(pos)) {
+          ranks.push_back(bitvector.rank1(pos) + 1);
+        }
+      }
+
+      std::vector<std::uint64_t> answers(positions.size());
+      serialization::batch_rank1(mapped->bitvector, positions, answers);
+      for (std::size_t i = 0; i < positions.size(); ++i) {
+        EXPECT_EQ(answers[i], bitvector.rank1(positions[i]));
+      }
+
+      serialization::batch_rank0(mapped->bitvector, positions, answers);
+      for (std::size_t i = 0; i < positions.size(); ++i) {
+        EXPECT_EQ(answers[i], bitvector.rank0(positions[i]));
+      }
+
+      answers.resize(ranks.size());
+      serialization::batch_select1(mapped->select, ranks, answers);
+      for (std::size_t i = 0; i < ranks.size(); ++i) {
+        EXPECT_EQ(answers[i], select.select1(ranks[i]));
+      }
+
+      // Remove the file while it is mapped, which keeps its pages available.
+      std::filesystem::remove(filename);
+
+      std::vector<std::size_t> zero_ranks(length - bitvector.num_ones());
+      std::iota(zero_ranks.begin(), zero_ranks.end(), 1);
+      std::shuffle(zero_ranks.begin(), zero_ranks.end(), std::mt19937(1));
+
+      answers.resize(zero_ranks.size());
+      serialization::batch_select0(mapped->select, zero_ranks, answers);
+      for (std::size_t i = 0; i < zero_ranks.size(); ++i) {
+        EXPECT_EQ(answers[i], select.select0(zero_ranks[i]));
+      }
+    }
+  }
+}
+
+template <typename BitVector, typename Select>
+void test_compressed(BitVector& bitvector) {
+  const std::string filename = temporary_filename("bitsy_compressed.bin");
+  const std::size_t length = bitvector.length();
+
+  bitvector.update();
+  const Select select(bitvector);
+  serialization::save_compressed(filename, bitvector, select);
+
+  // Use a small cache such that superblocks are evicted and decompressed
+  // again.
+  serialization::CompressedRankSelect<BitVector, Select> compressed(filename,
+                                                                    2);
+  std::filesystem::remove(filename);
+
+  EXPECT_EQ(compressed.length(), length);
+  EXPECT_EQ(compressed.num_ones(), bitvector.num_ones());
+  EXPECT_EQ(compressed.rank1(length), bitvector.num_ones());
+
+  std::vector<std::size_t> positions(length);
+  std::iota(positions.begin(), positions.end(), 0);
+  std::shuffle(positions.begin(), positions.end(), std::mt19937(1));
+
+  // As nearly every query misses the cache, only query a random subset of the
+  // positions of long bit vectors.
+  positions.resize(std::min<std::size_t>(length, 1 << 15));
+  for (const std::size_t pos : positions) {
+    EXPECT_EQ(compressed.is_set(pos), bitvector.is_set(pos));
+    EXPECT_EQ(compressed.rank1(pos), bitvector.rank1(pos));
+    EXPECT_EQ(compressed.rank0(pos), bitvector.rank0(pos));
+
+    if (bitvector.is_set(pos)) {
+      const std::size_t rank = bitvector.rank1(pos) + 1;
+      EXPECT_EQ(compressed.select1(rank), select.select1(rank));
+    } else {
+      const std::size_t rank = bitvector.rank0(pos) + 1;
+      EXPECT_EQ(compressed.select0(rank), select.select0(rank));
+    }
+  }
+}
+
+TEST(SerializationTest, Compressed) {
+  using BitVector = TwoLayerRankCombinedBitVector<>;
+  using BitVector1024 = TwoLayerRankCombinedBitVector<1024, 15>;
+
+  for (const std::size_t length : kLengths) {
+    for (const float fillratio : {0.0, 0.001, 0.5, 0.999, 1.0}) {
+      auto bitvector = create_random_bitvec<BitVector>(length, fillratio, 1);
+      test_compressed<BitVector, TwoLayerSelect<BitVector>>(bitvector);
+      test_compressed<BitVector, TwoLayerSelect<BitVector, true, 512>>(
+          bitvector);
+
+      auto bitvector1024 =
+          create_random_bitvec<BitVector1024>(length, fillratio, 1);
+      test_compressed<BitVector1024, TwoLayerSelect<BitVector1024>>(
+          bitvector1024);
+    }
+  }
+}
+
+TEST(SerializationTest, CompressedCache) {
+  using BitVector = TwoLayerRankCombinedBitVector<>;
+  const std::string filename = temporary_filename("bitsy_compressed.bin");
+
+  // A sparse bit vector with long runs of zeros compresses well.
+  const std::size_t length = math::pow2(24);
+  auto bitvector = create_random_bitvec<BitVector>(length, 0.001, 1);
+  bitvector.update();
+  serialization::save_compressed(filename, bitvector,
+                                 TwoLayerSelect(bitvector));
+
+  serialization::CompressedRankSelect compressed(filename, 4);
+  EXPECT_LT(compressed.compressed_space(), length / 4);
+
+  // A cold query decompresses exactly one superblock, while queries to cached
+  // superblocks do not decompress any.
+  const std::size_t superblock_width = BitVector::kSuperblockDataWidth;
+  EXPECT_EQ(compressed.rank1(5 * superblock_width + 7),
+            bitvector.rank1(5 * superblock_width + 7));
+  EXPECT_EQ(compressed.num_decompressions(), 1);
+
+  for (std::size_t pos = 0; pos < 4 * superblock_width; ++pos) {
+    EXPECT_EQ(compressed.rank1(pos), bitvector.rank1(pos));
+  }
+  EXPECT_EQ(compressed.num_decompressions(), 5);
+
+  // The least recently used superblock has been evicted.
+  EXPECT_EQ(compressed.rank1(5 * superblock_width),
+            bitvector.rank1(5 * superblock_width));
+  EXPECT_EQ(compressed.num_decompressions(), 6);
+  EXPECT_EQ(compressed.is_set(3 * superblock_width),
+            bitvector.is_set(3 * superblock_width));
+  EXPECT_EQ(compressed.num_decompressions(), 6);
+
+  std::filesystem::remove(filename);
+}
+
+TEST(SerializationTest, InvalidFile) {
+  using BitVector = TwoLayerRankCombinedBitVector<>;
+  const std::string filename = temporary_filename("bitsy_invalid.bin");
+
+  auto bitvector = create_random_bitvec<BitVector>(1000, 0.5, 1);
+  bitvector.update();
+  serialization::save(filename, bitvector, TwoLayerSelect(bitvector));
+
+  // A file that stores a different configuration must not be loaded.
+  EXPECT_THROW(
+      (serialization::load<BitVector, TwoLayerSelect<BitVector, true, 512>>(
+          filename)),
+      std::runtime_error);
+
+  // A file that stores only the samples for ones must not be loaded into a
+  // select data structure that supports both kinds of select queries.
+  using Select1 = TwoLayerSelect<BitVector, true, 32768, false, true>;
+  serialization::save(filename, bitvector, Select1(bitvector));
+  EXPECT_THROW(serialization::load(filename), std::runtime_error);
+  EXPECT_NO_THROW((serialization::load<BitVector, Select1>(filename)));
+
+  // A file whose sections do not match its length must not be loaded.
+  serialization::save(filename, bitvector, TwoLayerSelect(bitvector));
+  {
+    std::fstream file(filename,
+                      std::ios::binary | std::ios::in | std::ios::out);
+    serialization::Header header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    header.num_zero_samples = 0;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+  EXPECT_THROW(serialization::load(filename), std::runtime_error);
+
+  // The name of the file is reported when an uncompressed file is opened as
+  // a compressed one.
+  try {
+    serialization::CompressedRankSelect<> compressed(filename);
+    ADD_FAILURE() << "A file that is not compressed has been opened.";
+  } catch (const std::runtime_error& error) {
+    EXPECT_NE(std::string(error.what()).find(filename), std::string::npos);
+  }
+
+  std::ofstream(filename, std::ios::binary) << "not a bit vector";
+  EXPECT_THROW(serialization::load(filename), std::runtime_error);
+
+  std::filesystem::remove(filename);
+}
+
+// Overwrites the integer at an offset in bytes of a file.
+void overwrite(const std::string& filename,
+               const std::size_t offset,
+               const std::uint64_t value) {
+  std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+  file.seekp(static_cast<std::streamoff>(offset));
+  file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+TEST(SerializationTest, InvalidCompressedFile) {
+  using BitVector = TwoLayerRankCombinedBitVector<>;
+  using Compressed = serialization::CompressedRankSelect<>;
+  using serialization::CompressedHeader;
+  const std::string filename = temporary_filename("bitsy_invalid.bin");
+
+  auto bitvector = create_random_bitvec<BitVector>(100000, 0.5, 1);
+  bitvector.update();
+  const auto save = [&] {
+    serialization::save_compressed(filename, bitvector,
+                                   TwoLayerSelect(bitvector));
+  };
+
+  // A file that stores only the samples for ones must not be loaded into a
+  // select data structure that supports both kinds of select queries.
+  using Select1 = TwoLayerSelect<BitVector, true, 32768, false, true>;
+  serialization::save_compressed(filename, bitvector, Select1(bitvector));
+  EXPECT_THROW(Compressed{filename}, std::runtime_error);
+  EXPECT_NO_THROW(
+      (serialization::CompressedRankSelect<BitVector, Select1>(filename)));
+
+  // A file whose sections do not match its length must not be loaded.
+  save();
+  overwrite(filename, offsetof(CompressedHeader, num_zero_samples), 0);
+  EXPECT_THROW(Compressed{filename}, std::runtime_error);
+
+  // A file whose compressed superblocks lie past its end must not be loaded.
+  save();
+  overwrite(filename, offsetof(CompressedHeader, num_data_words), 1 << 30);
+  EXPECT_THROW(Compressed{filename}, std::runtime_error);
+
+  save();
+  std::filesystem::resize_file(filename,
+                               std::filesystem::file_size(filename) - 8);
+  EXPECT_THROW(Compressed{filename}, std::runtime_error);
+
+  // A file whose index is not increasing must not be loaded.
+  save();
+  CompressedHeader header;
+  std::ifstream(filename, std::ios::binary)
+      .read(reinterpret_cast<char*>(&header), sizeof(header));
+  overwrite(filename, header.index_offset + sizeof(std::uint64_t),
+            header.num_data_words * sizeof(std::uint64_t) + 1);
+  EXPECT_THROW(Compressed{filename}, std::runtime_error);
+
+  // A superblock whose encoding is too short is detected once it is
+  // decompressed, while the other superblocks can still be queried.
+  save();
+  overwrite(filename, header.index_offset + sizeof(std::uint64_t), 0);
+  Compressed compressed(filename, 1);
+  EXPECT_THROW((void)compressed.rank1(10), std::runtime_error);
+  const std::size_t pos = 2 * BitVector::kSuperblockDataWidth + 10;
+  EXPECT_EQ(compressed.rank1(pos), bitvector.rank1(pos));
+  EXPECT_THROW((void)compressed.rank1(10), std::runtime_error);
+  EXPECT_EQ(compressed.rank1(pos), bitvector.rank1(pos));
+
+  std::filesystem::remove(filename);
+}
+
+}  // namespace
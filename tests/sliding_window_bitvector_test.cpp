@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <random>
+
+#include <bitsy/sliding_window_bitvector.hpp>
+
+namespace {
+using namespace bitsy;
+
+constexpr std::size_t kSuperblockDataWidth =
+    SlidingWindowBitVector<>::kSuperblockDataWidth;
+
+void test_window(const SlidingWindowBitVector<>& bitvector,
+                 const std::deque<bool>& bits) {
+  ASSERT_EQ(bitvector.window_length(), bits.size());
+
+  std::size_t num_zeros = 0;
+  std::size_t num_ones = 0;
+  for (std::size_t pos = 0; pos < bits.size(); ++pos) {
+    EXPECT_EQ(bitvector.is_set(pos), bits[pos]);
+    EXPECT_EQ(bitvector.rank0(pos), num_zeros);
+    EXPECT_EQ(bitvector.rank1(pos), num_ones);
+
+    if (bits[pos]) {
+      EXPECT_EQ(bitvector.select1(++num_ones), pos);
+    } else {
+      EXPECT_EQ(bitvector.select0(++num_zeros), pos);
+    }
+  }
+
+  EXPECT_EQ(bitvector.rank1(bits.size()), num_ones);
+  EXPECT_EQ(bitvector.num_ones(), num_ones);
+}
+
+TEST(SlidingWindowBitVectorTest, Empty) {
+  const SlidingWindowBitVector bitvector(100);
+  EXPECT_EQ(bitvector.length(), 0);
+  EXPECT_EQ(bitvector.window_length(), 0);
+  EXPECT_EQ(bitvector.rank1(0), 0);
+  EXPECT_EQ(bitvector.num_ones(), 0);
+}
+
+TEST(SlidingWindowBitVectorTest, PushBack) {
+  for (const std::size_t window_length :
+       {1, 64, 497, 498, 15936, 15937, 40000}) {
+    for (const float fillratio : {0.1, 0.5, 0.9}) {
+      SlidingWindowBitVector bitvector(window_length);
+      std::deque<bool> bits;
+
+      std::mt19937 gen(1);
+      std::bernoulli_distribution dist(fillratio);
+      for (std::size_t i = 1; i <= 5 * kSuperblockDataWidth; ++i) {
+        const bool value = dist(gen);
+        bitvector.push_back(value);
+        bits.push_back(value);
+
+        if (bits.size() > window_length) {
+          bits.pop_front();
+        }
+
+        if (i % 7919 == 0) {
+          test_window(bitvector, bits);
+        }
+      }
+
+      test_window(bitvector, bits);
+    }
+  }
+}
+
+TEST(SlidingWindowBitVectorTest, AppendWord) {
+  for (const std::size_t window_length : {100, 20000, 50000}) {
+    SlidingWindowBitVector bitvector(window_length);
+    std::deque<bool> bits;
+
+    std::mt19937_64 gen(1);
+    std::uniform_int_distribution<std::size_t> num_bits_dist(0, 64);
+    for (std::size_t i = 1; i <= 4000; ++i) {
+      const std::uint64_t word = gen();
+      const std::size_t num_bits = num_bits_dist(gen);
+      bitvector.append_word(word, num_bits);
+
+      for (std::size_t j = 0; j < num_bits; ++j) {
+        bits.push_back(((word >> j) & 1) == 1);
+        if (bits.size() > window_length) {
+          bits.pop_front();
+        }
+      }
+
+      if (i % 1000 == 0) {
+        test_window(bitvector, bits);
+      }
+    }
+  }
+}
+
+TEST(SlidingWindowBitVectorTest, AppendZeros) {
+  constexpr std::size_t kWindowLength = 30000;
+  SlidingWindowBitVector bitvector(kWindowLength);
+  std::deque<bool> bits;
+
+  std::mt19937 gen(1);
+  std::bernoulli_distribution dist(0.5);
+  std::uniform_int_distribution<std::size_t> num_zeros_dist(0, 40000);
+  for (std::size_t i = 1; i <= 20; ++i) {
+    for (std::size_t j = 0; j < 1000; ++j) {
+      const bool value = dist(gen);
+      bitvector.push_back(value);
+      bits.push_back(value);
+    }
+
+    const std::size_t num_zeros = num_zeros_dist(gen);
+    bitvector.append_zeros(num_zeros);
+    bits.insert(bits.end(), num_zeros, false);
+
+    while (bits.size() > kWindowLength) {
+      bits.pop_front();
+    }
+
+    test_window(bitvector, bits);
+  }
+}
+
+TEST(SlidingWindowBitVectorTest, MemorySpace) {
+  SlidingWindowBitVector bitvector(3 * kSuperblockDataWidth);
+  const std::size_t memory_space = bitvector.memory_space();
+
+  for (std::size_t i = 0; i < 100 * kSuperblockDataWidth; i += 64) {
+    bitvector.append_word(i, 64);
+  }
+
+  EXPECT_EQ(bitvector.memory_space(), memory_space);
+}
+
+}  // namespace
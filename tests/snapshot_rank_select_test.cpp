@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <bitsy/rank/two_layer_rank_combined_bitvector.hpp>
+#include <bitsy/snapshot_rank_select.hpp>
+#include <bitsy/util/math.hpp>
+
+namespace {
+using namespace bitsy;
+
+using BitVector = TwoLayerRankCombinedBitVector<>;
+using Snapshot = SnapshotRankSelect<BitVector>::Snapshot;
+
+constexpr std::size_t kLength = math::pow2(20) + 7;
+constexpr std::size_t kNumVersions = 8;
+constexpr std::size_t kNumReaders = 3;
+
+// The bits of a version are set at every (version + 1)-th position, such that
+// a reader can check whether its snapshot is consistent.
+BitVector create_bitvec(const std::size_t version) {
+  BitVector bitvector(kLength);
+  for (std::size_t pos = 0; pos < kLength; ++pos) {
+    bitvector.set(pos, pos % (version + 1) == 0);
+  }
+
+  return bitvector;
+}
+
+void check_snapshot(const Snapshot& snapshot, const std::size_t pos) {
+  const std::size_t step = snapshot.version + 1;
+
+  EXPECT_EQ(snapshot.bitvector.is_set(pos), pos % step == 0);
+  EXPECT_EQ(snapshot.bitvector.rank1(pos), math::div_ceil(pos, step));
+
+  const std::size_t num_ones = math::div_ceil(kLength, step);
+  const std::size_t rank = 1 + pos % num_ones;
+  EXPECT_EQ(snapshot.select.select1(rank), (rank - 1) * step);
+}
+
+TEST(SnapshotRankSelectTest, Publish) {
+  SnapshotRankSelect<BitVector> snapshots(create_bitvec(0), 1);
+  EXPECT_EQ(snapshots.version(), 0);
+
+  for (std::size_t version = 1; version < kNumVersions; ++version) {
+    {
+      const auto guard = snapshots.read(0);
+      EXPECT_EQ(guard->version, version - 1);
+    }
+
+    snapshots.publish(create_bitvec(version));
+    EXPECT_EQ(snapshots.version(), version);
+
+    const auto guard = snapshots.read(0);
+    for (std::size_t pos = 0; pos < kLength; pos += 997) {
+      check_snapshot(*guard, pos);
+    }
+  }
+}
+
+TEST(SnapshotRankSelectTest, ConcurrentRebuild) {
+  SnapshotRankSelect<BitVector> snapshots(create_bitvec(0), kNumReaders);
+
+  std::atomic<bool> done = false;
+  std::vector<std::thread> readers;
+  for (std::size_t reader = 0; reader < kNumReaders; ++reader) {
+    readers.emplace_back([&, reader] {
+      std::size_t pos = reader;
+      std::size_t last_version = 0;
+
+      while (!done.load(std::memory_order_relaxed)) {
+        const auto guard = snapshots.read(reader);
+
+        // A reader never observes an older snapshot than before.
+        EXPECT_GE(guard->version, last_version);
+        last_version = guard->version;
+
+        for (std::size_t i = 0; i < 64; ++i) {
+          pos = (pos + 7919) % kLength;
+          check_snapshot(*guard, pos);
+        }
+      }
+    });
+  }
+
+  for (std::size_t version = 1; version < kNumVersions; ++version) {
+    snapshots.rebuild([](const Snapshot& current) {
+      return create_bitvec(current.version + 1);
+    });
+  }
+  snapshots.wait();
+  EXPECT_EQ(snapshots.version(), kNumVersions - 1);
+
+  done = true;
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+}
+
+}  // namespace
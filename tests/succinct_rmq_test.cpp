@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <bitsy/succinct_rmq.hpp>
+
+namespace {
+using namespace bitsy;
+
+constexpr auto kLengths = {1, 2, 63, 64, 65, 1000, 300000};
+
+std::size_t naive_rmq(const std::vector<std::uint64_t>& values,
+                      const std::size_t first,
+                      const std::size_t last) {
+  return std::min_element(values.begin() + first, values.begin() + last + 1) -
+         values.begin();
+}
+
+void test_rmq(const std::vector<std::uint64_t>& values) {
+  const SuccinctRmq rmq{std::span<const std::uint64_t>(values)};
+  ASSERT_EQ(rmq.length(), values.size());
+
+  const std::size_t length = values.size();
+  if (length <= 100) {
+    for (std::size_t first = 0; first < length; ++first) {
+      for (std::size_t last = first; last < length; ++last) {
+        EXPECT_EQ(rmq.rmq(first, last), naive_rmq(values, first, last));
+      }
+    }
+
+    return;
+  }
+
+  std::mt19937_64 gen(length);
+  std::uniform_int_distribution<std::size_t> pos_dist(0, length - 1);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    std::size_t first = pos_dist(gen);
+    std::size_t last = pos_dist(gen);
+    if (first > last) {
+      std::swap(first, last);
+    }
+
+    EXPECT_EQ(rmq.rmq(first, last), naive_rmq(values, first, last));
+  }
+
+  EXPECT_EQ(rmq.rmq(0, length - 1), naive_rmq(values, 0, length - 1));
+}
+
+TEST(SuccinctRmqTest, Random) {
+  for (const std::size_t length : kLengths) {
+    for (const std::uint64_t max_value : {3, 1000000}) {
+      std::mt19937_64 gen(length);
+      std::uniform_int_distribution<std::uint64_t> value_dist(0, max_value);
+
+      // A small range of values results in many ties.
+      std::vector<std::uint64_t> values(length);
+      for (std::uint64_t& value : values) {
+        value = value_dist(gen);
+      }
+
+      test_rmq(values);
+    }
+  }
+}
+
+TEST(SuccinctRmqTest, Monotone) {
+  for (const std::size_t length : kLengths) {
+    std::vector<std::uint64_t> values(length);
+    for (std::size_t i = 0; i < length; ++i) {
+      values[i] = i;
+    }
+    test_rmq(values);
+
+    std::reverse(values.begin(), values.end());
+    test_rmq(values);
+
+    std::fill(values.begin(), values.end(), 0);
+    test_rmq(values);
+  }
+}
+
+TEST(SuccinctRmqTest, Zigzag) {
+  for (const std::size_t length : kLengths) {
+    std::vector<std::uint64_t> values(length);
+    for (std::size_t i = 0; i < length; ++i) {
+      values[i] = (i % 2 == 0) ? length - i : length + i;
+    }
+
+    test_rmq(values);
+  }
+}
+
+}  // namespace
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <bitsy/rank/symbol_rank_vector.hpp>
+#include <bitsy/util/math.hpp>
+
+namespace {
+using namespace bitsy;
+
+constexpr auto kLengths = {0,   1,   31,    32,    33,    223,
+                           224, 225, 57343, 57344, 57345, math::pow2(20) + 7};
+
+template <typename SymbolVector>
+void test_symbol_rank(const std::vector<std::uint8_t>& symbols,
+                      const std::uint32_t period) {
+  constexpr std::size_t kNumSymbols = SymbolVector::kNumSymbols;
+
+  SymbolVector vector(symbols.size());
+  for (std::size_t pos = 0; pos < symbols.size(); ++pos) {
+    vector.set(pos, symbols[pos]);
+  }
+  vector.update();
+
+  std::array<std::size_t, kNumSymbols> counts{};
+  for (std::size_t pos = 0; pos <= symbols.size(); ++pos) {
+    // Only query all symbols at a subset of the positions of long vectors.
+    if (pos % period == 0) {
+      const auto ranks = vector.rank_all(pos);
+      for (std::size_t c = 0; c < kNumSymbols; ++c) {
+        EXPECT_EQ(counts[c], ranks[c]);
+        EXPECT_EQ(counts[c], vector.rank(static_cast<std::uint8_t>(c), pos));
+      }
+    }
+
+    if (pos < symbols.size()) {
+      const std::uint8_t symbol = symbols[pos];
+      EXPECT_EQ(symbol, vector.get(pos));
+      EXPECT_EQ(counts[symbol], vector.rank(symbol, pos));
+      counts[symbol] += 1;
+    }
+  }
+
+  for (std::size_t c = 0; c < kNumSymbols; ++c) {
+    EXPECT_EQ(counts[c], vector.count(static_cast<std::uint8_t>(c)));
+  }
+}
+
+template <typename SymbolVector>
+void test_symbol_rank_uniform() {
+  for (const std::size_t length : kLengths) {
+    for (std::size_t c = 0; c < SymbolVector::kNumSymbols; ++c) {
+      const std::vector<std::uint8_t> symbols(length,
+                                              static_cast<std::uint8_t>(c));
+      test_symbol_rank<SymbolVector>(symbols, 97);
+    }
+  }
+}
+
+template <typename SymbolVector>
+void test_symbol_rank_random() {
+  for (const std::size_t length : kLengths) {
+    std::mt19937 gen(length);
+    std::uniform_int_distribution<std::uint32_t> dist(
+        0, SymbolVector::kNumSymbols - 1);
+
+    std::vector<std::uint8_t> symbols(length);
+    for (std::uint8_t& symbol : symbols) {
+      symbol = static_cast<std::uint8_t>(dist(gen));
+    }
+
+    test_symbol_rank<SymbolVector>(symbols, 1);
+  }
+}
+
+TEST(SymbolRankVectorTest, Uniform) {
+  test_symbol_rank_uniform<SymbolRankVector<2>>();
+  test_symbol_rank_uniform<SymbolRankVector<4>>();
+}
+
+TEST(SymbolRankVectorTest, Random) {
+  test_symbol_rank_random<SymbolRankVector<2>>();
+  test_symbol_rank_random<SymbolRankVector<4>>();
+  test_symbol_rank_random<SymbolRankVector<2, 1024>>();
+}
+
+}  // namespace